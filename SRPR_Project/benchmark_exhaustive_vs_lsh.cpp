@@ -34,17 +34,6 @@ double cosine_similarity(const Vector& v1, const Vector& v2) {
     return dot_product / (norm1 * norm2);
 }
 
-// Función para calcular distancia Hamming
-int hamming_distance(const std::string& code1, const std::string& code2) {
-    if (code1.length() != code2.length()) return -1;
-    
-    int distance = 0;
-    for (size_t i = 0; i < code1.length(); ++i) {
-        if (code1[i] != code2[i]) distance++;
-    }
-    return distance;
-}
-
 // BÚSQUEDA EXHAUSTIVA - O(n×d)
 std::vector<RecommendationResult> exhaustive_search(
     int user_id, 
@@ -108,16 +97,17 @@ std::vector<RecommendationResult> lsh_search(
     
     try {
         const Vector& user_vector = store.get_user_vector(user_id);
-        std::string user_code = hasher.generate_code(user_vector);
+        PackedCode user_code = hasher.generate_packed_code(user_vector);
+        PackedCode item_code(hasher.get_num_hashes());
         
         const auto& all_items = store.get_all_item_vectors();
         
-        // Calcular distancia Hamming con TODOS los items
+        // Calcular distancia Hamming con TODOS los items (XOR + POPCNT)
         std::vector<std::pair<int, int>> item_distances;
         for (const auto& item_pair : all_items) {
             int item_id = item_pair.first;
             const Vector& item_vector = item_pair.second;
-            std::string item_code = hasher.generate_code(item_vector);
+            hasher.generate_packed_code(item_vector, item_code.words.data());
             int distance = hamming_distance(user_code, item_code);
             item_distances.emplace_back(item_id, distance);
         }
@@ -0,0 +1,44 @@
+#ifndef BFLOAT16_H
+#define BFLOAT16_H
+
+#include <cstdint>
+#include <cstring>
+
+// bfloat16: los 16 bits altos de un float IEEE (1 signo, 8 exponente, 7 mantisa). Mismo
+// rango que float con ~3 cifras significativas; sólo para almacenamiento: los kernels lo
+// expanden a float (desplazar 16 bits) y acumulan en float.
+struct bfloat16 {
+    uint16_t bits;
+
+    // Redondeo al más cercano (empates a par); NaN sigue siendo NaN
+    static bfloat16 from_float(float value) {
+        uint32_t u;
+        std::memcpy(&u, &value, sizeof(u));
+        bfloat16 result;
+        if ((u & 0x7F800000u) == 0x7F800000u && (u & 0x007FFFFFu) != 0) {
+            result.bits = static_cast<uint16_t>((u >> 16) | 0x0040u);
+        } else {
+            u += 0x7FFFu + ((u >> 16) & 1u);
+            result.bits = static_cast<uint16_t>(u >> 16);
+        }
+        return result;
+    }
+
+    float to_float() const {
+        uint32_t u = static_cast<uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &u, sizeof(value));
+        return value;
+    }
+};
+
+// Conversiones usadas por los kernels plantilla (almacenamiento -> acumulador y viceversa)
+inline double to_accumulator(double x) { return x; }
+inline float to_accumulator(float x) { return x; }
+inline float to_accumulator(bfloat16 x) { return x.to_float(); }
+inline float to_accumulator(int8_t x) { return static_cast<float>(x); }
+
+template <typename T> inline T from_double(double x) { return static_cast<T>(x); }
+template <> inline bfloat16 from_double<bfloat16>(double x) { return bfloat16::from_float(static_cast<float>(x)); }
+
+#endif // BFLOAT16_H
@@ -0,0 +1,66 @@
+#ifndef BIT_SLICED_CODE_STORE_H
+#define BIT_SLICED_CODE_STORE_H
+
+#include "LSHIndex.h"
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Almacén de códigos traspuesto por bits (bit-sliced) para escaneos lineales del catálogo.
+// Los ítems se agrupan en bloques de BLOCK_ITEMS = 256 filas consecutivas del LSHIndex; para
+// cada bit j del código, el bloque guarda un plano de 256 bits (4 palabras, un registro AVX2)
+// con el bit j de sus 256 ítems. Una consulta procesa el bloque plano a plano: XOR con el bit
+// de la consulta y suma vertical en contadores bit-sliced, obteniendo las 256 distancias a la
+// vez. Cada PRUNE_INTERVAL bits se compara la distancia parcial (cota inferior) con el k-ésimo
+// mejor actual y se descarta el resto del bloque si ningún ítem puede entrar en el top-k; de
+// los bloques completos sólo se leen las distancias de los ítems que pueden entrar.
+class BitSlicedCodeStore {
+public:
+    static const int BLOCK_ITEMS = 256;
+    static const int LANES = BLOCK_ITEMS / 64;  // Palabras por plano
+    static const int PRUNE_INTERVAL = 16;       // Planos por grupo de suma / comprobación de poda
+
+    // 'index' debe vivir más que este objeto; llamar build() tras construir el índice
+    explicit BitSlicedCodeStore(const LSHIndex& index);
+
+    // true si la suma vertical tiene versión SIMD en esta CPU (AVX2 o superior, ver
+    // SimdKernels): sin ella el escaneo empaquetado con POPCNT es más rápido
+    static bool is_accelerated();
+
+    // Traspone los códigos actuales del índice
+    void build();
+
+    // Vuelve a trasponer sólo 'rows' (tras LSHIndex::refresh)
+    void update_rows(const std::vector<int>& rows);
+
+    // Top-k por distancia Hamming: mismos resultados y orden (distancia, fila) que
+    // LSHIndex::search. 'blocks_pruned' (opcional) recibe cuántos bloques se cortaron antes de
+    // procesar todos sus bits.
+    std::vector<std::pair<int, int>> search(const PackedCode& query_code, int top_k,
+                                            int* blocks_pruned = nullptr) const;
+
+    // Distancias completas de los ítems del bloque 'block' (BLOCK_ITEMS posiciones; las filas
+    // de relleno del último bloque quedan sin definir)
+    void compute_block_distances(const PackedCode& query_code, int block, int* out) const;
+
+    int size() const { return index.size(); }
+    int get_num_blocks() const { return num_blocks; }
+    const LSHIndex& get_index() const { return index; }
+
+    // Memoria de los planos (bytes)
+    size_t memory_bytes() const { return planes.size() * sizeof(uint64_t); }
+
+private:
+    const uint64_t* block_planes(int block) const {
+        return planes.data() + static_cast<size_t>(block) * bits * LANES;
+    }
+
+    const LSHIndex& index;
+    int bits;          // Bits por código
+    int counter_bits;  // Bits de los contadores verticales (suficientes para 0..bits)
+    int num_blocks;
+    // num_blocks × bits × LANES: plano j del bloque b en [(b·bits + j)·LANES, ... + LANES)
+    std::vector<uint64_t> planes;
+};
+
+#endif // BIT_SLICED_CODE_STORE_H
@@ -0,0 +1,63 @@
+#ifndef CODE_DIAGNOSTICS_H
+#define CODE_DIAGNOSTICS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Diagnóstico de la distribución de un conjunto de códigos empaquetados (p. ej. los del
+// catálogo en un LSHIndex), para ajustar b y el número de tablas sin correr benchmarks
+// de recuperación completos:
+//   - balance por bit: fracción de unos (0.5 = el bit parte el conjunto por la mitad)
+//   - correlación de Pearson (phi) entre pares de bits: bits redundantes dan |phi| ~ 1
+//   - ocupación de buckets de prefijos de k bits: tamaños, candidatos esperados y entropía
+//   - entropía empírica de los códigos completos (máximo min(b, log2 n) bits)
+// Las co-ocurrencias se cuentan sobre planos de bits traspuestos: popcount(i & j) sale de
+// |i| + |j| - H(i, j) con el escaneo Hamming de SimdKernels, O(b² n / 64) palabras.
+struct CodeDiagnostics {
+    // Ocupación de los buckets definidos por los primeros 'bits' bits del código
+    struct PrefixOccupancy {
+        int bits = 0;
+        long long occupied_buckets = 0;      // Buckets con al menos un código
+        long long max_bucket_size = 0;
+        double expected_candidates = 0.0;    // Tamaño medio del bucket de un código: sum(s²)/n
+        double entropy = 0.0;                // Entropía (bits) de la distribución de buckets
+        // size_histogram[j] = buckets con tamaño en [2^j, 2^(j+1))
+        std::vector<long long> size_histogram;
+    };
+
+    int num_codes = 0;
+    int num_bits = 0;
+
+    std::vector<double> bit_balance;          // Fracción de unos de cada bit
+    double max_bit_imbalance = 0.0;           // max |balance - 0.5|
+    double mean_bit_imbalance = 0.0;
+
+    // Matriz b×b por filas de correlaciones phi (diagonal 1; bits constantes -> 0)
+    std::vector<double> bit_correlation;
+    double mean_abs_correlation = 0.0;        // Promedio de |phi| fuera de la diagonal
+    double max_abs_correlation = 0.0;
+    int max_correlation_pair[2] = {-1, -1};
+
+    std::vector<PrefixOccupancy> prefixes;
+
+    long long unique_codes = 0;
+    double code_entropy = 0.0;                // Entropía (bits) de los códigos completos
+
+    // Analiza 'n' códigos contiguos de code_words_for_bits(num_bits) palabras. Los prefijos
+    // fuera de (0, min(num_bits, 64)] se descartan. Lanza std::invalid_argument si num_bits <= 0.
+    static CodeDiagnostics analyze(const uint64_t* codes, int n, int num_bits,
+                                   const std::vector<int>& prefix_bits);
+
+    // Fracción de códigos distintos (la antigua "diversidad")
+    double diversity() const { return num_codes > 0 ? static_cast<double>(unique_codes) / num_codes : 0.0; }
+
+    // Objeto JSON con todas las métricas. Con include_matrix = false se omite la matriz de
+    // correlaciones (b² valores) y sólo quedan sus resúmenes.
+    std::string to_json(bool include_matrix = true) const;
+
+    // Resumen legible en consola
+    void print_summary() const;
+};
+
+#endif // CODE_DIAGNOSTICS_H
@@ -0,0 +1,85 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SRPR_X86_DISPATCH 1
+#include <cpuid.h>
+#endif
+
+// Extensiones de la CPU relevantes para los kernels SIMD, leídas con CPUID una sola vez.
+// Las extensiones AVX sólo cuentan si el sistema operativo guarda sus registros (XGETBV),
+// así un binario compilado con -O2 genérico puede elegir en ejecución el mejor kernel.
+struct CpuFeatures {
+    bool popcnt = false;
+    bool sse42 = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+    bool avx512_vpopcntdq = false;
+    bool avx512bw = false;
+    bool avx512_vnni = false;
+    bool avx512vl = false;
+
+    // Características de la CPU actual (detectadas en la primera llamada)
+    static const CpuFeatures& get() {
+        static const CpuFeatures features = detect();
+        return features;
+    }
+
+    // Lista legible, p. ej. "popcnt sse4.2 avx2 fma avx512f"
+    std::string describe() const {
+        std::string s;
+        if (popcnt) s += "popcnt ";
+        if (sse42) s += "sse4.2 ";
+        if (avx2) s += "avx2 ";
+        if (fma) s += "fma ";
+        if (avx512f) s += "avx512f ";
+        if (avx512_vpopcntdq) s += "avx512vpopcntdq ";
+        if (avx512bw) s += "avx512bw ";
+        if (avx512_vnni) s += "avx512vnni ";
+        if (avx512vl) s += "avx512vl ";
+        if (s.empty()) return "ninguna";
+        s.pop_back();
+        return s;
+    }
+
+private:
+    static CpuFeatures detect() {
+        CpuFeatures f;
+#ifdef SRPR_X86_DISPATCH
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return f;
+        f.sse42 = (ecx >> 20) & 1;
+        f.popcnt = (ecx >> 23) & 1;
+        const bool osxsave = (ecx >> 27) & 1;
+        const bool avx = (ecx >> 28) & 1;
+        const bool fma = (ecx >> 12) & 1;
+
+        // Estado de registros habilitado por el SO: XMM/YMM (bits 1-2), opmask/ZMM (bits 5-7)
+        unsigned long long xcr0 = 0;
+        if (osxsave) {
+            unsigned int xcr0_low = 0, xcr0_high = 0;
+            __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+            xcr0 = (static_cast<unsigned long long>(xcr0_high) << 32) | xcr0_low;
+        }
+        const bool ymm_state = (xcr0 & 0x6) == 0x6;
+        const bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+
+        if (__get_cpuid_max(0, nullptr) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            f.avx2 = avx && ymm_state && ((ebx >> 5) & 1);
+            f.fma = avx && ymm_state && fma;
+            f.avx512f = zmm_state && ((ebx >> 16) & 1);
+            f.avx512_vpopcntdq = f.avx512f && ((ecx >> 14) & 1);
+            f.avx512bw = f.avx512f && ((ebx >> 30) & 1);
+            f.avx512_vnni = f.avx512f && ((ecx >> 11) & 1);
+            f.avx512vl = f.avx512f && ((ebx >> 31) & 1);
+        }
+#endif
+        return f;
+    }
+};
+
+#endif // CPU_FEATURES_H
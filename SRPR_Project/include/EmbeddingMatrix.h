@@ -0,0 +1,182 @@
+#ifndef EMBEDDING_MATRIX_H
+#define EMBEDDING_MATRIX_H
+
+#include "AlignedAllocator.h"
+#include "BFloat16.h"
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+// Precisión de almacenamiento de los embeddings para servir (hashing y escaneos):
+//   Double   - 8 bytes por coordenada (la del entrenamiento)
+//   Float    - 4 bytes, acumulación en float (el doble de carriles SIMD)
+//   BFloat16 - 2 bytes, expandido a float al cargar y acumulado en float
+//   Int8     - 1 byte + una escala por fila (Int8Matrix), producto exacto en enteros
+enum class Precision {
+    Double,
+    Float,
+    BFloat16,
+    Int8
+};
+
+inline const char* precision_name(Precision precision) {
+    switch (precision) {
+        case Precision::Double:   return "double";
+        case Precision::Float:    return "float";
+        case Precision::BFloat16: return "bf16";
+        case Precision::Int8:     return "int8";
+    }
+    return "double";
+}
+
+// Acepta "double", "float", "bf16" (o "bfloat16") e "int8"; devuelve false si no la reconoce
+inline bool parse_precision(const std::string& name, Precision& out) {
+    if (name == "double") { out = Precision::Double; return true; }
+    if (name == "float") { out = Precision::Float; return true; }
+    if (name == "bf16" || name == "bfloat16") { out = Precision::BFloat16; return true; }
+    if (name == "int8") { out = Precision::Int8; return true; }
+    return false;
+}
+
+inline size_t precision_bytes(Precision precision) {
+    switch (precision) {
+        case Precision::Double:   return 8;
+        case Precision::Float:    return 4;
+        case Precision::BFloat16: return 2;
+        case Precision::Int8:     return 1;
+    }
+    return 8;
+}
+
+// Matriz contigua por filas de escalares T (double, float o bfloat16) alineada a 64 bytes,
+// con cada fila rellenada con ceros hasta un múltiplo de 64 bytes: cada fila empieza en una
+// línea de caché y los kernels pueden leer bloques completos. Se llena desde doubles (el
+// store de entrenamiento) con redondeo al más cercano.
+template <typename T>
+class EmbeddingMatrix {
+public:
+    EmbeddingMatrix() : num_rows(0), num_cols(0), row_stride(0) {}
+
+    EmbeddingMatrix(int rows, int cols)
+        : num_rows(rows > 0 ? rows : 0), num_cols(cols > 0 ? cols : 0),
+          row_stride(static_cast<int>((num_cols * sizeof(T) + 63) / 64 * 64 / sizeof(T))),
+          storage(static_cast<size_t>(num_rows) * row_stride, from_double<T>(0.0)) {}
+
+    // Copia 'rows' filas de 'cols' doubles separadas por 'stride' (p. ej. item_matrix())
+    static EmbeddingMatrix from_doubles(const double* data, int rows, int cols, int stride) {
+        EmbeddingMatrix matrix(rows, cols);
+        for (int r = 0; r < matrix.num_rows; ++r) {
+            matrix.set_row(r, data + static_cast<size_t>(r) * stride);
+        }
+        return matrix;
+    }
+
+    // Escribe la fila 'r' desde 'cols' doubles, multiplicados por 'scale' (p. ej. 1/norma)
+    void set_row(int r, const double* values, double scale = 1.0) {
+        T* out = row(r);
+        for (int k = 0; k < num_cols; ++k) {
+            out[k] = from_double<T>(values[k] * scale);
+        }
+    }
+
+    // Fila 'r' de vuelta a doubles ('cols' posiciones)
+    void get_row(int r, double* out) const {
+        const T* in = row(r);
+        for (int k = 0; k < num_cols; ++k) {
+            out[k] = static_cast<double>(to_accumulator(in[k]));
+        }
+    }
+
+    T* row(int r) { return storage.data() + static_cast<size_t>(r) * row_stride; }
+    const T* row(int r) const { return storage.data() + static_cast<size_t>(r) * row_stride; }
+    const T* data() const { return storage.data(); }
+
+    int rows() const { return num_rows; }
+    int cols() const { return num_cols; }
+    int stride() const { return row_stride; }
+    bool empty() const { return num_rows == 0; }
+    size_t memory_bytes() const { return storage.size() * sizeof(T); }
+
+private:
+    int num_rows;
+    int num_cols;
+    int row_stride;  // Escalares por fila (cols redondeado a 64 bytes)
+    std::vector<T, AlignedAllocator<T> > storage;
+};
+
+// Matriz int8 con una escala por fila (cuantización simétrica): fila ≈ escala · q con q en
+// [-127, 127] y escala = max|x| / 127, así cada fila usa todo el rango aunque las normas
+// varíen. Filas rellenadas con ceros hasta un múltiplo de 32 bytes (no 64 como
+// EmbeddingMatrix: con 32 dimensiones eso duplicaría el catálogo) y alineadas a 32 bytes.
+// Nunca se usa -128: los kernels int8 de SimdKernels lo requieren.
+class Int8Matrix {
+public:
+    Int8Matrix() : num_rows(0), num_cols(0), row_stride(0) {}
+
+    Int8Matrix(int rows, int cols)
+        : num_rows(rows > 0 ? rows : 0), num_cols(cols > 0 ? cols : 0),
+          row_stride((num_cols + 31) / 32 * 32),
+          storage(static_cast<size_t>(num_rows) * row_stride, 0), scales(num_rows, 0.0f) {}
+
+    static Int8Matrix from_doubles(const double* data, int rows, int cols, int stride) {
+        Int8Matrix matrix(rows, cols);
+        for (int r = 0; r < matrix.num_rows; ++r) {
+            matrix.set_row(r, data + static_cast<size_t>(r) * stride);
+        }
+        return matrix;
+    }
+
+    // Cuantiza 'n' doubles multiplicados por 'scale' en 'out' y devuelve la escala del
+    // resultado (out[k] · escala ≈ values[k] · scale); un vector nulo da escala 0
+    static float quantize(const double* values, int n, double scale, int8_t* out) {
+        double max_abs = 0.0;
+        for (int k = 0; k < n; ++k) {
+            max_abs = std::max(max_abs, std::fabs(values[k] * scale));
+        }
+        if (max_abs == 0.0) {
+            std::fill(out, out + n, static_cast<int8_t>(0));
+            return 0.0f;
+        }
+        const double step = max_abs / 127.0;
+        for (int k = 0; k < n; ++k) {
+            long q = std::lround(values[k] * scale / step);
+            out[k] = static_cast<int8_t>(std::max(-127L, std::min(127L, q)));
+        }
+        return static_cast<float>(step);
+    }
+
+    void set_row(int r, const double* values, double scale = 1.0) {
+        scales[r] = quantize(values, num_cols, scale, row(r));
+    }
+
+    // Fila 'r' reconstruida (escala · q)
+    void get_row(int r, double* out) const {
+        const int8_t* in = row(r);
+        for (int k = 0; k < num_cols; ++k) {
+            out[k] = static_cast<double>(in[k]) * scales[r];
+        }
+    }
+
+    int8_t* row(int r) { return storage.data() + static_cast<size_t>(r) * row_stride; }
+    const int8_t* row(int r) const { return storage.data() + static_cast<size_t>(r) * row_stride; }
+    const int8_t* data() const { return storage.data(); }
+    float scale(int r) const { return scales[r]; }
+
+    int rows() const { return num_rows; }
+    int cols() const { return num_cols; }
+    int stride() const { return row_stride; }
+    bool empty() const { return num_rows == 0; }
+    size_t memory_bytes() const { return storage.size() + scales.size() * sizeof(float); }
+
+private:
+    int num_rows;
+    int num_cols;
+    int row_stride;  // Bytes por fila (cols redondeado a 32)
+    std::vector<int8_t, AlignedAllocator<int8_t> > storage;
+    std::vector<float> scales;
+};
+
+#endif // EMBEDDING_MATRIX_H
@@ -3,6 +3,12 @@
 
 #include "UserItemStore.h"
 #include "LSH.h"
+#include "LSHIndex.h"
+#include "LSHBucketIndex.h"
+#include "MultiIndexHashing.h"
+#include "BitSlicedCodeStore.h"
+#include "TopK.h"
+#include "EmbeddingMatrix.h"
 #include "Triplet.h"
 #include <vector>
 #include <chrono>
@@ -11,6 +17,7 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 
 // Estructura para almacenar resultados de recomendación
 struct RecommendationResult {
@@ -46,10 +53,29 @@ struct EvaluationMetrics {
     }
 };
 
+// Similitud exacta con la que se re-ordenan los candidatos Hamming
+enum class RerankMetric {
+    Cosine,      // Coseno (mismo criterio que exhaustive_search)
+    DotProduct   // Producto interno (mismo criterio que exhaustive_mips_search)
+};
+
+// Un punto de la curva latencia/recall del pipeline de dos etapas
+struct RerankPoint {
+    int num_candidates;          // C: candidatos Hamming re-evaluados
+    EvaluationMetrics metrics;   // Métricas del top-k exacto entre los C candidatos
+};
+
 // Estructura para comparativa de rendimiento
 struct PerformanceComparison {
     EvaluationMetrics exhaustive_metrics;
     EvaluationMetrics lsh_metrics;
+    EvaluationMetrics bucket_metrics;   // Sólo si hay índice por tablas hash
+    bool has_bucket_metrics = false;
+    double avg_bucket_candidates = 0.0; // Candidatos re-evaluados por consulta
+    EvaluationMetrics mih_metrics;      // Sólo si hay índice multi-index hashing
+    bool has_mih_metrics = false;
+    double avg_mih_candidates = 0.0;    // Ítems verificados por consulta
+    std::vector<RerankPoint> rerank_curve;  // Una entrada por C de config.candidate_sizes
     double speedup_factor = 0.0;
     double accuracy_loss = 0.0;
     double efficiency_gain = 0.0;
@@ -61,6 +87,28 @@ struct PerformanceComparison {
         
         exhaustive_metrics.print("EXHAUSTIVO");
         lsh_metrics.print("LSH");
+        if (has_bucket_metrics) {
+            bucket_metrics.print("LSH TABLAS HASH");
+            std::cout << "  Avg Candidatos:     " << avg_bucket_candidates << std::endl;
+        }
+        if (has_mih_metrics) {
+            mih_metrics.print("LSH MULTI-INDEX HASHING");
+            std::cout << "  Avg Candidatos:     " << avg_mih_candidates << std::endl;
+        }
+        if (!rerank_curve.empty()) {
+            std::cout << "\n=== DOS ETAPAS: TOP-C HAMMING + RE-RANKING EXACTO ===" << std::endl;
+            std::cout << "       C | Precision@K | Recall@K | NDCG@K | Time (ms)" << std::endl;
+            std::cout << std::string(54, '-') << std::endl;
+            for (const RerankPoint& point : rerank_curve) {
+                std::cout << std::setw(8) << point.num_candidates
+                          << " | " << std::setw(11) << std::fixed << std::setprecision(4) << point.metrics.precision_at_k
+                          << " | " << std::setw(8) << point.metrics.recall_at_k
+                          << " | " << std::setw(6) << point.metrics.ndcg_at_k
+                          << " | " << std::setw(9) << point.metrics.avg_retrieval_time_ms
+                          << std::endl;
+            }
+            std::cout << "  (exhaustivo: " << exhaustive_metrics.avg_retrieval_time_ms << " ms)" << std::endl;
+        }
         
         std::cout << "\n=== COMPARACIÓN DIRECTA ===" << std::endl;
         std::cout << std::fixed << std::setprecision(2);
@@ -79,7 +127,8 @@ struct PerformanceComparison {
 
 class ExhaustiveBenchmark {
 public:
-    ExhaustiveBenchmark(UserItemStore& store, SRPHasher& hasher);
+    // 'hasher' puede ser cualquier familia LSH (SRP denso, disperso, Hadamard...)
+    ExhaustiveBenchmark(UserItemStore& store, LSH& hasher);
     
     // === MÉTODOS DE BÚSQUEDA ===
     
@@ -90,13 +139,116 @@ public:
         std::chrono::microseconds& retrieval_time
     ) const;
     
-    // Búsqueda LSH O(b) - usa códigos binarios y Hamming distance
+    // Búsqueda exhaustiva repartida en 'num_threads' hilos (0 = hardware_concurrency).
+    // Cada hilo mantiene su propio top-k acotado; el resultado es idéntico al secuencial.
+    std::vector<RecommendationResult> exhaustive_search_parallel(
+        int user_id,
+        int top_k,
+        std::chrono::microseconds& retrieval_time,
+        int num_threads = 0
+    ) const;
+    
+    // Búsqueda exhaustiva por producto interno (MIPS): mismo recorrido que exhaustive_search
+    // pero con score = u·v, el criterio con que se entrena y evalúa el ranking SRPR
+    std::vector<RecommendationResult> exhaustive_mips_search(
+        int user_id,
+        int top_k,
+        std::chrono::microseconds& retrieval_time
+    ) const;
+    
+    // Búsqueda LSH - hashea sólo al usuario y compara contra el índice de códigos
+    // precalculado del catálogo (O(n) popcounts por consulta). Si se construyó el almacén
+    // bit-sliced (build_bit_sliced_index) y la CPU tiene sus kernels SIMD, el escaneo se hace
+    // sobre él, con idéntico ranking.
+    // Con build_prefix_cascade el catálogo se filtra primero por prefijos cortos.
     std::vector<RecommendationResult> lsh_search(
         int user_id, 
         int top_k,
         std::chrono::microseconds& retrieval_time
     ) const;
     
+    // Búsqueda por tablas hash (L × k bits): candidatos por coincidencia exacta de bucket
+    // y re-evaluación exacta (coseno) sólo de la unión de candidatos.
+    // Requiere build_bucket_index(); 'num_candidates' (opcional) recibe el tamaño de la unión.
+    std::vector<RecommendationResult> bucket_search(
+        int user_id,
+        int top_k,
+        std::chrono::microseconds& retrieval_time,
+        int* num_candidates = nullptr
+    ) const;
+    
+    // Igual, pero con multi-probe: 'num_probes' buckets por tabla visitados en el orden de
+    // 'strategy'. La versión anterior usa config.bucket_probes y config.bucket_probe_strategy.
+    std::vector<RecommendationResult> bucket_search(
+        int user_id,
+        int top_k,
+        int num_probes,
+        ProbeStrategy strategy,
+        std::chrono::microseconds& retrieval_time,
+        int* num_candidates = nullptr
+    ) const;
+    
+    // k-NN Hamming exacto con multi-index hashing: mismo ranking que lsh_search, pero sólo
+    // verifica los ítems de las subcadenas sondeadas. Requiere build_mih_index();
+    // 'num_candidates' (opcional) recibe cuántos ítems se verificaron.
+    std::vector<RecommendationResult> mih_search(
+        int user_id,
+        int top_k,
+        std::chrono::microseconds& retrieval_time,
+        int* num_candidates = nullptr
+    ) const;
+    
+    // Pipeline de dos etapas: los 'num_candidates' (C) mejores ítems por distancia Hamming
+    // (misma etapa que lsh_search) se re-evalúan con la similitud exacta 'metric' y se
+    // devuelve el top-k exacto entre ellos. C >= tamaño del catálogo equivale a la búsqueda
+    // exhaustiva; los scores son la similitud exacta y se conserva la distancia Hamming.
+    std::vector<RecommendationResult> rerank_search(
+        int user_id,
+        int top_k,
+        int num_candidates,
+        std::chrono::microseconds& retrieval_time,
+        RerankMetric metric = RerankMetric::Cosine
+    ) const;
+    
+    // Re-hashea el catálogo (llamar si los vectores de ítems cambiaron tras construir el benchmark)
+    void rebuild_index();
+    
+    // Sincroniza los índices sólo con los ítems marcados en store.get_dirty_items() (p. ej. tras
+    // épocas de SRPR_Trainer) y limpia la lista: tiempo proporcional a los ítems modificados.
+    // Devuelve cuántos ítems se rehashearon.
+    int refresh_index();
+    const LSHIndex& get_index() const { return item_index; }
+    
+    // Precisión del escaneo exhaustivo por coseno. Con Float o BFloat16, exhaustive_search y
+    // exhaustive_search_parallel recorren una copia normalizada del catálogo en esa precisión
+    // (EmbeddingMatrix, acumulación en float): la mitad o la cuarta parte de memoria por ítem.
+    // Con Int8 recorren una copia int8 con escala por fila (Int8Matrix, un octavo de la
+    // memoria) con productos enteros, y los 'rerank_factor'·K mejores candidatos se
+    // re-evalúan con el coseno exacto: los scores devueltos son exactos.
+    // rebuild_index / refresh_index la mantienen al día. Double (por defecto) usa el store.
+    void set_scan_precision(Precision precision, int rerank_factor = 4);
+    Precision get_scan_precision() const { return scan_precision; }
+    size_t scan_memory_bytes() const;
+    
+    // Construye el índice por tablas hash usado por bucket_search y benchmark_methods
+    void build_bucket_index(int num_tables, int bits_per_table, unsigned int seed = 42);
+    bool has_bucket_index() const { return bucket_index != nullptr; }
+    
+    // Construye el índice multi-index hashing sobre los códigos de item_index
+    // (num_substrings <= 0 usa B / log2(n))
+    void build_mih_index(int num_substrings = 0);
+    bool has_mih_index() const { return mih_index != nullptr; }
+    
+    // Construye la copia traspuesta por bits de los códigos que usa lsh_search
+    void build_bit_sliced_index();
+    bool has_bit_sliced_index() const { return sliced_index != nullptr; }
+    
+    // Activa la cascada de prefijos en la etapa Hamming de lsh_search y rerank_search:
+    // 'prefix_bits' (p. ej. {16, 64}) son los filtros gruesos y 'survivors' las filas que
+    // conserva cada uno. Vacío = escaneo completo del código.
+    void build_prefix_cascade(const std::vector<int>& prefix_bits, const std::vector<int>& survivors);
+    bool has_prefix_cascade() const { return item_index.has_prefix_cascade(); }
+    
     // === MÉTODOS DE EVALUACIÓN ===
     
     // Evalúa un conjunto de usuarios con ambos métodos
@@ -122,21 +274,42 @@ public:
         int top_k = 10
     ) const;
     
-    // Benchmarks con diferentes configuraciones LSH
+    // Benchmarks con diferentes configuraciones LSH: para cada número de bits construye
+    // hashers SRP denso, Philox (coeficientes regenerados desde la seed), disperso, Hadamard
+    // e ITQ (si b <= d) y reporta throughput de hashing del catálogo, recall@K del ranking
+    // Hamming y tiempo por consulta. Si hay índice por tablas hash y 'probe_budgets' no está
+    // vacío, reporta además recall vs probes por tabla (multi-probe).
     void lsh_configuration_analysis(
         const std::vector<int>& lsh_bits,
         const std::vector<int>& test_users,
-        int top_k = 10
+        int top_k = 10,
+        const std::vector<int>& probe_budgets = std::vector<int>()
+    ) const;
+    
+    // MIPS: compara SRP coseno contra Simple-ALSH (ítems aumentados con la norma, consultas
+    // rellenadas con cero) con la misma cantidad de bits. Ground truth = top-k por producto
+    // interno exhaustivo; reporta recall@K del ranking Hamming, recall@K tras re-ordenar por
+    // producto interno los 'rerank_factor'·K primeros candidatos y tiempo por consulta
+    // recuperando los candidatos con multi-index hashing (sublineal).
+    void mips_analysis(
+        const std::vector<int>& lsh_bits,
+        const std::vector<int>& test_users,
+        int top_k = 10,
+        int rerank_factor = 10
     ) const;
     
     // === UTILIDADES ===
     
     // Calcula similitud coseno entre dos vectores
     double cosine_similarity(const Vector& v1, const Vector& v2) const;
+    double cosine_similarity(const double* v1, const double* v2, int d) const;
     
     // Calcula distancia Hamming entre códigos
     int hamming_distance(const std::string& code1, const std::string& code2) const;
     
+    // Distancia Hamming sobre códigos empaquetados (XOR + POPCNT por palabra)
+    int hamming_distance(const PackedCode& code1, const PackedCode& code2) const;
+    
     // Genera ground truth basado en ratings reales
     std::map<int, std::set<int>> generate_ground_truth(
         const std::vector<Triplet>& validation_triplets
@@ -198,6 +371,16 @@ public:
         bool use_paper_metrics = true;  // Usar métricas exactas del paper
         double similarity_threshold = 0.1;  // Umbral para considerar similitud
         int max_catalog_size = 10000;  // Máximo items para prueba escalabilidad
+        
+        // Multi-probe del índice por tablas hash (1 = sólo el bucket exacto)
+        int bucket_probes = 1;
+        ProbeStrategy bucket_probe_strategy = ProbeStrategy::ProjectionMargin;
+        
+        // Curva del pipeline de dos etapas en benchmark_methods (vacío = no se evalúa):
+        // tamaños C de la etapa Hamming y similitud exacta del re-ranking. Con DotProduct
+        // el ground truth de la curva es el top-k por producto interno.
+        std::vector<int> candidate_sizes;
+        RerankMetric rerank_metric = RerankMetric::Cosine;
     };
     
     void set_config(const BenchmarkConfig& config) { this->config = config; }
@@ -205,11 +388,44 @@ public:
 
 private:
     UserItemStore& store;
-    SRPHasher& hasher;
+    LSH& hasher;
+    LSHIndex item_index;  // Códigos de todos los ítems, calculados una sola vez
+    std::unique_ptr<LSHBucketIndex> bucket_index;  // Opcional: L tablas × k bits
+    std::unique_ptr<MultiIndexHashing> mih_index;  // Opcional: m subcadenas sobre item_index
+    std::unique_ptr<BitSlicedCodeStore> sliced_index;  // Opcional: item_index en bloques bit-sliced
+    std::vector<int> cascade_survivors;  // Presupuesto por etapa de la cascada de prefijos
     BenchmarkConfig config;
     
+    // Catálogo normalizado en la precisión del escaneo (filas = filas del store)
+    Precision scan_precision;
+    EmbeddingMatrix<float> scan_items_f32;
+    EmbeddingMatrix<bfloat16> scan_items_bf16;
+    Int8Matrix scan_items_int8;
+    int scan_rerank_factor;  // Sólo Int8: candidatos por resultado re-evaluados en double
+    
     // === MÉTODOS AUXILIARES PRIVADOS ===
     
+    // Coseno entre un usuario (vector y norma) y la fila 'row' del catálogo con un solo
+    // producto punto: contra la matriz normalizada del store si está construida
+    // (build_normalized_items) o con la norma cacheada del ítem
+    double cosine_to_item_row(const double* user_vector, double user_norm, int row) const;
+    
+    // Coseno con las filas [begin, end) del catálogo en la precisión del escaneo, acumulado
+    // en 'top' (secuencial y paralelo comparten este recorrido)
+    void scan_item_rows(const double* user_vector, double user_norm, int begin, int end, BoundedTopK& top) const;
+    
+    // Rehace la copia del catálogo (fill_scan_copy) o una fila (fill_scan_row)
+    void fill_scan_copy();
+    void fill_scan_row(int row);
+    
+    // Convierte un top-k acotado (ya seleccionado) a resultados ordenados por similitud
+    std::vector<RecommendationResult> top_k_to_results(const BoundedTopK& top) const;
+    
+    // Etapa Hamming compartida por lsh_search y rerank_search: pares <item_id, distancia>
+    // (cascada de prefijos si está activa; si no, almacén bit-sliced si está construido o
+    // el escaneo empaquetado de item_index)
+    std::vector<std::pair<int, int>> hamming_ranking(const Vector& user_vector, int count) const;
+    
     // Convierte ranking LSH a formato estándar
     std::vector<RecommendationResult> convert_lsh_ranking(
         const std::vector<std::pair<int, int>>& lsh_results,
@@ -221,6 +437,12 @@ private:
         const std::vector<std::pair<int, double>>& exhaustive_results
     ) const;
     
+    // Compara top-k exhaustivo vs LSH para un usuario muestra
+    void analyze_similarity_correlation(
+        const std::vector<int>& test_users,
+        int top_k
+    ) const;
+    
     // Calcula estadísticas de distribución de similitudes
     void analyze_similarity_distribution(
         const std::vector<RecommendationResult>& exhaustive_results,
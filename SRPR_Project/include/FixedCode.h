@@ -0,0 +1,80 @@
+#ifndef FIXED_CODE_H
+#define FIXED_CODE_H
+
+#include "PackedCode.h"
+#include <cstdint>
+
+// Kernels Hamming con longitud fija en tiempo de compilación.
+// PackedCode y hamming_distance_words recorren un número de palabras conocido sólo en
+// ejecución; aquí la cantidad de palabras es un parámetro de plantilla, así que el XOR +
+// POPCNT se despliega por completo en código lineal (sin contador de bucle ni saltos).
+// Las configuraciones comunes (16, 32, 64, 128 y 256 bits) se eligen en ejecución con
+// select_hamming_scan; cualquier otra longitud usa el kernel genérico.
+// La disposición en memoria es la de PackedCode: bit i en words[i / 64], posición i % 64.
+
+// Suma desplegada de POPCNT(a[w] ^ b[w]) para w = 0..Words-1
+template <int Words>
+struct HammingUnroll {
+    static inline int distance(const uint64_t* a, const uint64_t* b) {
+        return HammingUnroll<Words - 1>::distance(a, b) + popcount64(a[Words - 1] ^ b[Words - 1]);
+    }
+};
+
+template <>
+struct HammingUnroll<0> {
+    static inline int distance(const uint64_t*, const uint64_t*) { return 0; }
+};
+
+// Escaneo de 'n' códigos contiguos de 'num_words' palabras: distances[r] = H(query, fila r).
+// Firma común para que select_hamming_scan devuelva un puntero a función.
+typedef void (*HammingScanKernel)(const uint64_t* query, const uint64_t* codes, int n, int num_words,
+                                  int* distances);
+
+// Especialización: la consulta se carga una vez y cada fila es código lineal de Words palabras
+template <int Words>
+inline void hamming_scan_fixed(const uint64_t* query, const uint64_t* codes, int n, int /*num_words*/,
+                               int* distances) {
+    uint64_t q[Words];
+    for (int w = 0; w < Words; ++w) q[w] = query[w];
+    for (int row = 0; row < n; ++row, codes += Words) {
+        distances[row] = HammingUnroll<Words>::distance(q, codes);
+    }
+}
+
+// Kernel genérico para longitudes sin especialización
+inline void hamming_scan_generic(const uint64_t* query, const uint64_t* codes, int n, int num_words,
+                                 int* distances) {
+    for (int row = 0; row < n; ++row, codes += num_words) {
+        distances[row] = hamming_distance_words(query, codes, num_words);
+    }
+}
+
+// Distancias sólo de las filas 'rows[0..count)' (acceso disperso, p. ej. supervivientes de
+// un filtro): distances[i] = H(query, fila rows[i])
+typedef void (*HammingGatherKernel)(const uint64_t* query, const uint64_t* codes, int num_words,
+                                    const int* rows, int count, int* distances);
+
+inline void hamming_gather_generic(const uint64_t* query, const uint64_t* codes, int num_words,
+                                   const int* rows, int count, int* distances) {
+    for (int i = 0; i < count; ++i) {
+        distances[i] = hamming_distance_words(query, codes + static_cast<size_t>(rows[i]) * num_words, num_words);
+    }
+}
+
+// Despachador: 16, 32 y 64 bits ocupan 1 palabra, 128 bits 2 y 256 bits 4
+inline HammingScanKernel select_hamming_scan(int num_words) {
+    switch (num_words) {
+        case 1: return &hamming_scan_fixed<1>;
+        case 2: return &hamming_scan_fixed<2>;
+        case 3: return &hamming_scan_fixed<3>;
+        case 4: return &hamming_scan_fixed<4>;
+        default: return &hamming_scan_generic;
+    }
+}
+
+// true si 'num_bits' tiene kernels de hashing especializados (SRPHasher)
+inline bool has_fixed_code_kernels(int num_bits) {
+    return num_bits == 16 || num_bits == 32 || num_bits == 64 || num_bits == 128 || num_bits == 256;
+}
+
+#endif // FIXED_CODE_H
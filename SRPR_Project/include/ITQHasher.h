@@ -0,0 +1,60 @@
+#ifndef ITQ_HASHER_H
+#define ITQ_HASHER_H
+
+#include "LSH.h"
+#include "UserItemStore.h"
+#include <vector>
+
+// Iterative Quantization (Gong & Lazebnik): proyecciones aprendidas de los vectores del
+// catálogo en vez de muestreadas. Primero se toman las b direcciones principales (PCA sobre
+// el segundo momento X^T X, sin centrar, para que el bit siga siendo sign(w^T x) y la
+// distancia Hamming aproxime el ángulo consulta-ítem como en SRP). Después se busca una
+// rotación ortogonal R de b×b que minimiza el error de cuantización ||B - V R||² con
+// V = X P y B = sign(V R), alternando: B = sign(V R) y R = factor polar de V^T B.
+// Cada iteración no aumenta el error. Las b filas aprendidas (P R)^T se hashean con los
+// kernels de SRPHasher, así que el coste por vector es el de SRP con b bits, y se guardan
+// con el modelo como cualquier proyección (save_model con get_projection(), ver ModelFile.h).
+// Requiere b <= d; si no, fit() devuelve false y el hasher queda sin inicializar.
+class ITQHasher : public LSH {
+public:
+    // Sin inicializar hasta fit()
+    ITQHasher(int dimensions, int num_hashes);
+
+    // Ajusta con los vectores de ítems del almacén (en orden de id). 'seed' fija la
+    // rotación inicial aleatoria (0 usa random_device, como SRPHasher).
+    bool fit(const UserItemStore& store, int iterations = 50, unsigned int seed = 42);
+
+    // Ajusta con n filas de d doubles separadas por 'stride'
+    bool fit(const double* vectors, int n, int stride, int iterations = 50, unsigned int seed = 42);
+
+    void print_hash_info() const;
+    bool is_initialized() const { return projection.is_initialized(); }
+
+    // Error de cuantización medio por vector en cada iteración del último fit()
+    const std::vector<double>& get_quantization_errors() const { return quantization_errors; }
+
+    // Fracción de la energía ||X||² capturada por las b direcciones principales
+    double get_explained_energy() const { return explained_energy; }
+
+    // Proyección aprendida (SRPHasher con la matriz (P R)^T)
+    const SRPHasher& get_projection() const { return projection; }
+    const double* projection_row(int i) const { return projection.projection_row(i); }
+
+    void generate_packed_code(const Vector& vec, uint64_t* out) const override;
+    using LSH::generate_packed_code;
+
+    void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const override;
+
+    // Proyecciones crudas w_i^T x (el bit i es proyección >= 0)
+    void project(const Vector& vec, double* out) const { projection.project(vec, out); }
+
+protected:
+    char hash_to_bit(const Vector& vec, int hash_function_index) const override;
+
+private:
+    SRPHasher projection;
+    std::vector<double> quantization_errors;
+    double explained_energy;
+};
+
+#endif // ITQ_HASHER_H
@@ -5,6 +5,8 @@
 #include <string>
 #include <random>
 #include <numeric> // Para std::inner_product
+#include "PackedCode.h"
+#include "BFloat16.h"
 
 using Vector = std::vector<double>;
 
@@ -17,6 +19,20 @@ public:
     // Genera un código binario de longitud b para un vector dado.
     std::string generate_code(const Vector& vec) const;
 
+    // Genera el mismo código empaquetado en palabras de 64 bits (bit i -> palabra i/64).
+    PackedCode generate_packed_code(const Vector& vec) const;
+
+    // Escribe el código empaquetado en 'out' (code_words() palabras, ya reservadas).
+    virtual void generate_packed_code(const Vector& vec, uint64_t* out) const;
+
+    // Número de palabras de 64 bits por código
+    int code_words() const { return code_words_for_bits(b); }
+
+    // Hashea n vectores de una vez. 'vectors' apunta a n filas de d doubles separadas por
+    // 'stride' doubles; los códigos se escriben contiguos en 'out_codes' (n × code_words()).
+    // La implementación base recorre las filas una a una; las subclases pueden especializarla.
+    virtual void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const;
+
     // Getters para información de configuración
     int get_dimensions() const { return d; }
     int get_num_hashes() const { return b; }
@@ -34,18 +50,219 @@ class SRPHasher : public LSH {
 public:
     SRPHasher(int dimensions, int num_hashes, unsigned int seed = 0);
 
+    // Proyección dada en vez de muestreada: 'matrix' es b×d por filas (p. ej. la matriz
+    // aprendida por ITQHasher). Si el tamaño no coincide queda sin inicializar.
+    SRPHasher(int dimensions, int num_hashes, const std::vector<double>& matrix);
+
     // Función para obtener información de debug
     void print_hash_info() const;
     
     // Función para verificar la configuración
     bool is_initialized() const;
 
+    // Código empaquetado calculado directamente con el kernel matricial (sin llamadas por bit)
+    void generate_packed_code(const Vector& vec, uint64_t* out) const override;
+    using LSH::generate_packed_code;
+
+    // Kernel por bloques: proyección (b×d) × bloque (d×N) y empaquetado directo de signos
+    void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const override;
+
+    // El mismo kernel sobre embeddings en float o bfloat16 (EmbeddingMatrix): proyección y
+    // acumulación en float, el doble de carriles SIMD. Los bits sólo difieren de la versión
+    // double en proyecciones casi nulas.
+    void hash_batch(const float* vectors, int n, int stride, uint64_t* out_codes) const;
+    void hash_batch(const bfloat16* vectors, int n, int stride, uint64_t* out_codes) const;
+
+    // Filas de Int8Matrix: la escala de cada fila es positiva y no cambia el signo de las
+    // proyecciones, así que se hashean los enteros directamente (sin las escalas)
+    void hash_batch(const int8_t* vectors, int n, int stride, uint64_t* out_codes) const;
+
+    // Proyecciones crudas a_i^T x de las b funciones hash (el bit i es proyección >= 0).
+    // Su magnitud es el margen del bit: útil para multi-probe. 'out' tiene b posiciones.
+    void project(const Vector& vec, double* out) const;
+
+    // Fila i de la matriz de proyección (vector 'a' de la función hash i)
+    const double* projection_row(int i) const { return projection_matrix.data() + static_cast<size_t>(i) * d; }
+
+protected:
+    char hash_to_bit(const Vector& vec, int hash_function_index) const override;
+
+private:
+    // Parámetros 'a' de las funciones de hash: matriz b×d contigua por filas
+    std::vector<double> projection_matrix;
+    std::vector<float> projection_matrix_f32;  // Copia en float para los kernels de menor precisión
+    bool initialized;
+};
+
+// SRP con coeficientes regenerados desde la semilla: a[i][j] es una normal en float derivada
+// de Philox4x32-10 con contador (i, j/4) y clave (seed), calculada dentro del kernel en vez
+// de guardarse. El hasher queda definido sólo por (seed, d, b): dos nodos con los mismos
+// parámetros producen los mismos códigos bit a bit, y la memoria de parámetros es O(1).
+class PhiloxSRPHasher : public LSH {
+public:
+    PhiloxSRPHasher(int dimensions, int num_hashes, unsigned int seed);
+
+    void print_hash_info() const;
+    bool is_initialized() const { return d > 0 && b > 0; }
+
+    unsigned int get_seed() const { return seed; }
+
+    // Coeficiente a[hash_function_index][dim] (recalculado, no almacenado)
+    float coefficient(int hash_function_index, int dim) const;
+
+    // Escribe la fila completa de coeficientes de la función hash 'i' en 'row' (d floats)
+    void generate_row(int hash_function_index, float* row) const;
+
+    void generate_packed_code(const Vector& vec, uint64_t* out) const override;
+    using LSH::generate_packed_code;
+
+    // Kernel por bloques: cada fila de coeficientes se genera una vez por bloque de ítems
+    void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const override;
+
+    // Proyecciones crudas a_i^T x
+    void project(const Vector& vec, double* out) const;
+
+protected:
+    char hash_to_bit(const Vector& vec, int hash_function_index) const override;
+
+private:
+    unsigned int seed;
+};
+
+// SRP con proyecciones muy dispersas (Achlioptas / Li et al.): cada coeficiente vale +1 o -1
+// con probabilidad 1/(2s) cada uno y 0 en otro caso (por defecto s = sqrt(d)). El signo
+// no depende de la escala, así que a^T x se reduce a sumas y restas sobre ~d/s índices.
+// Filas sin ningún coeficiente no nulo se vuelven a muestrear (darían un bit constante).
+class SparseSRPHasher : public LSH {
+public:
+    // 'density' = 1/s = fracción esperada de coeficientes no nulos (<= 0 usa 1/sqrt(d))
+    SparseSRPHasher(int dimensions, int num_hashes, unsigned int seed = 0, double density = 0.0);
+
+    void print_hash_info() const;
+    bool is_initialized() const;
+
+    double get_density() const { return density; }
+    // Coeficientes no nulos en total (memoria de parámetros: un índice por coeficiente)
+    int get_num_nonzeros() const { return static_cast<int>(plus_index.size() + minus_index.size()); }
+
+    void generate_packed_code(const Vector& vec, uint64_t* out) const override;
+    using LSH::generate_packed_code;
+
+    // Igual que generate_packed_code, leyendo las filas directamente (sin copiarlas a Vector)
+    void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const override;
+
+    // Proyecciones crudas a_i^T x (sumas de coordenadas +1 menos las de -1)
+    void project(const Vector& vec, double* out) const;
+
+protected:
+    char hash_to_bit(const Vector& vec, int hash_function_index) const override;
+
+private:
+    double projection_at(const double* x, int hash_function_index) const;
+    void encode_row(const double* x, uint64_t* out) const;
+
+    double density;
+    // Listas de índices por fila en formato CSR: fila i -> [offsets[i], offsets[i+1])
+    std::vector<int> plus_index, plus_offsets;
+    std::vector<int> minus_index, minus_offsets;
+    bool initialized;
+};
+
+// SRP con proyecciones estructuradas: en lugar de b vectores gaussianos densos (O(b·d)
+// parámetros y multiplicaciones), cada bloque de p bits (p = potencia de 2 >= d) aplica
+// al vector rellenado con ceros la transformada H·D3·H·D2·H·D1, donde H es Walsh-Hadamard
+// (sin normalizar) y D_r son diagonales de signos aleatorios. Tres rondas bastan para que
+// cada salida se comporte como una proyección gaussiana, conservando Pr[colisión] ≈ 1 - θ/π.
+// Costo: O(p log p) por bloque y 3·p signos de parámetros por bloque; b > p apila bloques.
+class FastHadamardHasher : public LSH {
+public:
+    FastHadamardHasher(int dimensions, int num_hashes, unsigned int seed = 0);
+
+    void print_hash_info() const;
+    bool is_initialized() const;
+
+    // Tamaño de la transformada (d rellenado a potencia de 2) y número de bloques apilados
+    int get_padded_dimensions() const { return p; }
+    int get_num_blocks() const { return num_blocks; }
+
+    // Una transformada por bloque en lugar de una proyección por bit
+    void generate_packed_code(const Vector& vec, uint64_t* out) const override;
+    using LSH::generate_packed_code;
+
+    // Igual que generate_packed_code, leyendo las filas directamente (sin copiarlas a Vector)
+    void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const override;
+
+    // Proyecciones crudas (las b salidas de los bloques), análogo a SRPHasher::project
+    void project(const Vector& vec, double* out) const;
+
 protected:
     char hash_to_bit(const Vector& vec, int hash_function_index) const override;
 
 private:
-    std::vector<Vector> random_vectors; // Parámetros 'a' de las funciones de hash
+    static const int NUM_ROUNDS = 3;
+
+    // Aplica H·D3·H·D2·H·D1 del bloque 'block' a x (d valores); 'work' tiene p posiciones
+    void transform_block(const double* x, int block, double* work) const;
+    void encode_row(const double* x, uint64_t* out, std::vector<double>& work) const;
+
+    int p;           // Dimensión rellenada (potencia de 2)
+    int num_blocks;  // ceil(b / p)
+    // Signos ±1: num_blocks × NUM_ROUNDS × p, contiguos por (bloque, ronda)
+    std::vector<double> signs;
     bool initialized;
 };
 
+// Hashing asimétrico sobre una proyección SRP compartida: los ítems y las consultas pasan
+// por transformaciones distintas a d+1 dimensiones antes de hashearse con el mismo
+// SRPHasher (d+1 dimensiones), así que sus códigos son comparables por distancia Hamming.
+// Las subclases sólo definen transform(); dimensiones = las de la proyección menos una.
+class AsymmetricSRPHasher : public LSH {
+public:
+    // 'projection' debe vivir más que este objeto
+    explicit AsymmetricSRPHasher(const SRPHasher& projection);
+
+    bool is_initialized() const { return d > 0 && projection.is_initialized(); }
+    const SRPHasher& get_projection() const { return projection; }
+
+    // Escribe en 'out' (d+1 doubles) la transformación del vector 'vec' (d doubles)
+    virtual void transform(const double* vec, double* out) const = 0;
+
+    void generate_packed_code(const Vector& vec, uint64_t* out) const override;
+    using LSH::generate_packed_code;
+
+    // Transforma por bloques y delega en el kernel matricial de la proyección
+    void hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const override;
+
+protected:
+    char hash_to_bit(const Vector& vec, int hash_function_index) const override;
+
+    const SRPHasher& projection;
+};
+
+// Simple-ALSH (Neyshabur & Srebro) para búsqueda de máximo producto interno (MIPS):
+// SRP sólo preserva el ángulo y pierde la norma del ítem. Los ítems se escalan por la norma
+// máxima del catálogo M y se completan a norma 1: P(x) = [x/M, sqrt(1 - ||x/M||²)]. La
+// consulta se rellena con un cero: Q(q) = [q, 0]. Entonces cos(P(x), Q(q)) = q·x / (M·||q||),
+// y ordenar por ángulo en d+1 dimensiones equivale a ordenar por producto interno en d.
+class SimpleALSHItemHasher : public AsymmetricSRPHasher {
+public:
+    // 'max_norm' = M, norma máxima de los ítems (normas mayores se truncan a 1 tras escalar)
+    SimpleALSHItemHasher(const SRPHasher& projection, double max_norm);
+
+    double get_max_norm() const { return max_norm; }
+
+    void transform(const double* vec, double* out) const override;
+
+private:
+    double max_norm;
+};
+
+// Transformación de consulta de Simple-ALSH: Q(q) = [q, 0] (la escala de q no cambia signos)
+class SimpleALSHQueryHasher : public AsymmetricSRPHasher {
+public:
+    explicit SimpleALSHQueryHasher(const SRPHasher& projection);
+
+    void transform(const double* vec, double* out) const override;
+};
+
 #endif // LSH_H
\ No newline at end of file
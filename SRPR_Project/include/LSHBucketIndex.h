@@ -0,0 +1,73 @@
+#ifndef LSH_BUCKET_INDEX_H
+#define LSH_BUCKET_INDEX_H
+
+#include "LSH.h"
+#include "LSHIndex.h"
+#include "UserItemStore.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Orden en que multi-probe visita los buckets vecinos de cada tabla
+enum class ProbeStrategy {
+    HammingRadius,    // Radio Hamming creciente: 1 bit invertido, luego 2, ...
+    ProjectionMargin  // Por margen: primero los bits cuya proyección quedó más cerca de 0
+};
+
+// Índice LSH por tablas hash (L tablas × k bits), como en la evaluación por
+// "hash table lookup" del paper de Le et al.
+// Un SRPHasher de L·k bits genera los códigos; la tabla t usa los bits [t·k, (t+1)·k)
+// como clave de bucket. Una consulta sólo visita los L buckets que coinciden exactamente
+// con su código, así el costo crece con el tamaño de los buckets y no con el catálogo.
+class LSHBucketIndex {
+public:
+    LSHBucketIndex(int dimensions, int num_tables, int bits_per_table, unsigned int seed = 42);
+
+    // El índice de códigos guarda una referencia al hasher interno: no se copia
+    LSHBucketIndex(const LSHBucketIndex&) = delete;
+    LSHBucketIndex& operator=(const LSHBucketIndex&) = delete;
+
+    // Hashea el catálogo y llena las L tablas
+    void build(const UserItemStore& store);
+
+    // Rehashea sólo 'item_ids' y los cambia de bucket donde haga falta (ver LSHIndex::refresh).
+    // Devuelve cuántos ítems se rehashearon.
+    int refresh(const UserItemStore& store, const std::vector<int>& item_ids);
+
+    // Unión (sin repetidos) de los item_ids en los buckets de la consulta
+    std::vector<int> query_candidates(const Vector& query) const;
+
+    // Multi-probe: visita 'num_probes' buckets por tabla (el exacto + num_probes-1 vecinos
+    // en el orden de 'strategy'). Con num_probes = 1 equivale a query_candidates(query).
+    std::vector<int> query_candidates(const Vector& query, int num_probes, ProbeStrategy strategy) const;
+
+    // Máscaras XOR (de k bits) a aplicar a la clave exacta de una tabla, en orden de visita.
+    // 'margins' son los |a_i^T x| de los k bits de la tabla (sólo para ProjectionMargin).
+    std::vector<uint64_t> probe_sequence(const double* margins, int num_probes, ProbeStrategy strategy) const;
+
+    // Clave de bucket de la tabla 'table' dentro de un código empaquetado
+    uint64_t bucket_key(const uint64_t* code, int table) const;
+
+    // Información de configuración
+    int get_num_tables() const { return num_tables; }
+    int get_bits_per_table() const { return bits_per_table; }
+    int size() const { return codes.size(); }
+    const SRPHasher& get_hasher() const { return hasher; }
+
+    // Memoria de códigos + tablas (aproximada, bytes)
+    size_t memory_bytes() const;
+
+    // Estadísticas de ocupación de buckets
+    void print_info() const;
+
+private:
+    int num_tables;      // L
+    int bits_per_table;  // k (<= 64)
+    SRPHasher hasher;    // L·k funciones hash
+    LSHIndex codes;      // Códigos L·k bits de cada ítem (filas densas)
+
+    // Una tabla por grupo de k bits: clave de bucket -> filas del índice
+    std::vector<std::unordered_map<uint64_t, std::vector<int>>> tables;
+};
+
+#endif // LSH_BUCKET_INDEX_H
@@ -0,0 +1,101 @@
+#ifndef LSH_INDEX_H
+#define LSH_INDEX_H
+
+#include "LSH.h"
+#include "UserItemStore.h"
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Índice persistente de códigos LSH del catálogo.
+// Hashea todos los ítems una sola vez y guarda los códigos empaquetados en un arreglo
+// contiguo (fila r -> palabras [r*W, (r+1)*W)) junto a un arreglo denso de item_ids.
+// Cada consulta sólo hashea el vector del usuario: O(n) popcounts por consulta.
+//
+// Cascada de prefijos (opcional): los primeros p bits de un código SRP son a su vez un
+// código SRP de p bits, así que un prefijo corto sirve de filtro grueso. Cada prefijo se
+// guarda en su propio arreglo contiguo (fila r -> ceil(p/64) palabras, bits sobrantes en
+// cero) para que la primera etapa recorra el catálogo con 1 palabra por ítem; las etapas
+// siguientes sólo leen las filas supervivientes y la última compara el código completo.
+class LSHIndex {
+public:
+    explicit LSHIndex(const LSH& hasher);
+
+    // Índice asimétrico: el catálogo se hashea con 'hasher' y las consultas con
+    // 'query_hasher' (p. ej. Simple-ALSH para MIPS). Ambos deben producir b bits comparables.
+    LSHIndex(const LSH& hasher, const LSH& query_hasher);
+
+    // Hashea todos los vectores de ítems del store (reemplaza el contenido anterior).
+    void build(const UserItemStore& store);
+
+    // Carga códigos ya calculados con este hasher (p. ej. los de un modelo guardado, ver
+    // ModelFile.h) sin hashear: 'ids' ascendentes y n × code_words() palabras.
+    void load_codes(const int* ids, int n, const uint64_t* item_codes);
+
+    // Rehashea sólo los ítems 'changed_ids' (p. ej. store.get_dirty_items()) y actualiza sus
+    // filas y prefijos. Si alguno no está en el índice (catálogo cambiado) reconstruye todo.
+    // Devuelve cuántas filas se rehashearon.
+    int refresh(const UserItemStore& store, const std::vector<int>& changed_ids);
+
+    // Fila de un item_id (búsqueda binaria) o -1 si no está indexado
+    int row_of(int item_id) const;
+
+    // Código empaquetado de un vector de consulta (con query_hasher; por defecto el del índice).
+    PackedCode encode(const Vector& query) const;
+
+    // Distancias Hamming del código de consulta a todas las filas del índice.
+    void compute_distances(const PackedCode& query_code, std::vector<int>& distances) const;
+
+    // Top-k ítems por distancia Hamming ascendente: pares <item_id, distancia>.
+    std::vector<std::pair<int, int>> search(const Vector& query, int top_k) const;
+    std::vector<std::pair<int, int>> search(const PackedCode& query_code, int top_k) const;
+
+    // Construye los arreglos de prefijos de la cascada (longitudes en bits, crecientes y
+    // menores que b; las demás se descartan). build() los recalcula. Vacío = sin cascada.
+    void build_prefix_cascade(const std::vector<int>& prefix_bits);
+    bool has_prefix_cascade() const { return !prefix_stages.empty(); }
+    std::vector<int> get_prefix_bits() const;
+
+    // Top-k por cascada: la etapa s conserva las survivors[s] filas más cercanas según el
+    // prefijo s (un presupuesto ausente o <= 0 conserva todas; nunca menos de top_k) y el
+    // código completo ordena a los supervivientes finales. Con presupuestos >= size() el
+    // resultado es idéntico a search(). 'rows_compared' (opcional) recibe las filas
+    // comparadas fuera de la primera etapa.
+    std::vector<std::pair<int, int>> cascade_search(const PackedCode& query_code, int top_k,
+                                                    const std::vector<int>& survivors,
+                                                    long long* rows_compared = nullptr) const;
+
+    // Acceso a la estructura interna
+    int size() const { return static_cast<int>(item_ids.size()); }
+    bool empty() const { return item_ids.empty(); }
+    int get_code_words() const { return words_per_code; }
+    int get_num_bits() const { return hasher.get_num_hashes(); }
+    int item_id_at(int row) const { return item_ids[row]; }
+    const uint64_t* code_at(int row) const { return codes.data() + static_cast<size_t>(row) * words_per_code; }
+    const std::vector<int>& get_item_ids() const { return item_ids; }
+    const std::vector<uint64_t>& get_codes() const { return codes; }
+    const LSH& get_hasher() const { return hasher; }
+    const LSH& get_query_hasher() const { return query_hasher; }
+
+    // Memoria ocupada por códigos, prefijos e ids (bytes)
+    size_t memory_bytes() const;
+
+private:
+    const LSH& hasher;
+    const LSH& query_hasher;
+    int words_per_code;
+    std::vector<int> item_ids;     // fila -> item_id (ordenado ascendentemente)
+    std::vector<uint64_t> codes;   // n × W palabras contiguas
+
+    // Un nivel de la cascada: prefijo de 'bits' bits de cada fila, n × words palabras
+    struct PrefixStage {
+        int bits;
+        int words;
+        std::vector<uint64_t> codes;
+    };
+    std::vector<PrefixStage> prefix_stages;  // Ordenados de menor a mayor longitud
+
+    void fill_prefix_codes(PrefixStage& stage) const;
+};
+
+#endif // LSH_INDEX_H
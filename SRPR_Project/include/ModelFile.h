@@ -0,0 +1,141 @@
+#ifndef MODEL_FILE_H
+#define MODEL_FILE_H
+
+#include "UserItemStore.h"
+#include "LSH.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Modelo entrenado en un archivo binario versionado, pensado para abrirse con mmap sin
+// parsear ni copiar: una cabecera de tamaño fijo seguida de secciones alineadas a 64 bytes
+// con los arreglos tal cual están en memoria (enteros y doubles en el orden de bytes de la
+// máquina, comprobado con 'byte_order'):
+//   user_ids / item_ids       int32, ordenados (fila r -> id), como en UserItemStore
+//   user_matrix / item_matrix double, filas de 'row_stride' posiciones (relleno en cero)
+//   user_norms / item_norms   double, norma L2 de cada fila
+//   projections               double, b filas de d coeficientes del hasher (muestreadas o
+//                             aprendidas con ITQ: en ambos casos el bit i es a_i^T x >= 0)
+//   item_codes                uint64, código de b bits de cada ítem (code_words palabras)
+// Las proyecciones van en el archivo (además de la seed) para que los códigos no dependan
+// de que std::normal_distribution genere la misma secuencia en otra biblioteca estándar.
+enum ModelSection {
+    SectionUserIds = 0,
+    SectionItemIds,
+    SectionUserMatrix,
+    SectionItemMatrix,
+    SectionUserNorms,
+    SectionItemNorms,
+    SectionProjections,
+    SectionItemCodes,
+    NumModelSections
+};
+
+// Origen de las proyecciones guardadas
+enum ModelHasher {
+    ModelHasherSRP = 0,  // Muestreadas de N(0, 1) con 'hasher_seed'
+    ModelHasherITQ,      // Aprendidas con ITQHasher sobre los ítems ('hasher_seed' = seed del ajuste)
+    NumModelHashers
+};
+
+// Nombres para la línea de comandos: "srp", "itq"
+const char* model_hasher_name(ModelHasher hasher);
+bool parse_model_hasher(const std::string& name, ModelHasher& out);
+
+struct ModelSectionEntry {
+    uint64_t offset;  // Desde el inicio del archivo, múltiplo de 64
+    uint64_t bytes;
+};
+
+struct ModelFileHeader {
+    char magic[8];          // "SRPRMDL\0"
+    uint32_t version;
+    uint32_t header_bytes;  // sizeof(ModelFileHeader)
+    uint32_t byte_order;    // 0x01020304 escrito en el orden de la máquina
+    int32_t dimensions;
+    int32_t row_stride;
+    int32_t num_users;
+    int32_t num_items;
+    int32_t lsh_bits;
+    int32_t code_words;
+    uint32_t hasher_seed;
+    uint32_t hasher;        // ModelHasher
+    uint32_t reserved;      // Cero; mantiene file_bytes alineado a 8
+    uint64_t file_bytes;
+    ModelSectionEntry sections[NumModelSections];
+};
+
+const uint32_t MODEL_FILE_VERSION = 1;
+
+// Escribe el almacén (modo Dense), las proyecciones de 'projection' y los códigos de sus
+// ítems. 'kind' y 'hasher_seed' describen de dónde salen las proyecciones (para ITQ se pasa
+// ITQHasher::get_projection()). Devuelve false si el almacén no es denso o no se pudo escribir.
+bool save_model(const std::string& path, const UserItemStore& store, const SRPHasher& projection,
+                ModelHasher kind, unsigned int hasher_seed);
+
+// Modelo abierto con mmap (en Windows se lee a un búfer alineado). Los punteros apuntan
+// directamente al archivo mapeado y son válidos mientras viva el objeto; abrir cuesta lo
+// que validar la cabecera, y las páginas se cargan al tocarlas.
+class MappedModel {
+public:
+    MappedModel();
+    ~MappedModel();
+
+    // Abre y valida el archivo (firma, versión, orden de bytes, tamaños y límites de las
+    // secciones). Si falla devuelve false y deja el motivo en 'error' (si no es nulo).
+    bool open(const std::string& path, std::string* error = nullptr);
+    void close();
+    bool is_open() const { return base != nullptr; }
+
+    int get_dimensions() const { return header().dimensions; }
+    int row_stride() const { return header().row_stride; }
+    int num_users() const { return header().num_users; }
+    int num_items() const { return header().num_items; }
+    int get_num_bits() const { return header().lsh_bits; }
+    int get_code_words() const { return header().code_words; }
+    unsigned int get_hasher_seed() const { return header().hasher_seed; }
+    ModelHasher get_hasher() const { return static_cast<ModelHasher>(header().hasher); }
+    uint32_t get_version() const { return header().version; }
+    size_t file_bytes() const { return mapped_bytes; }
+
+    const int32_t* user_ids() const { return section<int32_t>(SectionUserIds); }
+    const int32_t* item_ids() const { return section<int32_t>(SectionItemIds); }
+    const double* user_matrix() const { return section<double>(SectionUserMatrix); }
+    const double* item_matrix() const { return section<double>(SectionItemMatrix); }
+    const double* projections() const { return section<double>(SectionProjections); }
+    const uint64_t* item_codes() const { return section<uint64_t>(SectionItemCodes); }
+
+    // Fila de un id (búsqueda binaria en los ids ordenados) o -1 si no está
+    int user_row(int user_id) const;
+    int item_row(int item_id) const;
+
+    const double* user_data(int row) const { return user_matrix() + static_cast<size_t>(row) * row_stride(); }
+    const double* item_data(int row) const { return item_matrix() + static_cast<size_t>(row) * row_stride(); }
+    double user_norm(int row) const { return section<double>(SectionUserNorms)[row]; }
+    double item_norm(int row) const { return section<double>(SectionItemNorms)[row]; }
+    const uint64_t* item_code(int row) const { return item_codes() + static_cast<size_t>(row) * get_code_words(); }
+
+    // SRPHasher con las proyecciones guardadas (no se vuelve a muestrear desde la seed):
+    // los usuarios se codifican con él y sus bits coinciden con item_codes()
+    SRPHasher make_hasher() const;
+
+private:
+    MappedModel(const MappedModel&);
+    MappedModel& operator=(const MappedModel&);
+
+    const unsigned char* base;
+    size_t mapped_bytes;
+#ifdef _WIN32
+    std::vector<unsigned char, AlignedAllocator<unsigned char> > buffer;
+#endif
+
+    const ModelFileHeader& header() const { return *reinterpret_cast<const ModelFileHeader*>(base); }
+
+    template <typename T>
+    const T* section(ModelSection id) const {
+        return reinterpret_cast<const T*>(base + header().sections[id].offset);
+    }
+};
+
+#endif // MODEL_FILE_H
@@ -0,0 +1,72 @@
+#ifndef MULTI_INDEX_HASHING_H
+#define MULTI_INDEX_HASHING_H
+
+#include "LSHIndex.h"
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <utility>
+
+// Multi-index hashing (Norouzi, Punjani y Fleet, CVPR 2012) sobre los códigos de un LSHIndex.
+// Cada código de B bits se parte en m subcadenas disjuntas con una tabla hash por subcadena.
+// Por el principio del palomar, si ||h - g|| <= r entonces alguna subcadena está a distancia
+// <= floor(r/m), así que basta sondear radios pequeños en cada tabla y verificar la distancia
+// completa de los candidatos: búsqueda exacta por radio y k-NN exacto, sublineal en n.
+class MultiIndexHashing {
+public:
+    // Filtro opcional sobre item_id (p.ej. metadatos); los ítems rechazados no cuentan para k
+    typedef std::function<bool(int)> ItemFilter;
+
+    // 'index' debe estar construido y vivir más que este objeto. Lanza std::invalid_argument
+    // si m no está en [1, B] o alguna subcadena superaría 64 bits.
+    MultiIndexHashing(const LSHIndex& index, int num_substrings);
+
+    // m recomendado: B / log2(n) (subcadenas de ~log2(n) bits, buckets de ~1 ítem)
+    static int suggested_substrings(int num_bits, int num_items);
+
+    // Llena las m tablas con las filas actuales del índice
+    void build();
+
+    // Reubica 'rows' tras cambiar sus códigos en el índice (LSHIndex::refresh).
+    // 'previous_codes' tiene los códigos anteriores de esas filas, rows.size() × W palabras.
+    void update_rows(const std::vector<int>& rows, const std::vector<uint64_t>& previous_codes);
+
+    // Todos los ítems a distancia <= radius: pares <item_id, distancia> ordenados por
+    // (distancia, fila), como LSHIndex::search
+    std::vector<std::pair<int, int>> range_search(const PackedCode& query_code, int radius,
+                                                  int* num_candidates = nullptr) const;
+
+    // k-NN Hamming exacto: mismos resultados que LSHIndex::search (empates por fila)
+    std::vector<std::pair<int, int>> search(const PackedCode& query_code, int top_k,
+                                            const ItemFilter& filter = ItemFilter(),
+                                            int* num_candidates = nullptr) const;
+    std::vector<std::pair<int, int>> search(const Vector& query, int top_k) const;
+
+    // Clave de la subcadena 'j' dentro de un código empaquetado
+    uint64_t substring_key(const uint64_t* code, int j) const;
+
+    int get_num_substrings() const { return num_substrings; }
+    int get_substring_bits(int j) const { return lengths[j]; }
+    int size() const { return index.size(); }
+    const LSHIndex& get_index() const { return index; }
+
+    // Memoria de las tablas (aproximada, bytes; los códigos viven en el LSHIndex)
+    size_t memory_bytes() const;
+
+    void print_info() const;
+
+private:
+    // Agrega a 'rows' las filas de la tabla 'j' cuya subcadena está a distancia exacta 'radius' de 'key'
+    void probe_radius(int j, uint64_t key, int radius, std::vector<int>& rows) const;
+
+    const LSHIndex& index;
+    int num_substrings;          // m
+    std::vector<int> offsets;    // Bit inicial de cada subcadena
+    std::vector<int> lengths;    // Bits de cada subcadena (difieren en a lo sumo 1)
+
+    // Una tabla por subcadena: clave -> filas del índice
+    std::vector<std::unordered_map<uint64_t, std::vector<int>>> tables;
+};
+
+#endif // MULTI_INDEX_HASHING_H
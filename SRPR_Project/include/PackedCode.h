@@ -0,0 +1,122 @@
+#ifndef PACKED_CODE_H
+#define PACKED_CODE_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+// Número de palabras de 64 bits necesarias para guardar un código de 'num_bits' bits.
+inline int code_words_for_bits(int num_bits) {
+    return (num_bits + 63) / 64;
+}
+
+// Cuenta los bits encendidos de una palabra de 64 bits (POPCNT cuando el compilador lo permite).
+inline int popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Posición del bit encendido más bajo de una palabra distinta de cero (TZCNT / BSF).
+inline int count_trailing_zeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1ULL)) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Distancia Hamming entre dos códigos empaquetados de 'num_words' palabras: XOR + POPCNT por palabra.
+inline int hamming_distance_words(const uint64_t* a, const uint64_t* b, int num_words) {
+    int distance = 0;
+    for (int w = 0; w < num_words; ++w) {
+        distance += popcount64(a[w] ^ b[w]);
+    }
+    return distance;
+}
+
+// Extrae 'length' bits (1..64) a partir del bit 'start' de un código empaquetado, como entero
+// (bit start -> bit 0). El rango puede cruzar el límite entre dos palabras.
+inline uint64_t extract_bits(const uint64_t* code, int start, int length) {
+    int word = start >> 6;
+    int offset = start & 63;
+
+    uint64_t value = code[word] >> offset;
+    if (offset + length > 64) {
+        value |= code[word + 1] << (64 - offset);
+    }
+    if (length < 64) {
+        value &= (1ULL << length) - 1;
+    }
+    return value;
+}
+
+// Tabla hash de buckets (clave = bits extraídos del código -> filas ordenadas), como las de
+// LSHBucketIndex y MultiIndexHashing. Mueve 'row' del bucket 'from' al bucket 'to'
+// conservando las filas ordenadas (mismo contenido que dejaría reconstruir la tabla).
+inline void move_bucket_row(std::unordered_map<uint64_t, std::vector<int>>& table, uint64_t from, uint64_t to,
+                            int row) {
+    auto it = table.find(from);
+    if (it != table.end()) {
+        std::vector<int>& rows = it->second;
+        auto pos = std::lower_bound(rows.begin(), rows.end(), row);
+        if (pos != rows.end() && *pos == row) rows.erase(pos);
+        if (rows.empty()) table.erase(it);
+    }
+    std::vector<int>& rows = table[to];
+    rows.insert(std::lower_bound(rows.begin(), rows.end(), row), row);
+}
+
+// Código LSH empaquetado: el bit i vive en words[i / 64], posición (i % 64).
+// Los bits sobrantes de la última palabra se mantienen siempre en cero.
+struct PackedCode {
+    std::vector<uint64_t> words;
+    int num_bits;
+
+    PackedCode() : num_bits(0) {}
+    explicit PackedCode(int bits) : words(code_words_for_bits(bits), 0), num_bits(bits) {}
+
+    int num_words() const { return static_cast<int>(words.size()); }
+
+    bool get_bit(int i) const { return (words[i >> 6] >> (i & 63)) & 1ULL; }
+    void set_bit(int i) { words[i >> 6] |= (1ULL << (i & 63)); }
+
+    // Representación '0'/'1' compatible con LSH::generate_code (para mostrar en consola)
+    std::string to_string() const {
+        std::string s(num_bits, '0');
+        for (int i = 0; i < num_bits; ++i) {
+            if (get_bit(i)) s[i] = '1';
+        }
+        return s;
+    }
+
+    bool operator==(const PackedCode& other) const {
+        return num_bits == other.num_bits && words == other.words;
+    }
+    bool operator!=(const PackedCode& other) const { return !(*this == other); }
+    bool operator<(const PackedCode& other) const {
+        if (num_bits != other.num_bits) return num_bits < other.num_bits;
+        return words < other.words;
+    }
+};
+
+// Distancia Hamming entre códigos empaquetados. Devuelve -1 si las longitudes no coinciden.
+inline int hamming_distance(const PackedCode& a, const PackedCode& b) {
+    if (a.num_bits != b.num_bits) return -1;
+    return hamming_distance_words(a.words.data(), b.words.data(), a.num_words());
+}
+
+#endif // PACKED_CODE_H
@@ -0,0 +1,60 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cstdint>
+#include <cmath>
+
+// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11).
+// Generador basado en contador: la salida es una función pura de (contador, clave), así que
+// cualquier número de la secuencia se obtiene en O(1) sin estado ni secuencia previa.
+struct Philox4x32 {
+    static const uint32_t M0 = 0xD2511F53u;
+    static const uint32_t M1 = 0xCD9E8D57u;
+    static const uint32_t W0 = 0x9E3779B9u;
+    static const uint32_t W1 = 0xBB67AE85u;
+
+    // Aplica las 10 rondas a 'counter' con 'key' y escribe 4 palabras aleatorias en 'out'
+    static void generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(M0) * c0;
+            uint64_t p1 = static_cast<uint64_t>(M1) * c2;
+            uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+            uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+
+            c0 = hi1 ^ c1 ^ k0;
+            c1 = lo1;
+            c2 = hi0 ^ c3 ^ k1;
+            c3 = lo0;
+
+            k0 += W0;
+            k1 += W1;
+        }
+
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+};
+
+// Cuatro normales estándar en float a partir de una salida de Philox (Box-Muller sobre dos
+// pares de uniformes de 24 bits). Determinista dado (contador, clave) y la libm usada.
+inline void philox_gaussian4(const uint32_t counter[4], const uint32_t key[2], float out[4]) {
+    uint32_t bits[4];
+    Philox4x32::generate(counter, key, bits);
+
+    const float two_pi = 6.28318530717958647692f;
+    const float inv_2_24 = 1.0f / 16777216.0f;
+    for (int pair = 0; pair < 2; ++pair) {
+        float u1 = static_cast<float>((bits[2 * pair] >> 8) + 1) * inv_2_24;  // (0, 1]: log finito
+        float u2 = static_cast<float>(bits[2 * pair + 1] >> 8) * inv_2_24;     // [0, 1)
+        float radius = std::sqrt(-2.0f * std::log(u1));
+        out[2 * pair] = radius * std::cos(two_pi * u2);
+        out[2 * pair + 1] = radius * std::sin(two_pi * u2);
+    }
+}
+
+#endif // PHILOX_H
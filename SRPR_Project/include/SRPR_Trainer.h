@@ -46,8 +46,21 @@ public:
 private:
     UserItemStore& store;
 
-    // Función para calcular p_ui, la probabilidad de colisión para SRP-LSH
-    double calculate_p_srp(const Vector& v1, const Vector& v2) const;
+    // Filas en el almacén del usuario y de los dos ítems de una tripleta
+    struct TripletRows {
+        int user;
+        int preferred;
+        int less_preferred;
+    };
+
+    // Resuelve las filas de la tripleta; lanza std::out_of_range si algún id no existe
+    TripletRows resolve_rows(const Triplet& triplet) const;
+
+    double evaluate_triplet(const TripletRows& rows, const TrainingParams& params) const;
+
+    // Función para calcular p_ui, la probabilidad de colisión para SRP-LSH, a partir del
+    // producto punto y de las normas (cacheadas en el store)
+    double calculate_p_srp(double dot, double n1, double n2) const;
     
     // Función para calcular gamma según Ecuación 5 del paper
     double calculate_gamma(double p_ui, double p_uj, int b) const;
@@ -56,16 +69,24 @@ private:
     std::pair<double, double> calculate_gamma_derivatives(double p_ui, double p_uj, int b) const;
     
     // Función para calcular la derivada de p_srp respecto a los vectores
-    std::pair<Vector, Vector> calculate_p_srp_derivatives(const Vector& v1, const Vector& v2) const;
+    // (reutiliza el producto punto y las normas ya calculados para p_srp)
+    std::pair<Vector, Vector> calculate_p_srp_derivatives(const double* v1, double n1,
+                                                          const double* v2, double n2,
+                                                          double dot_prod, int d) const;
     
     // Función principal de cálculo de gradientes
     void compute_gradients(const Triplet& triplet, const TrainingParams& params,
                           Vector& grad_xu, Vector& grad_yi, Vector& grad_yj) const;
+    void compute_gradients(const TripletRows& rows, const TrainingParams& params,
+                          Vector& grad_xu, Vector& grad_yi, Vector& grad_yj) const;
     
-    // Función para actualizar vectores con gradientes
+    // Función para actualizar vectores con gradientes (los marca como modificados en el store)
     void update_vectors(const Triplet& triplet, const Vector& grad_xu, 
                        const Vector& grad_yi, const Vector& grad_yj,
                        const TrainingParams& params);
+    void update_vectors(const Triplet& triplet, const TripletRows& rows, const Vector& grad_xu,
+                       const Vector& grad_yi, const Vector& grad_yj,
+                       const TrainingParams& params);
     
     // Funciones de utilidad matemática
     double phi(double x) const; // Función de distribución normal estándar
@@ -73,7 +94,7 @@ private:
     double safe_acos(double x) const; // acos seguro para evitar errores numéricos
     
     // Función para aplicar regularización
-    void apply_regularization(Vector& vector, double reg_factor, double learning_rate) const;
+    void apply_regularization(double* vector, int d, double reg_factor, double learning_rate) const;
     
     // Función para verificar convergencia
     bool check_convergence(const std::vector<double>& losses, double tolerance = 1e-6) const;
@@ -0,0 +1,104 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "FixedCode.h"
+#include "BFloat16.h"
+#include <string>
+
+// Kernels de producto punto y escaneo Hamming con varias versiones por conjunto de
+// instrucciones, compiladas en el mismo binario (atributos 'target', sin -march) y elegidas
+// una vez al arrancar según CPUID:
+//   Scalar  - C++ portable (POPCNT por software si el compilador no lo habilita)
+//   SSE42   - instrucción POPCNT (SSE4.2)
+//   AVX2    - producto punto con FMA de 256 bits (Hamming con POPCNT); suma vertical
+//             bit-sliced con sumadores de acarreo guardado en registros de 256 bits
+//   AVX512  - producto punto de 512 bits; Hamming con VPOPCNTDQ si la CPU lo tiene; suma
+//             vertical bit-sliced con VPTERNLOGQ (requiere VL; si no, versión AVX2)
+// Todas las versiones de Hamming dan distancias idénticas; el producto punto puede diferir
+// en el último bit por el orden de suma. Los productos en float y bfloat16 (EmbeddingMatrix)
+// acumulan en float: el doble de carriles por instrucción que en double. El producto int8
+// (Int8Matrix) es exacto en enteros de 32 bits y da lo mismo en todos los niveles: PMADDUBSW
+// (SSSE3 / AVX2) o VPDPBUSD (AVX512 con VNNI), sobre |a| y b con el signo de a.
+enum class SimdLevel {
+    Scalar,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+const char* simd_level_name(SimdLevel level);
+
+typedef double (*DotKernel)(const double* a, const double* b, int n);
+typedef double (*FloatDotKernel)(const float* a, const float* b, int n);
+typedef double (*BFloat16DotKernel)(const bfloat16* a, const float* b, int n);
+typedef int32_t (*Int8DotKernel)(const int8_t* a, const int8_t* b, int n);
+
+// Suma vertical de BitSlicedCodeStore (bloques de 256 ítems, 4 palabras por plano): suma a
+// cada contador bit-sliced (bit c de los 256 contadores en counters[4c .. 4c + 4)) cuántos
+// de los 'count' (<= 16) planos difieren de la consulta (planes[i] XOR query_masks[i], con
+// máscaras 0 o ~0). Todos los niveles dan los mismos contadores.
+typedef void (*BitSlicedAccumulateKernel)(uint64_t* counters, int counter_bits, const uint64_t* planes,
+                                          const uint64_t* query_masks, int count);
+
+// Máscara de los ítems con contador <= threshold (0 <= threshold < 2^counter_bits), en 4
+// palabras: comparación bit-sliced desde el bit más significativo
+typedef void (*BitSlicedAtMostKernel)(const uint64_t* counters, int counter_bits, int threshold, uint64_t* out);
+
+class SimdKernels {
+public:
+    // Kernels del mejor nivel soportado. La variable de entorno SRPR_SIMD_LEVEL
+    // (scalar | sse4.2 | avx2 | avx512) permite bajar el nivel para comparar.
+    static const SimdKernels& active();
+
+    // Kernels de un nivel concreto, limitado al máximo que soporta la CPU
+    static SimdKernels for_level(SimdLevel level);
+
+    // Nivel más alto utilizable en esta CPU
+    static SimdLevel best_supported_level();
+
+    SimdLevel level() const { return simd_level; }
+
+    // Descripción para informes, p. ej. "avx512 (dot: avx512f, int8: avx512vnni, hamming: popcnt,
+    // bit-sliced: avx512vl)"
+    std::string description() const;
+
+    double dot(const double* a, const double* b, int n) const { return dot_kernel(a, b, n); }
+    double dot(const float* a, const float* b, int n) const { return float_dot_kernel(a, b, n); }
+
+    // Fila bfloat16 contra consulta float (expandida a float y acumulada en float)
+    double dot(const bfloat16* a, const float* b, int n) const { return bf16_dot_kernel(a, b, n); }
+
+    // Producto de dos vectores int8 con valores en [-127, 127] (sin -128: con él los pares de
+    // PMADDUBSW podrían saturar en 16 bits)
+    int32_t dot(const int8_t* a, const int8_t* b, int n) const { return int8_dot_kernel(a, b, n); }
+
+    // Kernel de escaneo Hamming para códigos de 'num_words' palabras
+    HammingScanKernel hamming_scan(int num_words) const;
+
+    // Kernel de distancias Hamming para un subconjunto disperso de filas
+    HammingGatherKernel hamming_gather(int num_words) const;
+
+    void bit_sliced_accumulate(uint64_t* counters, int counter_bits, const uint64_t* planes,
+                               const uint64_t* query_masks, int count) const {
+        bit_sliced_kernel(counters, counter_bits, planes, query_masks, count);
+    }
+    void bit_sliced_at_most(const uint64_t* counters, int counter_bits, int threshold, uint64_t* out) const {
+        bit_sliced_at_most_kernel(counters, counter_bits, threshold, out);
+    }
+
+private:
+    explicit SimdKernels(SimdLevel level);
+
+    SimdLevel simd_level;
+    bool use_vpopcntdq;   // Sólo en AVX512: Hamming con VPOPCNTDQ (si no, versión AVX2)
+    bool use_vnni;        // Sólo en AVX512: int8 con VPDPBUSD (requiere BW + VNNI; si no, AVX2)
+    bool use_ternlog;     // Sólo en AVX512: bit-sliced con VPTERNLOGQ (requiere VL; si no, AVX2)
+    DotKernel dot_kernel;
+    FloatDotKernel float_dot_kernel;
+    BFloat16DotKernel bf16_dot_kernel;
+    Int8DotKernel int8_dot_kernel;
+    BitSlicedAccumulateKernel bit_sliced_kernel;
+    BitSlicedAtMostKernel bit_sliced_at_most_kernel;
+};
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,106 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+// Selección top-k por conteo para distancias enteras en [0, max_distance] (p.ej. Hamming
+// con max_distance = número de bits). Escribe en 'out_indices' los índices de los k valores
+// menores, ordenados por (distancia, índice) - el mismo orden que un std::sort de pares
+// <distancia, índice> - en O(n + max_distance) y sin sort por comparación:
+//   1. Histograma de distancias.
+//   2. Prefijo acumulado hasta el radio umbral R donde se alcanzan k elementos.
+//   3. Una pasada que coloca cada índice con distancia <= R en su posición final,
+//      deteniéndose en cuanto los k puestos están llenos.
+inline void counting_top_k(const int* distances, int n, int max_distance, int k,
+                           std::vector<int>& out_indices) {
+    out_indices.clear();
+    k = std::min(k, n);
+    if (k <= 0 || max_distance < 0) return;
+
+    std::vector<int> counts(max_distance + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        ++counts[distances[i]];
+    }
+
+    // offsets[r] = primera posición de salida para distancia r; R = radio umbral
+    std::vector<int> offsets(max_distance + 1, k);
+    int collected = 0;
+    int threshold = 0;
+    for (int r = 0; r <= max_distance; ++r) {
+        offsets[r] = collected;
+        threshold = r;
+        collected += counts[r];
+        if (collected >= k) break;
+    }
+
+    out_indices.resize(k);
+    int filled = 0;
+    for (int i = 0; i < n && filled < k; ++i) {
+        int d = distances[i];
+        // En el radio umbral sólo caben los primeros (k - offsets[R]) índices
+        if (d < threshold || (d == threshold && offsets[d] < k)) {
+            out_indices[offsets[d]++] = i;
+            ++filled;
+        }
+    }
+}
+
+// Top-k de mayor puntaje (p.ej. similitud coseno) con un min-heap acotado a k elementos:
+// O(n log k) tiempo y O(k) memoria, sin materializar ni ordenar la lista completa.
+// Empates de puntaje: gana el id menor, así el resultado no depende del orden de recorrido
+// (un escaneo paralelo que fusiona heaps por hilo da exactamente lo mismo que el secuencial).
+class BoundedTopK {
+public:
+    typedef std::pair<int, double> Entry;  // <id, puntaje>
+
+    explicit BoundedTopK(int k) : capacity(std::max(0, k)) {
+        heap.reserve(capacity);
+    }
+
+    // 'a' precede a 'b' en el ranking final
+    static bool better(const Entry& a, const Entry& b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    }
+
+    void push(int id, double score) {
+        if (capacity == 0) return;
+        Entry entry(id, score);
+        if (static_cast<int>(heap.size()) < capacity) {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), better);  // heap.front() = el peor
+        } else if (better(entry, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = entry;
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+
+    // Fusiona el top-k de otro selector (p.ej. el de otro hilo)
+    void merge(const BoundedTopK& other) {
+        for (const Entry& entry : other.heap) {
+            push(entry.first, entry.second);
+        }
+    }
+
+    int size() const { return static_cast<int>(heap.size()); }
+    int max_size() const { return capacity; }
+    bool full() const { return static_cast<int>(heap.size()) == capacity; }
+
+    // Peor elemento retenido (el umbral a superar cuando full()); requiere size() > 0
+    const Entry& worst() const { return heap.front(); }
+
+    // Resultado ordenado del mejor al peor
+    std::vector<Entry> sorted() const {
+        std::vector<Entry> result(heap);
+        std::sort(result.begin(), result.end(), better);
+        return result;
+    }
+
+private:
+    int capacity;
+    std::vector<Entry> heap;
+};
+
+#endif // TOP_K_H
@@ -3,19 +3,40 @@
 
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <random>
+#include <cstdint>
+#include <algorithm>
 #include "Triplet.h"
+#include "AlignedAllocator.h"
 
 using Vector = std::vector<double>;
 
+// Disposición de los vectores latentes en memoria
+enum class StorageLayout {
+    Map,    // Un Vector (reserva propia en el heap) por id en un unordered_map
+    Dense   // Dos matrices contiguas por filas (usuarios e ítems), alineadas a 64 bytes y
+            // con cada fila rellenada con ceros hasta un múltiplo de 8 doubles
+};
+
+// En ambos modos initialize() asigna filas a los ids en orden ascendente y construye un
+// índice id -> fila compacto; el acceso por fila (user_row / user_data, ...) funciona
+// siempre y es el que usan el entrenamiento, los índices de códigos y las búsquedas. El
+// acceso por referencia a Vector (get_user_vector, get_all_item_vectors) sólo existe en el
+// modo Map y lanza std::logic_error en el modo Dense.
 class UserItemStore {
 public:
-    UserItemStore(int dimensions);
+    UserItemStore(int dimensions, StorageLayout layout = StorageLayout::Map);
+
+    // Las filas apuntan a la memoria propia del objeto: no se copia
+    UserItemStore(const UserItemStore&) = delete;
+    UserItemStore& operator=(const UserItemStore&) = delete;
 
     // Inicializa los vectores para todos los usuarios e ítems encontrados en las tripletas.
     void initialize(const std::vector<Triplet>& triplets);
 
-    // Obtiene una referencia modificable a un vector.
+    // Obtiene una referencia modificable a un vector (sólo modo Map). Se modifica en el
+    // lugar: reemplazar o redimensionar el Vector invalida el acceso por fila.
     Vector& get_user_vector(int user_id);
     Vector& get_item_vector(int item_id);
 
@@ -25,13 +46,128 @@ public:
 
     const std::unordered_map<int, Vector>& get_all_item_vectors() const;
 
+    // Copia del vector (válida en ambos modos). Lanza std::out_of_range si el id no existe.
+    Vector copy_user_vector(int user_id) const;
+    Vector copy_item_vector(int item_id) const;
+
+    // === Acceso por fila ===
+    StorageLayout get_layout() const { return layout; }
+    int get_dimensions() const { return d; }
+    int num_users() const { return static_cast<int>(user_index.ids.size()); }
+    int num_items() const { return static_cast<int>(item_index.ids.size()); }
+
+    // Fila del id, o -1 si no existe
+    int user_row(int user_id) const { return user_index.row_of(user_id); }
+    int item_row(int item_id) const { return item_index.row_of(item_id); }
+
+    // Ids en orden ascendente: la fila r corresponde a ids[r]
+    const std::vector<int>& get_user_ids() const { return user_index.ids; }
+    const std::vector<int>& get_item_ids() const { return item_index.ids; }
+
+    // d doubles de la fila 'row' (0 <= row < num_users() / num_items())
+    double* user_data(int row) { return user_rows[row]; }
+    const double* user_data(int row) const { return user_rows[row]; }
+    double* item_data(int row) { return item_rows[row]; }
+    const double* item_data(int row) const { return item_rows[row]; }
+
+    // Matrices contiguas del modo Dense (nullptr en el modo Map): fila r en
+    // matrix + r * row_stride(), alineada a 64 bytes
+    const double* user_matrix() const { return layout == StorageLayout::Dense ? user_storage.data() : nullptr; }
+    const double* item_matrix() const { return layout == StorageLayout::Dense ? item_storage.data() : nullptr; }
+    int row_stride() const { return stride; }
+
+    // === Normas cacheadas ===
+    // Norma L2 de cada fila: se calculan en initialize() y mark_user_dirty / mark_item_dirty
+    // recalculan la de la fila marcada. Quien escribe vectores sin marcarlos debe llamar a
+    // recompute_norms() antes de usar las normas.
+    double user_norm(int row) const { return user_norms[row]; }
+    double item_norm(int row) const { return item_norms[row]; }
+    void recompute_norms();
+
+    // Matriz opcional de ítems normalizados (norma 1; filas de norma cero quedan en cero),
+    // con el mismo stride que item_matrix(): el coseno con el catálogo cuesta un solo producto
+    // punto por ítem. Una vez construida se mantiene al día igual que las normas.
+    void build_normalized_items();
+    void release_normalized_items();
+    bool has_normalized_items() const { return !normalized_items.empty(); }
+    const double* normalized_item_data(int row) const { return normalized_items.data() + static_cast<size_t>(row) * stride; }
+
+    // Bytes ocupados por los vectores (datos + relleno + índices id -> fila + normas)
+    size_t memory_bytes() const;
+
+    // === Seguimiento de cambios ===
+    // Quien modifica un vector en el lugar (p. ej. SRPR_Trainer::update_vectors) lo marca;
+    // los índices de códigos rehashean sólo los ítems marcados desde la última sincronización
+    // (LSHIndex::refresh / ExhaustiveBenchmark::refresh_index) y luego se limpia la lista.
+    // Marcar un vector también actualiza su norma cacheada (y su fila normalizada).
+    void mark_user_dirty(int user_id);
+    void mark_item_dirty(int item_id);
+
+    // Ids modificados desde la última limpieza, en orden de primera modificación
+    const std::vector<int>& get_dirty_users() const { return dirty_users; }
+    const std::vector<int>& get_dirty_items() const { return dirty_items; }
+    void clear_dirty_users();
+    void clear_dirty_items();
+
+    // Contador de modificaciones marcadas (crece siempre; sirve para detectar cambios en O(1))
+    uint64_t get_modification_count() const { return modification_count; }
+
     void print_summary() const;
 
 private:
+    // Índice id -> fila: ids ascendentes y, si el rango de ids es compacto, una tabla directa
+    // (id - min_id) -> fila; si no, búsqueda binaria sobre 'ids'
+    struct IdIndex {
+        std::vector<int> ids;
+        std::vector<int> table;
+        int min_id = 0;
+
+        void build(std::vector<int> sorted_ids);
+
+        int row_of(int id) const {
+            if (!table.empty()) {
+                long long offset = static_cast<long long>(id) - min_id;
+                return (offset >= 0 && offset < static_cast<long long>(table.size())) ? table[offset] : -1;
+            }
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            return (it != ids.end() && *it == id) ? static_cast<int>(it - ids.begin()) : -1;
+        }
+    };
+
+    // Reconstruye índices y tablas de filas tras initialize()
+    void build_rows();
+
+    // Escribe la fila normalizada 'row' a partir de item_rows[row] e item_norms[row]
+    void normalize_item_row(int row);
+
     int d; // Dimensionalidad de los vectores latentes
+    StorageLayout layout;
+    int stride; // Doubles por fila en el modo Dense (d redondeado a múltiplo de 8)
+
+    // Modo Map
     std::unordered_map<int, Vector> user_vectors; // Matriz X
     std::unordered_map<int, Vector> item_vectors; // Matriz Y
 
+    // Modo Dense
+    AlignedDoubleArray user_storage;
+    AlignedDoubleArray item_storage;
+
+    IdIndex user_index;
+    IdIndex item_index;
+    std::vector<double*> user_rows; // Inicio de cada fila (en el map o en la matriz)
+    std::vector<double*> item_rows;
+
+    std::vector<double> user_norms; // Norma L2 por fila
+    std::vector<double> item_norms;
+    AlignedDoubleArray normalized_items; // Vacía si no se ha construido
+
+    // Vectores modificados pendientes de sincronizar (lista + conjunto para no duplicar)
+    std::vector<int> dirty_users;
+    std::vector<int> dirty_items;
+    std::unordered_set<int> dirty_user_set;
+    std::unordered_set<int> dirty_item_set;
+    uint64_t modification_count;
+
     // Generador de números aleatorios para la inicialización.
     std::mt19937 rng;
     std::normal_distribution<double> dist;
@@ -2,6 +2,13 @@
 #include "include/UserItemStore.h"
 #include "include/SRPR_Trainer.h"
 #include "include/LSH.h"
+#include "include/LSHIndex.h"
+#include "include/TopK.h"
+#include "include/MultiIndexHashing.h"
+#include "include/CodeDiagnostics.h"
+#include "include/EmbeddingMatrix.h"
+#include "include/ModelFile.h"
+#include "include/ITQHasher.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -12,6 +19,11 @@
 #include <set>
 #include <fstream>
 #include <sstream>
+#include <memory>
+#include <sys/stat.h>
+
+// Seed del SRPHasher cuando no hay modelo guardado; un modelo (--model) trae sus proyecciones
+const unsigned int HASHER_SEED = 42;
 
 // Estructura para información de películas
 struct Movie {
@@ -131,89 +143,119 @@ void show_help() {
     std::cout << "  --min-rating-diff D     Diferencia mínima de rating (default: 1.0)" << std::endl;
     std::cout << "  --genre GENRE           Filtrar recomendaciones por género" << std::endl;
     std::cout << "  --year-range START-END  Filtrar por rango de años (ej: 2000-2010)" << std::endl;
+    std::cout << "  --retrieval MODE        Búsqueda Hamming en --recommend: linear | mih (default: linear)" << std::endl;
+    std::cout << "  --diagnostics-json FILE Guardar en --evaluate el diagnóstico de códigos en JSON" << std::endl;
+    std::cout << "  --precision P           Precisión de los embeddings al hashear en --evaluate: double | float | bf16 | int8 (default: double)" << std::endl;
+    std::cout << "  --hasher H              Proyecciones de los códigos: srp (aleatorias) | itq (aprendidas, bits <= dimensiones) (default: srp)" << std::endl;
+    std::cout << "                          Con --model se usa el hasher guardado en el modelo" << std::endl;
+    std::cout << "  --save-model FILE       Guardar en --train el modelo binario (vectores, hasher y códigos)" << std::endl;
+    std::cout << "  --model FILE            Usar en --recommend / --evaluate un modelo guardado (sin re-entrenar)" << std::endl;
     std::cout << "  --verbose               Modo verboso" << std::endl;
     std::cout << std::endl;
     std::cout << "Ejemplos:" << std::endl;
     std::cout << "  ./srpr_system --generate-data --max-ratings 1000000 --triplets-per-user 100" << std::endl;
     std::cout << "  ./srpr_system --train --epochs 30 --lr 0.01 --verbose" << std::endl;
+    std::cout << "  ./srpr_system --train --lsh-bits 64 --save-model model.srpr" << std::endl;
+    std::cout << "  ./srpr_system --train --lsh-bits 16 --hasher itq --save-model model_itq.srpr" << std::endl;
+    std::cout << "  ./srpr_system --recommend 1 --model model.srpr" << std::endl;
     std::cout << "  ./srpr_system --recommend 1 --top-k 20 --genre Action --year-range 2000-2020" << std::endl;
+    std::cout << "  ./srpr_system --recommend 1 --lsh-bits 128 --retrieval mih" << std::endl;
     std::cout << "  ./srpr_system --analyze --verbose" << std::endl;
     std::cout << "  ./srpr_system --evaluate --verbose" << std::endl;
+    std::cout << "  ./srpr_system --evaluate --lsh-bits 64 --diagnostics-json codes.json" << std::endl;
+    std::cout << "  ./srpr_system --evaluate --lsh-bits 64 --precision bf16" << std::endl;
 }
 
-// Función para generar recomendaciones usando Hamming Ranking con metadatos
+// Filtros de metadatos de --genre / --year-range (los ítems sin metadatos siempre pasan)
+bool passes_metadata_filters(int item_id, const std::map<int, Movie>& movies,
+                             const std::string& genre_filter, int year_start, int year_end) {
+    auto movie_it = movies.find(item_id);
+    if (movie_it == movies.end()) {
+        return true;
+    }
+    const Movie& movie = movie_it->second;
+    
+    // Filtro por género
+    if (!genre_filter.empty()) {
+        bool has_genre = false;
+        for (const std::string& genre : movie.genres) {
+            if (genre == genre_filter) {
+                has_genre = true;
+                break;
+            }
+        }
+        if (!has_genre) return false;
+    }
+    
+    // Filtro por año
+    return movie.year >= year_start && movie.year <= year_end;
+}
+
+// Función para generar recomendaciones usando Hamming Ranking con metadatos.
+// Los códigos de los ítems vienen precalculados (fila r -> item_ids[r] y su código en
+// item_codes, del índice o de un modelo mapeado); sólo se hashea al usuario.
+// Con 'mih' el k-NN Hamming exacto se resuelve con multi-index hashing en vez de recorrer
+// todo el catálogo (mismo resultado, incluidos los filtros).
 std::vector<std::pair<int, int>> hamming_ranking_recommendations(
-    int user_id, 
-    const UserItemStore& store, 
-    const SRPHasher& hasher, 
+    const PackedCode& user_code,
+    const int* item_ids,
+    const uint64_t* item_codes,
+    int num_items,
     const std::map<int, Movie>& movies,
     int top_k,
     const std::string& genre_filter = "",
     int year_start = 0,
-    int year_end = 9999) {
+    int year_end = 9999,
+    const MultiIndexHashing* mih = nullptr) {
     
     std::vector<std::pair<int, int>> recommendations; // <item_id, hamming_distance>
     
     try {
-        const Vector& user_vector = store.get_user_vector(user_id);
-        std::string user_code = hasher.generate_code(user_vector);
+        int words = user_code.num_words();
+        
+        if (mih) {
+            MultiIndexHashing::ItemFilter filter;
+            if (!genre_filter.empty() || year_start > 0 || year_end < 9999) {
+                filter = [&](int item_id) {
+                    return passes_metadata_filters(item_id, movies, genre_filter, year_start, year_end);
+                };
+            }
+            return mih->search(user_code, top_k, filter);
+        }
         
-        // Obtener todos los vectores de items
-        const auto& all_items = store.get_all_item_vectors();
+        // Ítems que pasan los filtros y su distancia al usuario
+        std::vector<int> candidate_ids;
+        std::vector<int> candidate_distances;
+        candidate_ids.reserve(num_items);
+        candidate_distances.reserve(num_items);
         
-        for (const auto& item_pair : all_items) {
-            int item_id = item_pair.first;
-            const Vector& item_vector = item_pair.second;
+        for (int row = 0; row < num_items; ++row) {
+            int item_id = item_ids[row];
             
             // Aplicar filtros de metadatos
-            auto movie_it = movies.find(item_id);
-            if (movie_it != movies.end()) {
-                const Movie& movie = movie_it->second;
-                
-                // Filtro por género
-                if (!genre_filter.empty()) {
-                    bool has_genre = false;
-                    for (const std::string& genre : movie.genres) {
-                        if (genre == genre_filter) {
-                            has_genre = true;
-                            break;
-                        }
-                    }
-                    if (!has_genre) continue;
-                }
-                
-                // Filtro por año
-                if (movie.year < year_start || movie.year > year_end) {
-                    continue;
-                }
+            if (!passes_metadata_filters(item_id, movies, genre_filter, year_start, year_end)) {
+                continue;
             }
             
-            std::string item_code = hasher.generate_code(item_vector);
-            
-            // Calcular distancia de Hamming
-            int distance = 0;
-            for (size_t i = 0; i < user_code.length(); ++i) {
-                if (user_code[i] != item_code[i]) {
-                    distance++;
-                }
-            }
+            // Calcular distancia de Hamming (XOR + POPCNT)
+            int distance = hamming_distance_words(user_code.words.data(),
+                                                  item_codes + static_cast<size_t>(row) * words, words);
             
-            recommendations.push_back({item_id, distance});
+            candidate_ids.push_back(item_id);
+            candidate_distances.push_back(distance);
         }
         
-        // Ordenar por distancia Hamming (menor distancia = mayor similitud)
-        std::sort(recommendations.begin(), recommendations.end(),
-            [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
-                return a.second < b.second;
-            });
+        // Top-k por conteo de distancias (menor distancia = mayor similitud), sin ordenar todo
+        std::vector<int> top_positions;
+        counting_top_k(candidate_distances.data(), static_cast<int>(candidate_distances.size()),
+                       user_code.num_bits, top_k, top_positions);
         
-        // Tomar solo top-k
-        if (recommendations.size() > top_k) {
-            recommendations.resize(top_k);
+        for (int pos : top_positions) {
+            recommendations.push_back({candidate_ids[pos], candidate_distances[pos]});
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "Error generando recomendaciones para usuario " << user_id << ": " << e.what() << std::endl;
+        std::cerr << "Error generando recomendaciones: " << e.what() << std::endl;
     }
     
     return recommendations;
@@ -227,13 +269,19 @@ double calculate_ranking_precision(const std::vector<Triplet>& test_triplets,
     
     for (const auto& triplet : test_triplets) {
         try {
-            const Vector& user_vec = store.get_user_vector(triplet.user_id);
-            const Vector& preferred_vec = store.get_item_vector(triplet.preferred_item_id);
-            const Vector& less_preferred_vec = store.get_item_vector(triplet.less_preferred_item_id);
+            int user_row = store.user_row(triplet.user_id);
+            int preferred_row = store.item_row(triplet.preferred_item_id);
+            int less_preferred_row = store.item_row(triplet.less_preferred_item_id);
+            if (user_row < 0 || preferred_row < 0 || less_preferred_row < 0) {
+                continue;
+            }
+            const double* user_vec = store.user_data(user_row);
+            const double* preferred_vec = store.item_data(preferred_row);
+            const double* less_preferred_vec = store.item_data(less_preferred_row);
             
             // Calcular productos punto (similitudes)
             double score_preferred = 0.0, score_less_preferred = 0.0;
-            for (size_t i = 0; i < user_vec.size(); ++i) {
+            for (int i = 0; i < store.get_dimensions(); ++i) {
                 score_preferred += user_vec[i] * preferred_vec[i];
                 score_less_preferred += user_vec[i] * less_preferred_vec[i];
             }
@@ -425,10 +473,28 @@ int generate_training_data(const std::string& ratings_file, int max_ratings,
     return 0;
 }
 
+// Hasher de --hasher cuando no hay modelo guardado: SRP muestreado con HASHER_SEED o ITQ
+// ajustado sobre los ítems del almacén (requiere b <= d). Devuelve false si ITQ no se ajustó.
+// 'out' puede llegar sin inicializar (proyección vacía): las proyecciones sólo se calculan aquí.
+bool build_hasher(ModelHasher kind, const UserItemStore& store, int lsh_bits, SRPHasher& out) {
+    if (kind == ModelHasherITQ) {
+        ITQHasher itq(store.get_dimensions(), lsh_bits);
+        if (!itq.fit(store, 50, HASHER_SEED)) {
+            std::cerr << "ERROR: ITQ requiere --lsh-bits <= --dimensions (" << lsh_bits << " > "
+                      << store.get_dimensions() << ") y al menos " << lsh_bits << " ítems" << std::endl;
+            return false;
+        }
+        out = itq.get_projection();
+        return true;
+    }
+    out = SRPHasher(store.get_dimensions(), lsh_bits, HASHER_SEED);
+    return true;
+}
+
 // Función principal de entrenamiento
 int train_model(const std::string& data_file, const std::string& val_file,
                 int epochs, double learning_rate, int dimensions, 
-                int lsh_bits, bool verbose) {
+                int lsh_bits, ModelHasher hasher_kind, const std::string& model_file, bool verbose) {
     
     std::cout << "=== INICIANDO ENTRENAMIENTO SRPR ===" << std::endl;
     std::cout << "Configuración:" << std::endl;
@@ -460,7 +526,7 @@ int train_model(const std::string& data_file, const std::string& val_file,
     
     // Inicializar sistema
     std::cout << "\nInicializando UserItemStore..." << std::endl;
-    UserItemStore store(dimensions);
+    UserItemStore store(dimensions, StorageLayout::Dense);
     store.initialize(training_triplets);
     store.print_summary();
     
@@ -526,6 +592,26 @@ int train_model(const std::string& data_file, const std::string& val_file,
         std::cout << "⚠️  El modelo no convergió completamente - considerar más epochs" << std::endl;
     }
     
+    // Persistir vectores, hasher y códigos del catálogo para --recommend / --evaluate --model
+    if (!model_file.empty()) {
+        auto save_start = std::chrono::high_resolution_clock::now();
+        SRPHasher hasher(dimensions, lsh_bits, std::vector<double>());
+        if (!build_hasher(hasher_kind, store, lsh_bits, hasher)) {
+            return 1;
+        }
+        if (!save_model(model_file, store, hasher, hasher_kind, HASHER_SEED)) {
+            std::cerr << "ERROR: No se pudo guardar el modelo en " << model_file << std::endl;
+            return 1;
+        }
+        auto save_end = std::chrono::high_resolution_clock::now();
+        struct stat saved;
+        long long saved_bytes = stat(model_file.c_str(), &saved) == 0 ? static_cast<long long>(saved.st_size) : 0;
+        std::cout << "💾 Modelo guardado en " << model_file << " (hasher " << model_hasher_name(hasher_kind) << ", "
+                  << saved_bytes / 1024 << " KB, "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(save_end - save_start).count()
+                  << " ms)" << std::endl;
+    }
+    
     return 0;
 }
 
@@ -533,6 +619,7 @@ int train_model(const std::string& data_file, const std::string& val_file,
 int generate_recommendations(int user_id, int top_k, int dimensions, int lsh_bits, 
                            const std::string& data_file, const std::string& movies_file,
                            const std::string& genre_filter, const std::string& year_range,
+                           const std::string& retrieval, ModelHasher hasher_kind, const std::string& model_file,
                            bool verbose) {
     
     std::cout << "=== GENERANDO RECOMENDACIONES ===" << std::endl;
@@ -562,53 +649,120 @@ int generate_recommendations(int user_id, int top_k, int dimensions, int lsh_bit
         std::cout << "✓ Cargados metadatos de " << movies.size() << " películas" << std::endl;
     }
     
-    // Cargar datos para inicializar el modelo
-    std::vector<Triplet> triplets = load_triplets(data_file);
-    if (triplets.empty()) {
-        std::cerr << "ERROR: No se pudieron cargar los datos." << std::endl;
-        return 1;
-    }
-    
-    // Inicializar sistema
-    UserItemStore store(dimensions);
-    store.initialize(triplets);
-    
-    if (verbose) {
-        store.print_summary();
+    // Modelo entrenado (--model): se mapea el archivo y se usan sus vectores, su hasher y los
+    // códigos del catálogo tal cual, sin leer las tripletas ni re-hashear
+    MappedModel model;
+    if (!model_file.empty()) {
+        auto load_start = std::chrono::high_resolution_clock::now();
+        std::string error;
+        if (!model.open(model_file, &error)) {
+            std::cerr << "ERROR: No se pudo cargar el modelo " << model_file << ": " << error << std::endl;
+            return 1;
+        }
+        auto load_end = std::chrono::high_resolution_clock::now();
+        dimensions = model.get_dimensions();
+        lsh_bits = model.get_num_bits();
+        std::cout << "✓ Modelo " << model_file << " (v" << model.get_version() << "): " << model.num_users()
+                  << " usuarios, " << model.num_items() << " ítems, " << dimensions << "D, " << lsh_bits
+                  << " bits (" << model_hasher_name(model.get_hasher()) << "), mapeado en " << std::chrono::duration_cast<std::chrono::microseconds>(
+                         load_end - load_start).count() << " μs" << std::endl;
     }
     
-    // Verificar que el usuario existe
-    try {
-        store.get_user_vector(user_id);
-    } catch (const std::exception& e) {
-        std::cerr << "ERROR: Usuario " << user_id << " no encontrado en el dataset." << std::endl;
-        std::cerr << "Usuarios disponibles: ";
+    SRPHasher hasher = model.is_open() ? model.make_hasher() : SRPHasher(dimensions, lsh_bits, std::vector<double>());
+    LSHIndex index(hasher);
+    PackedCode user_code(lsh_bits);
+    const int* item_ids = nullptr;
+    const uint64_t* item_codes = nullptr;
+    int num_items = 0;
+    
+    if (model.is_open()) {
+        int user_row = model.user_row(user_id);
+        if (user_row < 0) {
+            std::cerr << "ERROR: Usuario " << user_id << " no encontrado en el modelo." << std::endl;
+            return 1;
+        }
+        user_code = hasher.generate_packed_code(
+            Vector(model.user_data(user_row), model.user_data(user_row) + dimensions));
+        item_ids = model.item_ids();
+        item_codes = model.item_codes();
+        num_items = model.num_items();
+        
+        // MIH construye sus tablas sobre un LSHIndex: sólo entonces se copian los códigos
+        if (retrieval == "mih") {
+            index.load_codes(item_ids, num_items, item_codes);
+        }
+    } else {
+        // Cargar datos para inicializar el modelo
+        std::vector<Triplet> triplets = load_triplets(data_file);
+        if (triplets.empty()) {
+            std::cerr << "ERROR: No se pudieron cargar los datos." << std::endl;
+            return 1;
+        }
         
-        std::set<int> available_users;
-        for (const auto& triplet : triplets) {
-            available_users.insert(triplet.user_id);
+        // Inicializar sistema
+        UserItemStore store(dimensions, StorageLayout::Dense);
+        store.initialize(triplets);
+        
+        if (verbose) {
+            store.print_summary();
         }
         
-        int count = 0;
-        for (int uid : available_users) {
-            if (count++ < 10) {
-                std::cerr << uid << " ";
+        // Verificar que el usuario existe
+        if (store.user_row(user_id) < 0) {
+            std::cerr << "ERROR: Usuario " << user_id << " no encontrado en el dataset." << std::endl;
+            std::cerr << "Usuarios disponibles: ";
+        
+            std::set<int> available_users;
+            for (const auto& triplet : triplets) {
+                available_users.insert(triplet.user_id);
+            }
+        
+            int count = 0;
+            for (int uid : available_users) {
+                if (count++ < 10) {
+                    std::cerr << uid << " ";
+                }
+            }
+            if (available_users.size() > 10) {
+                std::cerr << "... (y " << (available_users.size() - 10) << " más)";
             }
+            std::cerr << std::endl;
+            return 1;
+        }
+        
+        // Índice de códigos del catálogo (el índice guarda una referencia al hasher)
+        if (!build_hasher(hasher_kind, store, lsh_bits, hasher)) {
+            return 1;
         }
-        if (available_users.size() > 10) {
-            std::cerr << "... (y " << (available_users.size() - 10) << " más)";
+        index.build(store);
+        
+        if (verbose) {
+            std::cout << "✓ Índice LSH: " << index.size() << " ítems, " 
+                      << index.memory_bytes() / 1024.0 << " KB" << std::endl;
         }
-        std::cerr << std::endl;
-        return 1;
+        
+        user_code = index.encode(store.copy_user_vector(user_id));
+        item_ids = index.get_item_ids().data();
+        item_codes = index.get_codes().data();
+        num_items = index.size();
     }
     
-    // Crear hasher LSH
-    SRPHasher hasher(dimensions, lsh_bits, 42);
+    // Índice multi-index hashing opcional sobre los mismos códigos
+    std::unique_ptr<MultiIndexHashing> mih;
+    if (retrieval == "mih") {
+        int substrings = MultiIndexHashing::suggested_substrings(lsh_bits, index.size());
+        mih.reset(new MultiIndexHashing(index, substrings));
+        mih->build();
+        if (verbose) {
+            mih->print_info();
+        }
+    }
     
     // Generar recomendaciones
-    std::cout << "Generando recomendaciones usando Hamming Ranking..." << std::endl;
-    auto recommendations = hamming_ranking_recommendations(user_id, store, hasher, movies, top_k, 
-                                                         genre_filter, year_start, year_end);
+    std::cout << "Generando recomendaciones usando Hamming Ranking"
+              << (mih ? " (multi-index hashing)" : "") << "..." << std::endl;
+    auto recommendations = hamming_ranking_recommendations(user_code, item_ids, item_codes, num_items, movies, top_k,
+                                                         genre_filter, year_start, year_end, mih.get());
     
     if (recommendations.empty()) {
         std::cout << "No se pudieron generar recomendaciones para el usuario " << user_id;
@@ -669,9 +823,32 @@ int generate_recommendations(int user_id, int top_k, int dimensions, int lsh_bit
     return 0;
 }
 
+// Copia al almacén los vectores entrenados de un modelo guardado para los ids que ambos
+// tienen (los demás conservan su vector aleatorio) y devuelve cuántas filas se copiaron
+int load_model_vectors(const MappedModel& model, UserItemStore& store) {
+    const int d = store.get_dimensions();
+    int copied = 0;
+    for (int row = 0; row < store.num_users(); ++row) {
+        int model_row = model.user_row(store.get_user_ids()[row]);
+        if (model_row < 0) continue;
+        std::copy(model.user_data(model_row), model.user_data(model_row) + d, store.user_data(row));
+        ++copied;
+    }
+    for (int row = 0; row < store.num_items(); ++row) {
+        int model_row = model.item_row(store.get_item_ids()[row]);
+        if (model_row < 0) continue;
+        std::copy(model.item_data(model_row), model.item_data(model_row) + d, store.item_data(row));
+        ++copied;
+    }
+    store.recompute_norms();
+    return copied;
+}
+
 // Función para evaluar el modelo
 int evaluate_model(const std::string& data_file, const std::string& val_file,
-                  const std::string& movies_file, int dimensions, int lsh_bits, bool verbose) {
+                  const std::string& movies_file, int dimensions, int lsh_bits,
+                  const std::string& diagnostics_file, Precision precision,
+                  ModelHasher hasher_kind, const std::string& model_file, bool verbose) {
     
     std::cout << "=== EVALUANDO MODELO SRPR ===" << std::endl;
     std::cout << std::endl;
@@ -691,10 +868,28 @@ int evaluate_model(const std::string& data_file, const std::string& val_file,
         return 1;
     }
     
+    // Modelo entrenado (--model): sus dimensiones y bits reemplazan a los de la línea de comandos
+    MappedModel model;
+    if (!model_file.empty()) {
+        std::string error;
+        if (!model.open(model_file, &error)) {
+            std::cerr << "ERROR: No se pudo cargar el modelo " << model_file << ": " << error << std::endl;
+            return 1;
+        }
+        dimensions = model.get_dimensions();
+        lsh_bits = model.get_num_bits();
+    }
+    
     // Inicializar sistema
-    UserItemStore store(dimensions);
+    UserItemStore store(dimensions, StorageLayout::Dense);
     store.initialize(training_triplets);
     
+    if (model.is_open()) {
+        int copied = load_model_vectors(model, store);
+        std::cout << "✓ Vectores entrenados de " << model_file << ": " << copied << " de "
+                  << (store.num_users() + store.num_items()) << " filas" << std::endl;
+    }
+    
     if (verbose) {
         store.print_summary();
     }
@@ -723,11 +918,18 @@ int evaluate_model(const std::string& data_file, const std::string& val_file,
                   << (val_precision * 100) << "%" << std::endl;
     }
     
-    // Evaluación LSH
-    std::cout << "\nEvaluando sistema LSH..." << std::endl;
-    SRPHasher hasher(dimensions, lsh_bits, 42);
+    // Evaluación LSH. Con --model, las proyecciones guardadas: el diagnóstico y la comparación
+    // de precisión se hacen con los mismos códigos que sirve --recommend
+    if (model.is_open()) {
+        hasher_kind = model.get_hasher();
+    }
+    std::cout << "\nEvaluando sistema LSH (hasher " << model_hasher_name(hasher_kind) << ")..." << std::endl;
+    SRPHasher hasher = model.is_open() ? model.make_hasher() : SRPHasher(dimensions, lsh_bits, std::vector<double>());
+    if (!model.is_open() && !build_hasher(hasher_kind, store, lsh_bits, hasher)) {
+        return 1;
+    }
     
-    // Generar códigos para todos los vectores
+    // Códigos de todos los vectores con el kernel por lotes y diagnóstico de su distribución
     std::set<int> unique_users, unique_items;
     for (const auto& triplet : training_triplets) {
         unique_users.insert(triplet.user_id);
@@ -735,30 +937,90 @@ int evaluate_model(const std::string& data_file, const std::string& val_file,
         unique_items.insert(triplet.less_preferred_item_id);
     }
     
-    std::set<std::string> unique_codes;
-    for (int user_id : unique_users) {
-        try {
-            const Vector& vec = store.get_user_vector(user_id);
-            std::string code = hasher.generate_code(vec);
-            unique_codes.insert(code);
-        } catch (const std::exception& e) {
-            continue;
-        }
+    // Prefijos de k bits para la ocupación de buckets (k <= bits del código)
+    std::vector<int> prefix_bits;
+    for (int k = 4; k <= std::min(lsh_bits, 24); k += 4) {
+        prefix_bits.push_back(k);
     }
     
-    for (int item_id : unique_items) {
-        try {
-            const Vector& vec = store.get_item_vector(item_id);
-            std::string code = hasher.generate_code(vec);
-            unique_codes.insert(code);
-        } catch (const std::exception& e) {
-            continue;
+    // El almacén contiene exactamente los ids de las tripletas de entrenamiento: en double se
+    // hashea la matriz densa en el lugar; en float/bf16/int8 se hashea una copia reducida, como la
+    // que se serviría (el entrenamiento sigue en double)
+    size_t double_bytes = 0, reduced_bytes = 0;
+    long long differing_bits = 0, compared_bits = 0;
+    auto hash_rows = [&](bool users, Precision p) {
+        const int n = users ? store.num_users() : store.num_items();
+        const double* matrix = users ? store.user_matrix() : store.item_matrix();
+        std::vector<uint64_t> codes(static_cast<size_t>(n) * hasher.code_words());
+        if (p == Precision::Float) {
+            EmbeddingMatrix<float> reduced = EmbeddingMatrix<float>::from_doubles(matrix, n, dimensions, store.row_stride());
+            hasher.hash_batch(reduced.data(), n, reduced.stride(), codes.data());
+            reduced_bytes += reduced.memory_bytes();
+        } else if (p == Precision::BFloat16) {
+            EmbeddingMatrix<bfloat16> reduced = EmbeddingMatrix<bfloat16>::from_doubles(matrix, n, dimensions, store.row_stride());
+            hasher.hash_batch(reduced.data(), n, reduced.stride(), codes.data());
+            reduced_bytes += reduced.memory_bytes();
+        } else if (p == Precision::Int8) {
+            Int8Matrix reduced = Int8Matrix::from_doubles(matrix, n, dimensions, store.row_stride());
+            hasher.hash_batch(reduced.data(), n, reduced.stride(), codes.data());
+            reduced_bytes += reduced.memory_bytes();
+        } else {
+            hasher.hash_batch(matrix, n, store.row_stride(), codes.data());
+        }
+        return codes;
+    };
+    auto diagnose = [&](bool users) {
+        const int n = users ? store.num_users() : store.num_items();
+        std::vector<uint64_t> codes = hash_rows(users, precision);
+        if (precision != Precision::Double) {
+            // Bits que cambian respecto a los códigos de los vectores en double
+            std::vector<uint64_t> reference = hash_rows(users, Precision::Double);
+            for (size_t w = 0; w < codes.size(); ++w) {
+                differing_bits += popcount64(codes[w] ^ reference[w]);
+            }
+            compared_bits += static_cast<long long>(n) * lsh_bits;
+            double_bytes += static_cast<size_t>(n) * store.row_stride() * sizeof(double);
         }
+        return CodeDiagnostics::analyze(codes.data(), n, lsh_bits, prefix_bits);
+    };
+    
+    auto diagnostics_start = std::chrono::high_resolution_clock::now();
+    CodeDiagnostics item_diagnostics = diagnose(false);
+    CodeDiagnostics user_diagnostics = diagnose(true);
+    auto diagnostics_end = std::chrono::high_resolution_clock::now();
+    
+    if (precision != Precision::Double) {
+        std::cout << "✓ Embeddings en " << precision_name(precision) << ": " << (reduced_bytes / 1024)
+                  << " KB (vs " << (double_bytes / 1024) << " KB en double)" << std::endl;
+        std::cout << "✓ Bits de código idénticos a double: " << std::fixed << std::setprecision(3)
+                  << (compared_bits > 0 ? 100.0 * (compared_bits - differing_bits) / compared_bits : 100.0)
+                  << "%" << std::endl;
     }
     
-    double diversity = (double)unique_codes.size() / (unique_users.size() + unique_items.size());
-    std::cout << "✓ Diversidad de códigos LSH: " << std::fixed << std::setprecision(3) 
+    double diversity = item_diagnostics.diversity();
+    std::cout << "✓ Diversidad de códigos LSH (ítems): " << std::fixed << std::setprecision(3) 
               << (diversity * 100) << "%" << std::endl;
+    if (verbose) {
+        std::cout << "\nÍtems - ";
+        item_diagnostics.print_summary();
+        std::cout << "\nUsuarios - ";
+        user_diagnostics.print_summary();
+        std::cout << "  (diagnóstico en " << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         diagnostics_end - diagnostics_start).count() << " ms)" << std::endl;
+    }
+    
+    if (!diagnostics_file.empty()) {
+        std::ofstream json(diagnostics_file);
+        if (!json.is_open()) {
+            std::cerr << "ERROR: No se pudo escribir " << diagnostics_file << std::endl;
+            return 1;
+        }
+        json << "{\"hasher\": \"" << model_hasher_name(hasher_kind) << "\", \"dimensions\": " << dimensions
+             << ", \"precision\": \"" << precision_name(precision) << "\""
+             << ", \"items\": " << item_diagnostics.to_json()
+             << ", \"users\": " << user_diagnostics.to_json() << "}" << std::endl;
+        std::cout << "✓ Diagnóstico de códigos guardado en " << diagnostics_file << std::endl;
+    }
     
     // Análisis por géneros si hay metadatos
     if (!movies.empty() && verbose) {
@@ -798,6 +1060,8 @@ int evaluate_model(const std::string& data_file, const std::string& val_file,
     std::cout << "📊 Bits LSH: " << lsh_bits << std::endl;
     std::cout << "📊 Diversidad códigos: " << std::fixed << std::setprecision(1) 
               << (diversity * 100) << "%" << std::endl;
+    std::cout << "📊 Entropía códigos (ítems): " << std::setprecision(2) << item_diagnostics.code_entropy
+              << " bits" << std::endl;
     
     return 0;
 }
@@ -821,6 +1085,12 @@ int main(int argc, char* argv[]) {
     double min_rating_diff = 1.0;
     std::string genre_filter = "";
     std::string year_range = "";
+    std::string retrieval = "linear";
+    std::string diagnostics_file = "";
+    std::string save_model_file = "";
+    std::string model_file = "";
+    Precision precision = Precision::Double;
+    ModelHasher hasher_kind = ModelHasherSRP;
     bool verbose = false;
     
     // Modos de operación
@@ -972,6 +1242,64 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
         }
+        else if (arg == "--retrieval") {
+            if (i + 1 < argc) {
+                retrieval = argv[++i];
+                if (retrieval != "linear" && retrieval != "mih") {
+                    std::cerr << "ERROR: --retrieval debe ser 'linear' o 'mih'" << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "ERROR: --retrieval requiere un modo (linear | mih)" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--diagnostics-json") {
+            if (i + 1 < argc) {
+                diagnostics_file = argv[++i];
+            } else {
+                std::cerr << "ERROR: --diagnostics-json requiere un archivo" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--precision") {
+            if (i + 1 < argc) {
+                if (!parse_precision(argv[++i], precision)) {
+                    std::cerr << "ERROR: --precision debe ser 'double', 'float', 'bf16' o 'int8'" << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "ERROR: --precision requiere un valor (double | float | bf16 | int8)" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--hasher") {
+            if (i + 1 < argc) {
+                if (!parse_model_hasher(argv[++i], hasher_kind)) {
+                    std::cerr << "ERROR: --hasher debe ser 'srp' o 'itq'" << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "ERROR: --hasher requiere un tipo (srp | itq)" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--save-model") {
+            if (i + 1 < argc) {
+                save_model_file = argv[++i];
+            } else {
+                std::cerr << "ERROR: --save-model requiere un archivo" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--model") {
+            if (i + 1 < argc) {
+                model_file = argv[++i];
+            } else {
+                std::cerr << "ERROR: --model requiere un archivo" << std::endl;
+                return 1;
+            }
+        }
         else if (arg == "--verbose") {
             verbose = true;
         }
@@ -1005,14 +1333,16 @@ int main(int argc, char* argv[]) {
         }
         else if (train_mode) {
             return train_model(data_file, val_file, epochs, learning_rate, 
-                             dimensions, lsh_bits, verbose);
+                             dimensions, lsh_bits, hasher_kind, save_model_file, verbose);
         }
         else if (recommend_mode) {
             return generate_recommendations(recommend_user_id, top_k, dimensions, 
-                                          lsh_bits, data_file, movies_file, genre_filter, year_range, verbose);
+                                          lsh_bits, data_file, movies_file, genre_filter, year_range, retrieval,
+                                          hasher_kind, model_file, verbose);
         }
         else if (evaluate_mode) {
-            return evaluate_model(data_file, val_file, movies_file, dimensions, lsh_bits, verbose);
+            return evaluate_model(data_file, val_file, movies_file, dimensions, lsh_bits, diagnostics_file, precision,
+                                  hasher_kind, model_file, verbose);
         }
     }
     catch (const std::exception& e) {
@@ -0,0 +1,172 @@
+#include "../include/BitSlicedCodeStore.h"
+#include "../include/TopK.h"
+#include "../include/SimdKernels.h"
+#include <algorithm>
+
+const int BitSlicedCodeStore::BLOCK_ITEMS;
+const int BitSlicedCodeStore::LANES;
+const int BitSlicedCodeStore::PRUNE_INTERVAL;
+
+// Distancia del ítem 'slot' (0..255) leída de los contadores
+static inline int counter_value(const uint64_t* counters, int counter_bits, int slot) {
+    const int lanes = BitSlicedCodeStore::LANES;
+    int lane = slot >> 6;
+    int shift = slot & 63;
+    int value = 0;
+    for (int c = 0; c < counter_bits; ++c) {
+        value |= static_cast<int>((counters[c * lanes + lane] >> shift) & 1ULL) << c;
+    }
+    return value;
+}
+
+// Ítems del bloque que aún pueden entrar en el top-k, por carril: mientras no esté lleno,
+// todas las filas válidas; si lo está, las de distancia (parcial) menor que el peor, porque
+// las filas de este bloque son posteriores a todas las retenidas y un empate no basta.
+// Devuelve false si no queda ninguno.
+static inline bool block_candidates(const SimdKernels& kernels, const BoundedTopK& top, const uint64_t* counters,
+                                    int counter_bits, int block_items, uint64_t* out) {
+    const int lanes = BitSlicedCodeStore::LANES;
+    if (top.full()) {
+        int threshold = static_cast<int>(-top.worst().second) - 1;
+        if (threshold < 0) return false;
+        kernels.bit_sliced_at_most(counters, counter_bits, threshold, out);
+    } else {
+        for (int l = 0; l < lanes; ++l) out[l] = ~0ULL;
+    }
+    uint64_t any = 0;
+    for (int l = 0; l < lanes; ++l) {
+        int valid = std::min(64, std::max(0, block_items - l * 64));
+        out[l] &= (valid == 64) ? ~0ULL : ((1ULL << valid) - 1);
+        any |= out[l];
+    }
+    return any != 0;
+}
+
+BitSlicedCodeStore::BitSlicedCodeStore(const LSHIndex& index)
+    : index(index), bits(index.get_num_bits()), counter_bits(1), num_blocks(0) {
+    while ((1 << counter_bits) <= bits) {
+        ++counter_bits;
+    }
+}
+
+bool BitSlicedCodeStore::is_accelerated() {
+    return SimdKernels::active().level() >= SimdLevel::AVX2;
+}
+
+void BitSlicedCodeStore::build() {
+    const int n = index.size();
+    num_blocks = (n + BLOCK_ITEMS - 1) / BLOCK_ITEMS;
+    planes.assign(static_cast<size_t>(num_blocks) * bits * LANES, 0ULL);
+
+    for (int row = 0; row < n; ++row) {
+        const uint64_t* code = index.code_at(row);
+        int block = row / BLOCK_ITEMS;
+        int slot = row % BLOCK_ITEMS;
+        uint64_t* block_base = planes.data() + static_cast<size_t>(block) * bits * LANES + (slot >> 6);
+        const uint64_t slot_bit = 1ULL << (slot & 63);
+
+        for (int j = 0; j < bits; ++j) {
+            if ((code[j >> 6] >> (j & 63)) & 1ULL) {
+                block_base[static_cast<size_t>(j) * LANES] |= slot_bit;
+            }
+        }
+    }
+}
+
+void BitSlicedCodeStore::update_rows(const std::vector<int>& rows) {
+    for (int row : rows) {
+        const uint64_t* code = index.code_at(row);
+        int block = row / BLOCK_ITEMS;
+        int slot = row % BLOCK_ITEMS;
+        uint64_t* block_base = planes.data() + static_cast<size_t>(block) * bits * LANES + (slot >> 6);
+        const int shift = slot & 63;
+
+        for (int j = 0; j < bits; ++j) {
+            uint64_t& plane_word = block_base[static_cast<size_t>(j) * LANES];
+            plane_word = (plane_word & ~(1ULL << shift)) | (((code[j >> 6] >> (j & 63)) & 1ULL) << shift);
+        }
+    }
+}
+
+void BitSlicedCodeStore::compute_block_distances(const PackedCode& query_code, int block, int* out) const {
+    std::vector<uint64_t> counters(static_cast<size_t>(counter_bits) * LANES, 0ULL);
+    std::vector<uint64_t> query_masks(bits);
+    for (int j = 0; j < bits; ++j) {
+        query_masks[j] = query_code.get_bit(j) ? ~0ULL : 0ULL;
+    }
+    const SimdKernels& kernels = SimdKernels::active();
+    const uint64_t* block_base = block_planes(block);
+    for (int j = 0; j < bits; j += PRUNE_INTERVAL) {
+        int count = std::min(PRUNE_INTERVAL, bits - j);
+        kernels.bit_sliced_accumulate(counters.data(), counter_bits, block_base + static_cast<size_t>(j) * LANES,
+                                      query_masks.data() + j, count);
+    }
+    for (int slot = 0; slot < BLOCK_ITEMS; ++slot) {
+        out[slot] = counter_value(counters.data(), counter_bits, slot);
+    }
+}
+
+std::vector<std::pair<int, int>> BitSlicedCodeStore::search(const PackedCode& query_code, int top_k,
+                                                            int* blocks_pruned) const {
+    std::vector<std::pair<int, int>> results;
+    if (blocks_pruned) *blocks_pruned = 0;
+    const int n = size();
+    if (n == 0 || top_k <= 0 || query_code.num_bits != bits || num_blocks == 0) {
+        return results;
+    }
+
+    std::vector<uint64_t> query_masks(bits);
+    for (int j = 0; j < bits; ++j) {
+        query_masks[j] = query_code.get_bit(j) ? ~0ULL : 0ULL;
+    }
+
+    // Top-k de menor distancia: puntaje = -distancia, empates por fila menor (igual que el sort)
+    BoundedTopK top(top_k);
+    const SimdKernels& kernels = SimdKernels::active();
+    std::vector<uint64_t> counters(static_cast<size_t>(counter_bits) * LANES);
+    uint64_t candidates[LANES];
+
+    for (int block = 0; block < num_blocks; ++block) {
+        const int first_row = block * BLOCK_ITEMS;
+        const int block_items = std::min(BLOCK_ITEMS, n - first_row);
+        const uint64_t* block_base = block_planes(block);
+        std::fill(counters.begin(), counters.end(), 0ULL);
+
+        bool pruned = false;
+        for (int j = 0; j < bits; j += PRUNE_INTERVAL) {
+            int count = std::min(PRUNE_INTERVAL, bits - j);
+            kernels.bit_sliced_accumulate(counters.data(), counter_bits,
+                                          block_base + static_cast<size_t>(j) * LANES, query_masks.data() + j, count);
+
+            // Tras j + count planos ningún contador pasa de j + count: hasta superar al peor
+            // retenido no se puede podar nada
+            if (top.full() && j + count < bits && j + count >= -top.worst().second &&
+                !block_candidates(kernels, top, counters.data(), counter_bits, block_items, candidates)) {
+                pruned = true;
+                break;
+            }
+        }
+
+        if (pruned) {
+            if (blocks_pruned) ++*blocks_pruned;
+            continue;
+        }
+
+        // Sólo se leen y se ofrecen al top-k los ítems de la máscara de candidatos
+        if (!block_candidates(kernels, top, counters.data(), counter_bits, block_items, candidates)) continue;
+        for (int l = 0; l < LANES; ++l) {
+            for (uint64_t mask = candidates[l]; mask != 0; mask &= mask - 1) {
+                int slot = l * 64 + count_trailing_zeros64(mask);
+                int distance = counter_value(counters.data(), counter_bits, slot);
+                top.push(first_row + slot, -static_cast<double>(distance));
+            }
+        }
+    }
+
+    std::vector<BoundedTopK::Entry> ranked = top.sorted();
+    results.reserve(ranked.size());
+    for (const auto& entry : ranked) {
+        results.emplace_back(index.item_id_at(entry.first), static_cast<int>(-entry.second));
+    }
+    return results;
+}
@@ -0,0 +1,238 @@
+#include "../include/CodeDiagnostics.h"
+#include "../include/PackedCode.h"
+#include "../include/SimdKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+// Entropía (bits) de una partición de n elementos en grupos de los tamaños dados
+static double partition_entropy(const std::vector<long long>& sizes, long long n) {
+    double entropy = 0.0;
+    for (long long size : sizes) {
+        double p = static_cast<double>(size) / n;
+        entropy -= p * std::log2(p);
+    }
+    return entropy;
+}
+
+CodeDiagnostics CodeDiagnostics::analyze(const uint64_t* codes, int n, int num_bits,
+                                         const std::vector<int>& prefix_bits) {
+    if (num_bits <= 0) {
+        throw std::invalid_argument("CodeDiagnostics: num_bits debe ser > 0");
+    }
+
+    CodeDiagnostics result;
+    result.num_codes = std::max(n, 0);
+    result.num_bits = num_bits;
+    result.bit_balance.assign(num_bits, 0.0);
+    result.bit_correlation.assign(static_cast<size_t>(num_bits) * num_bits, 0.0);
+    for (int i = 0; i < num_bits; ++i) {
+        result.bit_correlation[static_cast<size_t>(i) * num_bits + i] = 1.0;
+    }
+    if (n <= 0) return result;
+
+    const int words = code_words_for_bits(num_bits);
+
+    // Planos de bits: plano i = bit i de los n códigos. Se rellena hasta múltiplo de 8
+    // palabras (ceros) para que el escaneo use el kernel AVX-512 cuando exista.
+    const int plane_words = (code_words_for_bits(n) + 7) / 8 * 8;
+    std::vector<uint64_t> planes(static_cast<size_t>(num_bits) * plane_words, 0ULL);
+    for (int row = 0; row < n; ++row) {
+        const uint64_t* code = codes + static_cast<size_t>(row) * words;
+        const uint64_t row_bit = 1ULL << (row & 63);
+        uint64_t* column = planes.data() + (row >> 6);
+        for (int i = 0; i < num_bits; ++i) {
+            if ((code[i >> 6] >> (i & 63)) & 1ULL) {
+                column[static_cast<size_t>(i) * plane_words] |= row_bit;
+            }
+        }
+    }
+
+    // Balance por bit
+    std::vector<long long> ones(num_bits, 0);
+    double imbalance_sum = 0.0;
+    for (int i = 0; i < num_bits; ++i) {
+        const uint64_t* plane = planes.data() + static_cast<size_t>(i) * plane_words;
+        for (int w = 0; w < plane_words; ++w) ones[i] += popcount64(plane[w]);
+        result.bit_balance[i] = static_cast<double>(ones[i]) / n;
+        double imbalance = std::fabs(result.bit_balance[i] - 0.5);
+        imbalance_sum += imbalance;
+        result.max_bit_imbalance = std::max(result.max_bit_imbalance, imbalance);
+    }
+    result.mean_bit_imbalance = imbalance_sum / num_bits;
+
+    // Correlaciones: n11(i, j) = (|i| + |j| - H(i, j)) / 2 con un escaneo por plano
+    HammingScanKernel scan = SimdKernels::active().hamming_scan(plane_words);
+    std::vector<int> distances(num_bits);
+    double abs_sum = 0.0;
+    for (int i = 0; i + 1 < num_bits; ++i) {
+        const int others = num_bits - i - 1;
+        const uint64_t* plane_i = planes.data() + static_cast<size_t>(i) * plane_words;
+        scan(plane_i, plane_i + plane_words, others, plane_words, distances.data());
+
+        for (int k = 0; k < others; ++k) {
+            const int j = i + 1 + k;
+            const double both = (ones[i] + ones[j] - distances[k]) / 2.0;
+            const double variance = static_cast<double>(ones[i]) * (n - ones[i]) *
+                                    static_cast<double>(ones[j]) * (n - ones[j]);
+            const double phi = (variance > 0.0)
+                ? (static_cast<double>(n) * both - static_cast<double>(ones[i]) * ones[j]) / std::sqrt(variance)
+                : 0.0;
+            result.bit_correlation[static_cast<size_t>(i) * num_bits + j] = phi;
+            result.bit_correlation[static_cast<size_t>(j) * num_bits + i] = phi;
+
+            abs_sum += std::fabs(phi);
+            if (std::fabs(phi) > result.max_abs_correlation) {
+                result.max_abs_correlation = std::fabs(phi);
+                result.max_correlation_pair[0] = i;
+                result.max_correlation_pair[1] = j;
+            }
+        }
+    }
+    if (num_bits > 1) {
+        result.mean_abs_correlation = abs_sum / (static_cast<double>(num_bits) * (num_bits - 1) / 2.0);
+    }
+
+    // Ocupación de buckets por prefijo
+    std::vector<int> valid_prefixes;
+    for (int bits : prefix_bits) {
+        if (bits > 0 && bits <= std::min(num_bits, 64)) valid_prefixes.push_back(bits);
+    }
+    std::sort(valid_prefixes.begin(), valid_prefixes.end());
+    valid_prefixes.erase(std::unique(valid_prefixes.begin(), valid_prefixes.end()), valid_prefixes.end());
+
+    std::vector<uint64_t> keys(n);
+    std::vector<long long> sizes;
+    for (int bits : valid_prefixes) {
+        for (int row = 0; row < n; ++row) {
+            keys[row] = extract_bits(codes + static_cast<size_t>(row) * words, 0, bits);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        sizes.clear();
+        for (int start = 0; start < n;) {
+            int end = start + 1;
+            while (end < n && keys[end] == keys[start]) ++end;
+            sizes.push_back(end - start);
+            start = end;
+        }
+
+        PrefixOccupancy occupancy;
+        occupancy.bits = bits;
+        occupancy.occupied_buckets = static_cast<long long>(sizes.size());
+        double squares = 0.0;
+        for (long long size : sizes) {
+            occupancy.max_bucket_size = std::max(occupancy.max_bucket_size, size);
+            squares += static_cast<double>(size) * size;
+            int bin = 0;
+            while ((2LL << bin) <= size) ++bin;
+            if (static_cast<int>(occupancy.size_histogram.size()) <= bin) {
+                occupancy.size_histogram.resize(bin + 1, 0);
+            }
+            ++occupancy.size_histogram[bin];
+        }
+        occupancy.expected_candidates = squares / n;
+        occupancy.entropy = partition_entropy(sizes, n);
+        result.prefixes.push_back(occupancy);
+    }
+
+    // Códigos completos: orden lexicográfico por palabras y longitud de cada grupo
+    std::vector<int> order(n);
+    for (int row = 0; row < n; ++row) order[row] = row;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const uint64_t* ca = codes + static_cast<size_t>(a) * words;
+        const uint64_t* cb = codes + static_cast<size_t>(b) * words;
+        return std::lexicographical_compare(ca, ca + words, cb, cb + words);
+    });
+    sizes.clear();
+    for (int start = 0; start < n;) {
+        const uint64_t* first = codes + static_cast<size_t>(order[start]) * words;
+        int end = start + 1;
+        while (end < n && std::equal(first, first + words, codes + static_cast<size_t>(order[end]) * words)) ++end;
+        sizes.push_back(end - start);
+        start = end;
+    }
+    result.unique_codes = static_cast<long long>(sizes.size());
+    result.code_entropy = partition_entropy(sizes, n);
+
+    return result;
+}
+
+std::string CodeDiagnostics::to_json(bool include_matrix) const {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(6);
+    json << "{\"num_codes\": " << num_codes
+         << ", \"num_bits\": " << num_bits
+         << ", \"unique_codes\": " << unique_codes
+         << ", \"diversity\": " << diversity()
+         << ", \"code_entropy\": " << code_entropy;
+
+    json << ", \"bit_balance\": [";
+    for (int i = 0; i < num_bits; ++i) {
+        json << (i > 0 ? ", " : "") << bit_balance[i];
+    }
+    json << "], \"max_bit_imbalance\": " << max_bit_imbalance
+         << ", \"mean_bit_imbalance\": " << mean_bit_imbalance;
+
+    json << ", \"correlation\": {\"mean_abs\": " << mean_abs_correlation
+         << ", \"max_abs\": " << max_abs_correlation
+         << ", \"max_pair\": [" << max_correlation_pair[0] << ", " << max_correlation_pair[1] << "]";
+    if (include_matrix) {
+        json << ", \"matrix\": [";
+        for (int i = 0; i < num_bits; ++i) {
+            json << (i > 0 ? ", [" : "[");
+            for (int j = 0; j < num_bits; ++j) {
+                json << (j > 0 ? ", " : "") << bit_correlation[static_cast<size_t>(i) * num_bits + j];
+            }
+            json << "]";
+        }
+        json << "]";
+    }
+    json << "}";
+
+    json << ", \"prefixes\": [";
+    for (size_t p = 0; p < prefixes.size(); ++p) {
+        const PrefixOccupancy& occupancy = prefixes[p];
+        json << (p > 0 ? ", " : "")
+             << "{\"bits\": " << occupancy.bits
+             << ", \"occupied_buckets\": " << occupancy.occupied_buckets
+             << ", \"max_bucket_size\": " << occupancy.max_bucket_size
+             << ", \"expected_candidates\": " << occupancy.expected_candidates
+             << ", \"entropy\": " << occupancy.entropy
+             << ", \"size_histogram\": [";
+        for (size_t j = 0; j < occupancy.size_histogram.size(); ++j) {
+            json << (j > 0 ? ", " : "") << occupancy.size_histogram[j];
+        }
+        json << "]}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+void CodeDiagnostics::print_summary() const {
+    std::cout << "Diagnóstico de códigos (" << num_codes << " códigos de " << num_bits << " bits):" << std::endl;
+    std::cout << "  - Códigos distintos: " << unique_codes << " (" << std::fixed << std::setprecision(1)
+              << diversity() * 100.0 << "%), entropía " << std::setprecision(2) << code_entropy << " bits" << std::endl;
+    std::cout << "  - Desbalance de bits |p - 0.5|: medio " << std::setprecision(3) << mean_bit_imbalance
+              << ", máximo " << max_bit_imbalance << std::endl;
+    std::cout << "  - Correlación |phi| entre bits: media " << mean_abs_correlation
+              << ", máxima " << max_abs_correlation;
+    if (max_correlation_pair[0] >= 0) {
+        std::cout << " (bits " << max_correlation_pair[0] << " y " << max_correlation_pair[1] << ")";
+    }
+    std::cout << std::endl;
+
+    if (prefixes.empty()) return;
+    std::cout << "  Prefijo | Buckets ocupados | Máx. bucket | Candidatos esp. | Entropía (bits)" << std::endl;
+    for (const PrefixOccupancy& occupancy : prefixes) {
+        std::cout << "  " << std::setw(7) << occupancy.bits
+                  << " | " << std::setw(16) << occupancy.occupied_buckets
+                  << " | " << std::setw(11) << occupancy.max_bucket_size
+                  << " | " << std::setw(15) << std::setprecision(1) << occupancy.expected_candidates
+                  << " | " << std::setw(6) << std::setprecision(2) << occupancy.entropy
+                  << " / " << occupancy.bits << std::endl;
+    }
+}
@@ -4,15 +4,228 @@
 #include <cmath>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "../include/SimdKernels.h"
+#include "../include/ITQHasher.h"
 
-ExhaustiveBenchmark::ExhaustiveBenchmark(UserItemStore& store, SRPHasher& hasher)
-    : store(store), hasher(hasher) {
+ExhaustiveBenchmark::ExhaustiveBenchmark(UserItemStore& store, LSH& hasher)
+    : store(store), hasher(hasher), item_index(hasher), scan_precision(Precision::Double),
+      scan_rerank_factor(4) {
     // Configuración por defecto
     config.top_k = 10;
     config.num_test_users = 50;
     config.measure_similarity_correlation = true;
     config.generate_charts = true;
     config.save_detailed_results = false;
+    
+    // Hashear el catálogo una sola vez
+    item_index.build(store);
+}
+
+void ExhaustiveBenchmark::rebuild_index() {
+    item_index.build(store);
+    fill_scan_copy();
+    if (bucket_index) {
+        bucket_index->build(store);
+    }
+    if (mih_index) {
+        mih_index->build();
+    }
+    if (sliced_index) {
+        sliced_index->build();
+    }
+}
+
+int ExhaustiveBenchmark::refresh_index() {
+    const std::vector<int>& dirty = store.get_dirty_items();
+    if (dirty.empty()) return 0;
+
+    std::vector<int> rows;
+    rows.reserve(dirty.size());
+    for (int item_id : dirty) {
+        int row = item_index.row_of(item_id);
+        if (row < 0) {
+            // El catálogo cambió: no hay filas que actualizar en el lugar
+            rebuild_index();
+            store.clear_dirty_items();
+            return item_index.size();
+        }
+        rows.push_back(row);
+    }
+
+    // MIH necesita las claves anteriores para mover las filas de bucket
+    std::vector<uint64_t> previous_codes;
+    if (mih_index) {
+        const int words = item_index.get_code_words();
+        previous_codes.reserve(rows.size() * words);
+        for (int row : rows) {
+            previous_codes.insert(previous_codes.end(), item_index.code_at(row), item_index.code_at(row) + words);
+        }
+    }
+
+    item_index.refresh(store, dirty);
+    if (bucket_index) {
+        bucket_index->refresh(store, dirty);
+    }
+    if (mih_index) {
+        mih_index->update_rows(rows, previous_codes);
+    }
+    if (sliced_index) {
+        sliced_index->update_rows(rows);
+    }
+    if (scan_precision != Precision::Double) {
+        for (int item_id : dirty) {
+            fill_scan_row(store.item_row(item_id));
+        }
+    }
+
+    store.clear_dirty_items();
+    return static_cast<int>(rows.size());
+}
+
+void ExhaustiveBenchmark::set_scan_precision(Precision precision, int rerank_factor) {
+    scan_precision = precision;
+    scan_rerank_factor = std::max(1, rerank_factor);
+    fill_scan_copy();
+}
+
+size_t ExhaustiveBenchmark::scan_memory_bytes() const {
+    switch (scan_precision) {
+        case Precision::Float:    return scan_items_f32.memory_bytes();
+        case Precision::BFloat16: return scan_items_bf16.memory_bytes();
+        case Precision::Int8:     return scan_items_int8.memory_bytes();
+        case Precision::Double:   break;
+    }
+    return static_cast<size_t>(store.num_items()) * store.row_stride() * sizeof(double);
+}
+
+void ExhaustiveBenchmark::fill_scan_copy() {
+    scan_items_f32 = EmbeddingMatrix<float>();
+    scan_items_bf16 = EmbeddingMatrix<bfloat16>();
+    scan_items_int8 = Int8Matrix();
+    if (scan_precision == Precision::Float) {
+        scan_items_f32 = EmbeddingMatrix<float>(store.num_items(), store.get_dimensions());
+    } else if (scan_precision == Precision::BFloat16) {
+        scan_items_bf16 = EmbeddingMatrix<bfloat16>(store.num_items(), store.get_dimensions());
+    } else if (scan_precision == Precision::Int8) {
+        scan_items_int8 = Int8Matrix(store.num_items(), store.get_dimensions());
+    } else {
+        return;
+    }
+    for (int row = 0; row < store.num_items(); ++row) {
+        fill_scan_row(row);
+    }
+}
+
+void ExhaustiveBenchmark::fill_scan_row(int row) {
+    const double norm = store.item_norm(row);
+    const double scale = norm > 0.0 ? 1.0 / norm : 0.0;
+    if (scan_precision == Precision::Float) {
+        scan_items_f32.set_row(row, store.item_data(row), scale);
+    } else if (scan_precision == Precision::BFloat16) {
+        scan_items_bf16.set_row(row, store.item_data(row), scale);
+    } else if (scan_precision == Precision::Int8) {
+        scan_items_int8.set_row(row, store.item_data(row), scale);
+    }
+}
+
+void ExhaustiveBenchmark::build_bucket_index(int num_tables, int bits_per_table, unsigned int seed) {
+    bucket_index.reset(new LSHBucketIndex(hasher.get_dimensions(), num_tables, bits_per_table, seed));
+    bucket_index->build(store);
+}
+
+void ExhaustiveBenchmark::build_mih_index(int num_substrings) {
+    if (num_substrings <= 0) {
+        num_substrings = MultiIndexHashing::suggested_substrings(item_index.get_num_bits(), item_index.size());
+    }
+    mih_index.reset(new MultiIndexHashing(item_index, num_substrings));
+    mih_index->build();
+}
+
+void ExhaustiveBenchmark::build_bit_sliced_index() {
+    sliced_index.reset(new BitSlicedCodeStore(item_index));
+    sliced_index->build();
+}
+
+void ExhaustiveBenchmark::build_prefix_cascade(const std::vector<int>& prefix_bits, const std::vector<int>& survivors) {
+    item_index.build_prefix_cascade(prefix_bits);
+    cascade_survivors = survivors;
+}
+
+// Fila de un id en el almacén; lanza std::out_of_range si no existe
+static int user_row_of(const UserItemStore& store, int user_id) {
+    int row = store.user_row(user_id);
+    if (row < 0) throw std::out_of_range("usuario " + std::to_string(user_id) + " no existe en el almacén");
+    return row;
+}
+
+static int item_row_of(const UserItemStore& store, int item_id) {
+    int row = store.item_row(item_id);
+    if (row < 0) throw std::out_of_range("ítem " + std::to_string(item_id) + " no existe en el almacén");
+    return row;
+}
+
+static const double* item_data_of(const UserItemStore& store, int item_id) {
+    return store.item_data(item_row_of(store, item_id));
+}
+
+void ExhaustiveBenchmark::scan_item_rows(const double* user_vector, double user_norm, int begin, int end,
+                                         BoundedTopK& top) const {
+    const std::vector<int>& item_ids = store.get_item_ids();
+    if (scan_precision == Precision::Double || user_norm == 0.0) {
+        for (int row = begin; row < end; ++row) {
+            top.push(item_ids[row], cosine_to_item_row(user_vector, user_norm, row));
+        }
+        return;
+    }
+    
+    const int d = store.get_dimensions();
+    const SimdKernels& simd = SimdKernels::active();
+    if (scan_precision == Precision::Int8) {
+        // Consulta normalizada y cuantizada: el coseno aproximado es q_u·q_i · escala_u · escala_i,
+        // y escala_u es común a todas las filas (no cambia el orden). Se retienen
+        // rerank_factor·k candidatos (id = fila) y se re-evalúan con el coseno exacto.
+        std::vector<int8_t> query(d);
+        Int8Matrix::quantize(user_vector, d, 1.0 / user_norm, query.data());
+        BoundedTopK candidates(top.max_size() * scan_rerank_factor);
+        for (int row = begin; row < end; ++row) {
+            candidates.push(row, static_cast<double>(simd.dot(scan_items_int8.row(row), query.data(), d)) *
+                                 scan_items_int8.scale(row));
+        }
+        for (const BoundedTopK::Entry& candidate : candidates.sorted()) {
+            top.push(item_ids[candidate.first], cosine_to_item_row(user_vector, user_norm, candidate.first));
+        }
+        return;
+    }
+    
+    // Consulta normalizada en float: el coseno es un solo producto punto por fila
+    std::vector<float> query(d);
+    for (int k = 0; k < d; ++k) {
+        query[k] = static_cast<float>(user_vector[k] / user_norm);
+    }
+    if (scan_precision == Precision::Float) {
+        for (int row = begin; row < end; ++row) {
+            top.push(item_ids[row], simd.dot(scan_items_f32.row(row), query.data(), d));
+        }
+    } else {
+        for (int row = begin; row < end; ++row) {
+            top.push(item_ids[row], simd.dot(scan_items_bf16.row(row), query.data(), d));
+        }
+    }
+}
+
+double ExhaustiveBenchmark::cosine_to_item_row(const double* user_vector, double user_norm, int row) const {
+    if (user_norm == 0.0) return 0.0;
+    const int d = store.get_dimensions();
+    if (store.has_normalized_items()) {
+        return SimdKernels::active().dot(user_vector, store.normalized_item_data(row), d) / user_norm;
+    }
+    const double item_norm = store.item_norm(row);
+    if (item_norm == 0.0) return 0.0;
+    return SimdKernels::active().dot(user_vector, store.item_data(row), d) / (user_norm * item_norm);
 }
 
 // === BÚSQUEDA EXHAUSTIVA ===
@@ -26,39 +239,107 @@ std::vector<RecommendationResult> ExhaustiveBenchmark::exhaustive_search(
     std::vector<RecommendationResult> results;
     
     try {
-        const Vector& user_vector = store.get_user_vector(user_id);
-        const auto& all_items = store.get_all_item_vectors();
+        const int user_row = user_row_of(store, user_id);
         
-        // Vector para almacenar similitudes
-        std::vector<std::pair<int, double>> item_similarities;
-        item_similarities.reserve(all_items.size());
+        // Calcular similitud coseno con TODOS los items (O(n×d), un producto punto por ítem
+        // con las normas cacheadas), reteniendo sólo los k mejores en un heap acotado
+        // (O(n log k), sin ordenar las n similitudes)
+        BoundedTopK top(top_k);
+        scan_item_rows(store.user_data(user_row), store.user_norm(user_row), 0, store.num_items(), top);
         
-        // Calcular similitud coseno con TODOS los items (O(n×d))
-        for (const auto& item_pair : all_items) {
-            int item_id = item_pair.first;
-            const Vector& item_vector = item_pair.second;
-            
-            double similarity = cosine_similarity(user_vector, item_vector);
-            item_similarities.emplace_back(item_id, similarity);
+        results = top_k_to_results(top);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error en búsqueda exhaustiva para usuario " << user_id 
+                  << ": " << e.what() << std::endl;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    retrieval_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    return results;
+}
+
+std::vector<RecommendationResult> ExhaustiveBenchmark::exhaustive_mips_search(
+    int user_id,
+    int top_k,
+    std::chrono::microseconds& retrieval_time) const {
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<RecommendationResult> results;
+    
+    try {
+        const double* user_vector = store.user_data(user_row_of(store, user_id));
+        const std::vector<int>& item_ids = store.get_item_ids();
+        const int d = store.get_dimensions();
+        
+        BoundedTopK top(top_k);
+        for (int row = 0; row < static_cast<int>(item_ids.size()); ++row) {
+            double dot = SimdKernels::active().dot(user_vector, store.item_data(row), d);
+            top.push(item_ids[row], dot);
         }
         
-        // Ordenar por similitud descendente
-        std::sort(item_similarities.begin(), item_similarities.end(),
-                  [](const auto& a, const auto& b) { return a.second > b.second; });
+        results = top_k_to_results(top);
         
-        // Tomar top-k
-        int k = std::min(top_k, static_cast<int>(item_similarities.size()));
-        for (int i = 0; i < k; ++i) {
-            results.emplace_back(
-                item_similarities[i].first,  // item_id
-                item_similarities[i].second, // score (similitud coseno)
-                -1,                          // hamming_distance (no aplica)
-                i + 1                        // rank
-            );
+    } catch (const std::exception& e) {
+        std::cerr << "Error en búsqueda MIPS exhaustiva para usuario " << user_id
+                  << ": " << e.what() << std::endl;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    retrieval_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    return results;
+}
+
+std::vector<RecommendationResult> ExhaustiveBenchmark::exhaustive_search_parallel(
+    int user_id,
+    int top_k,
+    std::chrono::microseconds& retrieval_time,
+    int num_threads) const {
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<RecommendationResult> results;
+    
+    try {
+        const int user_row = user_row_of(store, user_id);
+        const double* user_vector = store.user_data(user_row);
+        const double user_norm = store.user_norm(user_row);
+        const std::vector<int>& item_ids = store.get_item_ids();
+        
+        if (num_threads <= 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
         }
         
+        // Las filas del almacén se parten directamente en rangos contiguos
+        int n = static_cast<int>(item_ids.size());
+        num_threads = std::max(1, std::min(num_threads, n));
+        
+        // Un top-k acotado por hilo sobre un rango contiguo; se fusionan al final
+        std::vector<BoundedTopK> partial(num_threads, BoundedTopK(top_k));
+        std::vector<std::thread> workers;
+        int chunk = (n + num_threads - 1) / num_threads;
+        for (int t = 0; t < num_threads; ++t) {
+            int begin = t * chunk;
+            int end = std::min(n, begin + chunk);
+            workers.emplace_back([this, user_vector, user_norm, &partial, t, begin, end]() {
+                scan_item_rows(user_vector, user_norm, begin, end, partial[t]);
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        
+        BoundedTopK top(top_k);
+        for (const BoundedTopK& thread_top : partial) {
+            top.merge(thread_top);
+        }
+        results = top_k_to_results(top);
+        
     } catch (const std::exception& e) {
-        std::cerr << "Error en búsqueda exhaustiva para usuario " << user_id 
+        std::cerr << "Error en búsqueda exhaustiva paralela para usuario " << user_id 
                   << ": " << e.what() << std::endl;
     }
     
@@ -68,6 +349,21 @@ std::vector<RecommendationResult> ExhaustiveBenchmark::exhaustive_search(
     return results;
 }
 
+std::vector<RecommendationResult> ExhaustiveBenchmark::top_k_to_results(const BoundedTopK& top) const {
+    std::vector<RecommendationResult> results;
+    std::vector<BoundedTopK::Entry> ranked = top.sorted();
+    results.reserve(ranked.size());
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        results.emplace_back(
+            ranked[i].first,                 // item_id
+            ranked[i].second,                // score (similitud coseno)
+            -1,                              // hamming_distance (no aplica)
+            static_cast<int>(i) + 1          // rank
+        );
+    }
+    return results;
+}
+
 // === BÚSQUEDA LSH ===
 std::vector<RecommendationResult> ExhaustiveBenchmark::lsh_search(
     int user_id, 
@@ -79,46 +375,202 @@ std::vector<RecommendationResult> ExhaustiveBenchmark::lsh_search(
     std::vector<RecommendationResult> results;
     
     try {
-        const Vector& user_vector = store.get_user_vector(user_id);
-        std::string user_code = hasher.generate_code(user_vector);
+        Vector user_vector = store.copy_user_vector(user_id);
+        
+        // Sólo se hashea el usuario; los códigos de los ítems ya están en el índice
+        std::vector<std::pair<int, int>> item_distances = hamming_ranking(user_vector, top_k);
+        results = convert_lsh_ranking(item_distances, user_id);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error en búsqueda LSH para usuario " << user_id 
+                  << ": " << e.what() << std::endl;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    retrieval_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    return results;
+}
+
+std::vector<std::pair<int, int>> ExhaustiveBenchmark::hamming_ranking(const Vector& user_vector, int count) const {
+    // Sólo se hashea el usuario; los códigos de los ítems ya están en el índice
+    PackedCode user_code = item_index.encode(user_vector);
+    if (item_index.has_prefix_cascade()) {
+        return item_index.cascade_search(user_code, count, cascade_survivors);
+    }
+    if (sliced_index && BitSlicedCodeStore::is_accelerated()) {
+        return sliced_index->search(user_code, count);
+    }
+    return item_index.search(user_code, count);
+}
+
+// === PIPELINE DE DOS ETAPAS (TOP-C HAMMING + RE-RANKING EXACTO) ===
+std::vector<RecommendationResult> ExhaustiveBenchmark::rerank_search(
+    int user_id,
+    int top_k,
+    int num_candidates,
+    std::chrono::microseconds& retrieval_time,
+    RerankMetric metric) const {
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<RecommendationResult> results;
+    
+    try {
+        const int user_row = user_row_of(store, user_id);
+        Vector user_vector = store.copy_user_vector(user_id);
+        const double user_norm = store.user_norm(user_row);
+        const int d = store.get_dimensions();
         
-        const auto& all_items = store.get_all_item_vectors();
+        // Etapa 1: top-C por distancia Hamming
+        std::vector<std::pair<int, int>> candidates = hamming_ranking(user_vector, std::max(top_k, num_candidates));
         
-        // Vector para almacenar distancias Hamming
-        std::vector<std::pair<int, int>> item_distances;
-        item_distances.reserve(all_items.size());
+        // Etapa 2: similitud exacta sólo de los C candidatos
+        BoundedTopK top(top_k);
+        std::unordered_map<int, int> distances;
+        distances.reserve(candidates.size());
+        for (const auto& item_distance : candidates) {
+            const int item_row = item_row_of(store, item_distance.first);
+            double score = (metric == RerankMetric::Cosine)
+                ? cosine_to_item_row(user_vector.data(), user_norm, item_row)
+                : SimdKernels::active().dot(user_vector.data(), store.item_data(item_row), d);
+            top.push(item_distance.first, score);
+            distances[item_distance.first] = item_distance.second;
+        }
         
-        // Calcular distancia Hamming con TODOS los items (O(n×b))
-        for (const auto& item_pair : all_items) {
-            int item_id = item_pair.first;
-            const Vector& item_vector = item_pair.second;
-            
-            std::string item_code = hasher.generate_code(item_vector);
-            int distance = hamming_distance(user_code, item_code);
-            item_distances.emplace_back(item_id, distance);
+        results = top_k_to_results(top);
+        for (RecommendationResult& result : results) {
+            result.hamming_distance = distances[result.item_id];
+        }
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error en búsqueda con re-ranking para usuario " << user_id
+                  << ": " << e.what() << std::endl;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    retrieval_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    return results;
+}
+
+// === BÚSQUEDA POR MULTI-INDEX HASHING ===
+std::vector<RecommendationResult> ExhaustiveBenchmark::mih_search(
+    int user_id,
+    int top_k,
+    std::chrono::microseconds& retrieval_time,
+    int* num_candidates) const {
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<RecommendationResult> results;
+    if (num_candidates) *num_candidates = 0;
+    
+    try {
+        if (!mih_index) {
+            throw std::runtime_error("índice multi-index hashing no construido (usar build_mih_index)");
+        }
+        
+        // Mismo código de usuario que lsh_search; k-NN exacto sin recorrer todo el índice
+        PackedCode user_code = item_index.encode(store.copy_user_vector(user_id));
+        std::vector<std::pair<int, int>> item_distances = mih_index->search(
+            user_code, top_k, MultiIndexHashing::ItemFilter(), num_candidates);
+        results = convert_lsh_ranking(item_distances, user_id);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error en búsqueda multi-index hashing para usuario " << user_id 
+                  << ": " << e.what() << std::endl;
+    }
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    retrieval_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    return results;
+}
+
+std::vector<RecommendationResult> ExhaustiveBenchmark::convert_lsh_ranking(
+    const std::vector<std::pair<int, int>>& lsh_results,
+    int /*user_id*/) const {
+    
+    std::vector<RecommendationResult> results;
+    results.reserve(lsh_results.size());
+    for (size_t i = 0; i < lsh_results.size(); ++i) {
+        // Convertir distancia Hamming a score de similitud
+        int hamming_dist = lsh_results[i].second;
+        double similarity_score = 1.0 - (static_cast<double>(hamming_dist) / hasher.get_num_hashes());
+        
+        results.emplace_back(
+            lsh_results[i].first,        // item_id
+            similarity_score,            // score (similitud aproximada)
+            hamming_dist,                // hamming_distance
+            static_cast<int>(i) + 1      // rank
+        );
+    }
+    return results;
+}
+
+// === BÚSQUEDA POR TABLAS HASH ===
+std::vector<RecommendationResult> ExhaustiveBenchmark::bucket_search(
+    int user_id,
+    int top_k,
+    std::chrono::microseconds& retrieval_time,
+    int* num_candidates) const {
+    
+    return bucket_search(user_id, top_k, config.bucket_probes, config.bucket_probe_strategy,
+                         retrieval_time, num_candidates);
+}
+
+std::vector<RecommendationResult> ExhaustiveBenchmark::bucket_search(
+    int user_id,
+    int top_k,
+    int num_probes,
+    ProbeStrategy strategy,
+    std::chrono::microseconds& retrieval_time,
+    int* num_candidates) const {
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::vector<RecommendationResult> results;
+    if (num_candidates) *num_candidates = 0;
+    
+    try {
+        if (!bucket_index) {
+            throw std::runtime_error("índice por tablas hash no construido (usar build_bucket_index)");
         }
         
-        // Ordenar por distancia Hamming ascendente (menor distancia = mayor similitud)
-        std::sort(item_distances.begin(), item_distances.end(),
-                  [](const auto& a, const auto& b) { return a.second < b.second; });
+        const int user_row = user_row_of(store, user_id);
+        Vector user_vector = store.copy_user_vector(user_id);
+        const double user_norm = store.user_norm(user_row);
+        
+        // Candidatos: unión de los buckets visitados (exacto + vecinos) en las L tablas
+        std::vector<int> candidates = bucket_index->query_candidates(user_vector, num_probes, strategy);
+        if (num_candidates) *num_candidates = static_cast<int>(candidates.size());
+        
+        // Re-evaluación exacta sólo sobre los candidatos
+        std::vector<std::pair<int, double>> item_similarities;
+        item_similarities.reserve(candidates.size());
+        for (int item_id : candidates) {
+            double similarity = cosine_to_item_row(user_vector.data(), user_norm, item_row_of(store, item_id));
+            item_similarities.emplace_back(item_id, similarity);
+        }
+        
+        int k = std::min(top_k, static_cast<int>(item_similarities.size()));
+        std::partial_sort(item_similarities.begin(), item_similarities.begin() + k, item_similarities.end(),
+                          [](const std::pair<int, double>& a, const std::pair<int, double>& b) { 
+                              return a.second > b.second; 
+                          });
         
-        // Tomar top-k
-        int k = std::min(top_k, static_cast<int>(item_distances.size()));
         for (int i = 0; i < k; ++i) {
-            // Convertir distancia Hamming a score de similitud
-            int hamming_dist = item_distances[i].second;
-            double similarity_score = 1.0 - (static_cast<double>(hamming_dist) / hasher.get_num_hashes());
-            
             results.emplace_back(
-                item_distances[i].first,  // item_id
-                similarity_score,         // score (similitud aproximada)
-                hamming_dist,            // hamming_distance
-                i + 1                    // rank
+                item_similarities[i].first,  // item_id
+                item_similarities[i].second, // score (similitud coseno exacta)
+                -1,                          // hamming_distance (no aplica)
+                i + 1                        // rank
             );
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "Error en búsqueda LSH para usuario " << user_id 
+        std::cerr << "Error en búsqueda por tablas hash para usuario " << user_id 
                   << ": " << e.what() << std::endl;
     }
     
@@ -141,12 +593,28 @@ PerformanceComparison ExhaustiveBenchmark::benchmark_methods(
     
     std::vector<EvaluationMetrics> exhaustive_results;
     std::vector<EvaluationMetrics> lsh_results;
+    std::vector<EvaluationMetrics> bucket_results;
+    long long total_bucket_candidates = 0;
+    std::vector<EvaluationMetrics> mih_results;
+    long long total_mih_candidates = 0;
+    std::vector<std::vector<EvaluationMetrics>> rerank_results(config.candidate_sizes.size());
     
     if (verbose) {
         std::cout << "\n" << std::string(80, '=') << std::endl;
         std::cout << "BENCHMARK EXHAUSTIVO vs LSH" << std::endl;
         std::cout << "Usuarios a evaluar: " << test_users.size() << std::endl;
         std::cout << "Top-K: " << top_k << std::endl;
+        std::cout << "Kernels SIMD: " << SimdKernels::active().description() << std::endl;
+        if (item_index.has_prefix_cascade()) {
+            std::vector<int> prefix_bits = item_index.get_prefix_bits();
+            std::cout << "Cascada de prefijos:";
+            for (size_t s = 0; s < prefix_bits.size(); ++s) {
+                std::cout << " " << prefix_bits[s] << " bits ("
+                          << (s < cascade_survivors.size() && cascade_survivors[s] > 0 ? cascade_survivors[s] : item_index.size())
+                          << " filas) →";
+            }
+            std::cout << " " << item_index.get_num_bits() << " bits" << std::endl;
+        }
         std::cout << std::string(80, '=') << std::endl;
     }
     
@@ -183,11 +651,65 @@ PerformanceComparison ExhaustiveBenchmark::benchmark_methods(
         
         exhaustive_results.push_back(ex_metrics);
         lsh_results.push_back(lsh_metrics);
+        
+        // Búsqueda por tablas hash (si el índice está construido)
+        if (bucket_index) {
+            std::chrono::microseconds bucket_time;
+            int candidates = 0;
+            auto bucket_recs = bucket_search(user_id, top_k, bucket_time, &candidates);
+            total_bucket_candidates += candidates;
+            bucket_results.push_back(evaluate_recommendations(bucket_recs, ground_truth, bucket_time.count() / 1000.0));
+        }
+        
+        // Multi-index hashing (mismo ranking que LSH, sin recorrer todo el catálogo)
+        if (mih_index) {
+            std::chrono::microseconds mih_time;
+            int candidates = 0;
+            auto mih_recs = mih_search(user_id, top_k, mih_time, &candidates);
+            total_mih_candidates += candidates;
+            mih_results.push_back(evaluate_recommendations(mih_recs, ground_truth, mih_time.count() / 1000.0));
+        }
+        
+        // Curva del pipeline de dos etapas: un punto por tamaño de candidatos C
+        if (!config.candidate_sizes.empty()) {
+            std::set<int> rerank_truth = ground_truth;
+            if (config.rerank_metric == RerankMetric::DotProduct) {
+                std::chrono::microseconds mips_time;
+                rerank_truth.clear();
+                for (const auto& rec : exhaustive_mips_search(user_id, top_k, mips_time)) {
+                    rerank_truth.insert(rec.item_id);
+                }
+            }
+            for (size_t c = 0; c < config.candidate_sizes.size(); ++c) {
+                std::chrono::microseconds rerank_time;
+                auto rerank_recs = rerank_search(user_id, top_k, config.candidate_sizes[c], rerank_time,
+                                                 config.rerank_metric);
+                rerank_results[c].push_back(evaluate_recommendations(rerank_recs, rerank_truth,
+                                                                     rerank_time.count() / 1000.0));
+            }
+        }
     }
     
     // Agregar métricas promedio
     comparison.exhaustive_metrics = aggregate_metrics(exhaustive_results);
     comparison.lsh_metrics = aggregate_metrics(lsh_results);
+    if (!bucket_results.empty()) {
+        comparison.bucket_metrics = aggregate_metrics(bucket_results);
+        comparison.has_bucket_metrics = true;
+        comparison.avg_bucket_candidates = static_cast<double>(total_bucket_candidates) / bucket_results.size();
+    }
+    if (!mih_results.empty()) {
+        comparison.mih_metrics = aggregate_metrics(mih_results);
+        comparison.has_mih_metrics = true;
+        comparison.avg_mih_candidates = static_cast<double>(total_mih_candidates) / mih_results.size();
+    }
+    for (size_t c = 0; c < rerank_results.size(); ++c) {
+        if (rerank_results[c].empty()) continue;
+        RerankPoint point;
+        point.num_candidates = config.candidate_sizes[c];
+        point.metrics = aggregate_metrics(rerank_results[c]);
+        comparison.rerank_curve.push_back(point);
+    }
     
     // Calcular comparaciones
     comparison.speedup_factor = comparison.exhaustive_metrics.avg_retrieval_time_ms / 
@@ -334,11 +856,16 @@ double ExhaustiveBenchmark::calculate_map(
 
 double ExhaustiveBenchmark::cosine_similarity(const Vector& v1, const Vector& v2) const {
     if (v1.size() != v2.size()) return 0.0;
+    return cosine_similarity(v1.data(), v2.data(), static_cast<int>(v1.size()));
+}
+
+double ExhaustiveBenchmark::cosine_similarity(const double* v1, const double* v2, int n) const {
+    // Productos punto con el kernel SIMD elegido al arrancar (ver SimdKernels.h)
+    const SimdKernels& simd = SimdKernels::active();
+    double dot_product = simd.dot(v1, v2, n);
     
-    double dot_product = std::inner_product(v1.begin(), v1.end(), v2.begin(), 0.0);
-    
-    double norm1 = std::sqrt(std::inner_product(v1.begin(), v1.end(), v1.begin(), 0.0));
-    double norm2 = std::sqrt(std::inner_product(v2.begin(), v2.end(), v2.begin(), 0.0));
+    double norm1 = std::sqrt(simd.dot(v1, v1, n));
+    double norm2 = std::sqrt(simd.dot(v2, v2, n));
     
     if (norm1 == 0.0 || norm2 == 0.0) return 0.0;
     
@@ -357,6 +884,10 @@ int ExhaustiveBenchmark::hamming_distance(const std::string& code1, const std::s
     return distance;
 }
 
+int ExhaustiveBenchmark::hamming_distance(const PackedCode& code1, const PackedCode& code2) const {
+    return ::hamming_distance(code1, code2);
+}
+
 // === ANÁLISIS DE ESCALABILIDAD ===
 
 void ExhaustiveBenchmark::scalability_analysis(
@@ -394,32 +925,217 @@ void ExhaustiveBenchmark::scalability_analysis(
 void ExhaustiveBenchmark::lsh_configuration_analysis(
     const std::vector<int>& lsh_bits,
     const std::vector<int>& test_users,
-    int top_k) const {
+    int top_k,
+    const std::vector<int>& probe_budgets) const {
     
     std::cout << "\n" << std::string(80, '=') << std::endl;
     std::cout << "ANÁLISIS DE CONFIGURACIÓN LSH" << std::endl;
     std::cout << std::string(80, '=') << std::endl;
     
-    std::cout << "LSH Bits | Time (ms) | Precision | Recall | NDCG" << std::endl;
-    std::cout << std::string(50, '-') << std::endl;
+    if (test_users.empty()) return;
+    
+    // Ground truth exhaustivo (una vez) y matriz contigua del catálogo para hash_batch
+    std::vector<std::set<int>> truths;
+    for (int user_id : test_users) {
+        std::chrono::microseconds dummy_time;
+        std::set<int> truth;
+        for (const auto& rec : exhaustive_search(user_id, top_k, dummy_time)) {
+            truth.insert(rec.item_id);
+        }
+        truths.push_back(truth);
+    }
+    
+    const int dimensions = hasher.get_dimensions();
+    const std::vector<int>& item_ids = item_index.get_item_ids();
+    const int n = static_cast<int>(item_ids.size());
+    std::vector<double> catalog(static_cast<size_t>(n) * dimensions);
+    for (int row = 0; row < n; ++row) {
+        const double* item_vector = item_data_of(store, item_ids[row]);
+        std::copy(item_vector, item_vector + dimensions, catalog.begin() + static_cast<size_t>(row) * dimensions);
+    }
+    
+    std::cout << "LSH Bits | Hasher    | Hash (Mvec/s) | Recall@K | Query (ms)" << std::endl;
+    std::cout << std::string(62, '-') << std::endl;
     
     for (int bits : lsh_bits) {
-        // Note: Aquí necesitaríamos crear nuevos hashers con diferentes bits
-        // Por simplicidad, reportamos el actual
-        std::vector<int> limited_users = test_users;
-        if (limited_users.size() > 10) {
-            limited_users.resize(10);
+        SRPHasher dense(dimensions, bits, 42);
+        PhiloxSRPHasher philox(dimensions, bits, 42);
+        SparseSRPHasher sparse(dimensions, bits, 42);
+        FastHadamardHasher hadamard(dimensions, bits, 42);
+        std::vector<std::pair<const char*, const LSH*>> candidates = {
+            {"SRP denso", &dense}, {"Philox", &philox}, {"disperso", &sparse}, {"Hadamard", &hadamard}
+        };
+        
+        // Proyecciones aprendidas del catálogo (sólo si b <= d)
+        ITQHasher itq(dimensions, bits);
+        if (itq.fit(catalog.data(), n, dimensions, 50, 42)) {
+            candidates.emplace_back("ITQ", &itq);
         }
         
-        auto comparison = benchmark_methods(limited_users, top_k, false);
+        for (const auto& candidate : candidates) {
+            const LSH& candidate_hasher = *candidate.second;
+            
+            // Throughput: hashear todo el catálogo con el kernel por lotes
+            std::vector<uint64_t> codes(static_cast<size_t>(n) * candidate_hasher.code_words());
+            auto hash_start = std::chrono::high_resolution_clock::now();
+            candidate_hasher.hash_batch(catalog.data(), n, dimensions, codes.data());
+            auto hash_end = std::chrono::high_resolution_clock::now();
+            double hash_seconds = std::chrono::duration<double>(hash_end - hash_start).count();
+            
+            // Recall del ranking Hamming contra el exhaustivo
+            LSHIndex index(candidate_hasher);
+            index.build(store);
+            double recall_sum = 0.0;
+            auto query_start = std::chrono::high_resolution_clock::now();
+            for (size_t u = 0; u < test_users.size(); ++u) {
+                auto ranking = index.search(store.copy_user_vector(test_users[u]), top_k);
+                int hits = 0;
+                for (const auto& item_distance : ranking) {
+                    hits += static_cast<int>(truths[u].count(item_distance.first));
+                }
+                if (!truths[u].empty()) {
+                    recall_sum += static_cast<double>(hits) / truths[u].size();
+                }
+            }
+            auto query_end = std::chrono::high_resolution_clock::now();
+            
+            double users = static_cast<double>(test_users.size());
+            std::cout << std::setw(8) << bits
+                      << " | " << std::setw(9) << candidate.first
+                      << " | " << std::setw(13) << std::fixed << std::setprecision(2)
+                      << (hash_seconds > 0.0 ? n / hash_seconds / 1e6 : 0.0)
+                      << " | " << std::setw(8) << std::setprecision(3) << recall_sum / users
+                      << " | " << std::setw(10) 
+                      << std::chrono::duration<double, std::milli>(query_end - query_start).count() / users
+                      << std::endl;
+        }
+    }
+    
+    if (probe_budgets.empty() || !bucket_index) return;
+    
+    // Multi-probe: recall@K respecto al exhaustivo vs buckets visitados por tabla
+    std::cout << "\nMulti-probe (L=" << bucket_index->get_num_tables()
+              << ", k=" << bucket_index->get_bits_per_table() << ")" << std::endl;
+    std::cout << "Probes | Estrategia | Recall@K | Candidatos | Time (ms)" << std::endl;
+    std::cout << std::string(58, '-') << std::endl;
+    
+    for (int probes : probe_budgets) {
+        for (ProbeStrategy strategy : {ProbeStrategy::HammingRadius, ProbeStrategy::ProjectionMargin}) {
+            double recall_sum = 0.0, candidate_sum = 0.0, time_ms = 0.0;
+            for (size_t u = 0; u < test_users.size(); ++u) {
+                std::chrono::microseconds bucket_time;
+                int candidates = 0;
+                auto recs = bucket_search(test_users[u], top_k, probes, strategy, bucket_time, &candidates);
+                recall_sum += calculate_recall_at_k(recs, truths[u], top_k);
+                candidate_sum += candidates;
+                time_ms += bucket_time.count() / 1000.0;
+            }
+            
+            double users = static_cast<double>(test_users.size());
+            std::cout << std::setw(6) << probes
+                      << " | " << std::setw(10) << (strategy == ProbeStrategy::HammingRadius ? "hamming" : "margen")
+                      << " | " << std::setw(8) << std::fixed << std::setprecision(3) << recall_sum / users
+                      << " | " << std::setw(10) << std::setprecision(1) << candidate_sum / users
+                      << " | " << std::setw(9) << std::setprecision(3) << time_ms / users
+                      << std::endl;
+        }
+    }
+}
+
+void ExhaustiveBenchmark::mips_analysis(
+    const std::vector<int>& lsh_bits,
+    const std::vector<int>& test_users,
+    int top_k,
+    int rerank_factor) const {
+    
+    std::cout << "\n" << std::string(80, '=') << std::endl;
+    std::cout << "ANÁLISIS MIPS: SRP COSENO vs SIMPLE-ALSH" << std::endl;
+    std::cout << std::string(80, '=') << std::endl;
+    
+    if (test_users.empty() || item_index.empty()) return;
+    
+    // Ground truth por producto interno (una vez)
+    std::vector<std::set<int>> truths;
+    for (int user_id : test_users) {
+        std::chrono::microseconds dummy_time;
+        std::set<int> truth;
+        for (const auto& rec : exhaustive_mips_search(user_id, top_k, dummy_time)) {
+            truth.insert(rec.item_id);
+        }
+        truths.push_back(truth);
+    }
+    
+    // Norma máxima del catálogo (M de Simple-ALSH)
+    double max_norm = 0.0;
+    for (int row = 0; row < store.num_items(); ++row) {
+        max_norm = std::max(max_norm, store.item_norm(row));
+    }
+    
+    const int dimensions = hasher.get_dimensions();
+    const int candidates_per_query = std::max(top_k, top_k * rerank_factor);
+    std::cout << "Norma máxima de ítems (M): " << std::fixed << std::setprecision(4) << max_norm << std::endl;
+    std::cout << "LSH Bits | Hasher      | Recall@K | Recall@K (re-rank " << candidates_per_query
+              << ") | Candidatos MIH | Query (ms)" << std::endl;
+    std::cout << std::string(86, '-') << std::endl;
+    
+    for (int bits : lsh_bits) {
+        SRPHasher cosine(dimensions, bits, 42);
+        SRPHasher projection(dimensions + 1, bits, 42);
+        SimpleALSHItemHasher alsh_items(projection, max_norm);
+        SimpleALSHQueryHasher alsh_queries(projection);
         
-        std::cout << std::setw(8) << bits 
-                  << " | " << std::setw(9) << std::fixed << std::setprecision(2)
-                  << comparison.lsh_metrics.avg_retrieval_time_ms
-                  << " | " << std::setw(9) << comparison.lsh_metrics.precision_at_k
-                  << " | " << std::setw(6) << comparison.lsh_metrics.recall_at_k
-                  << " | " << std::setw(4) << comparison.lsh_metrics.ndcg_at_k
-                  << std::endl;
+        LSHIndex cosine_index(cosine);
+        LSHIndex alsh_index(alsh_items, alsh_queries);
+        const std::pair<const char*, LSHIndex*> candidates[] = {
+            {"SRP coseno", &cosine_index}, {"Simple-ALSH", &alsh_index}
+        };
+        
+        for (const auto& candidate : candidates) {
+            LSHIndex& index = *candidate.second;
+            index.build(store);
+            MultiIndexHashing mih(index, MultiIndexHashing::suggested_substrings(bits, index.size()));
+            mih.build();
+            
+            double recall_sum = 0.0, rerank_recall_sum = 0.0, candidate_sum = 0.0, time_ms = 0.0;
+            for (size_t u = 0; u < test_users.size(); ++u) {
+                Vector user_vector = store.copy_user_vector(test_users[u]);
+                
+                auto query_start = std::chrono::high_resolution_clock::now();
+                int verified = 0;
+                auto ranking = mih.search(index.encode(user_vector), candidates_per_query,
+                                          MultiIndexHashing::ItemFilter(), &verified);
+                
+                // Re-ranking exacto por producto interno de los candidatos Hamming
+                BoundedTopK top(top_k);
+                for (const auto& item_distance : ranking) {
+                    top.push(item_distance.first,
+                             SimdKernels::active().dot(user_vector.data(), item_data_of(store, item_distance.first),
+                                                       static_cast<int>(user_vector.size())));
+                }
+                auto reranked = top_k_to_results(top);
+                auto query_end = std::chrono::high_resolution_clock::now();
+                
+                int hits = 0;
+                for (int i = 0; i < std::min(top_k, static_cast<int>(ranking.size())); ++i) {
+                    hits += static_cast<int>(truths[u].count(ranking[i].first));
+                }
+                if (!truths[u].empty()) {
+                    recall_sum += static_cast<double>(hits) / truths[u].size();
+                }
+                rerank_recall_sum += calculate_recall_at_k(reranked, truths[u], top_k);
+                candidate_sum += verified;
+                time_ms += std::chrono::duration<double, std::milli>(query_end - query_start).count();
+            }
+            
+            double users = static_cast<double>(test_users.size());
+            std::cout << std::setw(8) << bits
+                      << " | " << std::setw(11) << candidate.first
+                      << " | " << std::setw(8) << std::fixed << std::setprecision(3) << recall_sum / users
+                      << " | " << std::setw(22) << rerank_recall_sum / users
+                      << " | " << std::setw(14) << std::setprecision(1) << candidate_sum / users
+                      << " | " << std::setw(10) << std::setprecision(3) << time_ms / users
+                      << std::endl;
+        }
     }
 }
 
@@ -0,0 +1,282 @@
+#include "../include/ITQHasher.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <random>
+
+// Autodescomposición de una matriz simétrica n×n (por filas) con el método cíclico de
+// Jacobi. 'values' queda en orden descendente y 'vectors' (n×n por filas) tiene el
+// autovector k en la columna k. Para las matrices de este archivo (d×d y b×b) converge en
+// pocas barridas y es exacto hasta el redondeo.
+static void symmetric_eigen(std::vector<double> a, int n, std::vector<double>& values,
+                            std::vector<double>& vectors) {
+    std::vector<double> v(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; ++i) v[static_cast<size_t>(i) * n + i] = 1.0;
+
+    double total = 0.0;
+    for (double x : a) total += x * x;
+
+    for (int sweep = 0; sweep < 64; ++sweep) {
+        double off = 0.0;
+        for (int p = 0; p < n; ++p) {
+            for (int q = p + 1; q < n; ++q) off += a[static_cast<size_t>(p) * n + q] * a[static_cast<size_t>(p) * n + q];
+        }
+        if (off <= 1e-30 * total) break;
+
+        for (int p = 0; p < n; ++p) {
+            for (int q = p + 1; q < n; ++q) {
+                const double apq = a[static_cast<size_t>(p) * n + q];
+                if (apq == 0.0) continue;
+
+                // Rotación (c, s) que anula a[p][q]: A <- J^T A J, V <- V J
+                const double theta = (a[static_cast<size_t>(q) * n + q] - a[static_cast<size_t>(p) * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+
+                for (int k = 0; k < n; ++k) {
+                    double* row = a.data() + static_cast<size_t>(k) * n;
+                    const double akp = row[p], akq = row[q];
+                    row[p] = c * akp - s * akq;
+                    row[q] = s * akp + c * akq;
+                }
+                double* row_p = a.data() + static_cast<size_t>(p) * n;
+                double* row_q = a.data() + static_cast<size_t>(q) * n;
+                for (int k = 0; k < n; ++k) {
+                    const double apk = row_p[k], aqk = row_q[k];
+                    row_p[k] = c * apk - s * aqk;
+                    row_q[k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; ++k) {
+                    double* row = v.data() + static_cast<size_t>(k) * n;
+                    const double vkp = row[p], vkq = row[q];
+                    row[p] = c * vkp - s * vkq;
+                    row[q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    // Ordenar los pares (autovalor, autovector) de mayor a menor
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int x, int y) {
+        return a[static_cast<size_t>(x) * n + x] > a[static_cast<size_t>(y) * n + y];
+    });
+    values.resize(n);
+    vectors.assign(static_cast<size_t>(n) * n, 0.0);
+    for (int j = 0; j < n; ++j) {
+        values[j] = a[static_cast<size_t>(order[j]) * n + order[j]];
+        for (int k = 0; k < n; ++k) {
+            vectors[static_cast<size_t>(k) * n + j] = v[static_cast<size_t>(k) * n + order[j]];
+        }
+    }
+}
+
+// Factor ortogonal de la descomposición polar de M (n×n): R = M (M^T M)^(-1/2), la matriz
+// ortogonal más cercana a M, que maximiza tr(M^T R). Devuelve false si M es singular.
+static bool polar_orthogonal_factor(const std::vector<double>& m, int n, std::vector<double>& r) {
+    std::vector<double> mtm(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = i; j < n; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < n; ++k) sum += m[static_cast<size_t>(k) * n + i] * m[static_cast<size_t>(k) * n + j];
+            mtm[static_cast<size_t>(i) * n + j] = sum;
+            mtm[static_cast<size_t>(j) * n + i] = sum;
+        }
+    }
+
+    std::vector<double> values, vectors;
+    symmetric_eigen(mtm, n, values, vectors);
+    if (values.empty() || values[n - 1] <= 1e-12 * std::max(values[0], 1e-300)) return false;
+
+    // (M^T M)^(-1/2) = Q diag(1/sqrt(λ)) Q^T
+    std::vector<double> inv_sqrt(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < n; ++k) {
+                sum += vectors[static_cast<size_t>(i) * n + k] * vectors[static_cast<size_t>(j) * n + k] / std::sqrt(values[k]);
+            }
+            inv_sqrt[static_cast<size_t>(i) * n + j] = sum;
+        }
+    }
+
+    r.assign(static_cast<size_t>(n) * n, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int k = 0; k < n; ++k) {
+            const double mik = m[static_cast<size_t>(i) * n + k];
+            for (int j = 0; j < n; ++j) {
+                r[static_cast<size_t>(i) * n + j] += mik * inv_sqrt[static_cast<size_t>(k) * n + j];
+            }
+        }
+    }
+    return true;
+}
+
+// === Implementación de ITQHasher ===
+
+ITQHasher::ITQHasher(int dimensions, int num_hashes)
+    : LSH(dimensions, num_hashes), projection(dimensions, num_hashes, std::vector<double>()),
+      explained_energy(0.0) {}
+
+bool ITQHasher::fit(const UserItemStore& store, int iterations, unsigned int seed) {
+    if (store.get_dimensions() != d) {
+        return fit(nullptr, 0, d, iterations, seed);
+    }
+    const int n = store.num_items();
+    if (store.item_matrix()) {
+        return fit(store.item_matrix(), n, store.row_stride(), iterations, seed);
+    }
+
+    std::vector<double> data(static_cast<size_t>(n) * d);
+    for (int row = 0; row < n; ++row) {
+        std::copy(store.item_data(row), store.item_data(row) + d, data.begin() + static_cast<size_t>(row) * d);
+    }
+    return fit(data.data(), n, d, iterations, seed);
+}
+
+bool ITQHasher::fit(const double* vectors, int n, int stride, int iterations, unsigned int seed) {
+    projection = SRPHasher(d, b, std::vector<double>());
+    quantization_errors.clear();
+    explained_energy = 0.0;
+    if (d <= 0 || b <= 0 || b > d || n < b || stride < d || iterations < 0) {
+        return false;
+    }
+
+    // 1) PCA sin centrar: top-b autovectores de X^T X
+    std::vector<double> second_moment(static_cast<size_t>(d) * d, 0.0);
+    for (int row = 0; row < n; ++row) {
+        const double* x = vectors + static_cast<size_t>(row) * stride;
+        for (int i = 0; i < d; ++i) {
+            const double xi = x[i];
+            double* out = second_moment.data() + static_cast<size_t>(i) * d;
+            for (int j = i; j < d; ++j) out[j] += xi * x[j];
+        }
+    }
+    double energy = 0.0;
+    for (int i = 0; i < d; ++i) {
+        energy += second_moment[static_cast<size_t>(i) * d + i];
+        for (int j = 0; j < i; ++j) {
+            second_moment[static_cast<size_t>(i) * d + j] = second_moment[static_cast<size_t>(j) * d + i];
+        }
+    }
+
+    std::vector<double> eigenvalues, eigenvectors;
+    symmetric_eigen(second_moment, d, eigenvalues, eigenvectors);
+    double captured = 0.0;
+    for (int j = 0; j < b; ++j) captured += std::max(eigenvalues[j], 0.0);
+
+    // V = X P (n×b), P = primeras b columnas de 'eigenvectors'
+    std::vector<double> v(static_cast<size_t>(n) * b, 0.0);
+    for (int row = 0; row < n; ++row) {
+        const double* x = vectors + static_cast<size_t>(row) * stride;
+        double* out = v.data() + static_cast<size_t>(row) * b;
+        for (int k = 0; k < d; ++k) {
+            const double xk = x[k];
+            const double* p_row = eigenvectors.data() + static_cast<size_t>(k) * d;
+            for (int j = 0; j < b; ++j) out[j] += xk * p_row[j];
+        }
+    }
+
+    // 2) Rotación inicial aleatoria: gaussiana b×b ortonormalizada (Gram-Schmidt por columnas)
+    std::mt19937 rng;
+    if (seed == 0) {
+        rng.seed(std::random_device{}());
+    } else {
+        rng.seed(seed);
+    }
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<double> rotation(static_cast<size_t>(b) * b);
+    for (double& x : rotation) x = dist(rng);
+    for (int j = 0; j < b; ++j) {
+        for (int prev = 0; prev < j; ++prev) {
+            double dot = 0.0;
+            for (int i = 0; i < b; ++i) dot += rotation[static_cast<size_t>(i) * b + j] * rotation[static_cast<size_t>(i) * b + prev];
+            for (int i = 0; i < b; ++i) rotation[static_cast<size_t>(i) * b + j] -= dot * rotation[static_cast<size_t>(i) * b + prev];
+        }
+        double norm = 0.0;
+        for (int i = 0; i < b; ++i) norm += rotation[static_cast<size_t>(i) * b + j] * rotation[static_cast<size_t>(i) * b + j];
+        norm = std::sqrt(norm);
+        for (int i = 0; i < b; ++i) rotation[static_cast<size_t>(i) * b + j] /= norm;
+    }
+
+    // 3) Alternar B = sign(V R) y R = polar(V^T B)
+    std::vector<double> projected(b), cross(static_cast<size_t>(b) * b), next_rotation;
+    for (int iter = 0; iter <= iterations; ++iter) {
+        std::fill(cross.begin(), cross.end(), 0.0);
+        double error = 0.0;
+        for (int row = 0; row < n; ++row) {
+            const double* vr = v.data() + static_cast<size_t>(row) * b;
+            std::fill(projected.begin(), projected.end(), 0.0);
+            for (int k = 0; k < b; ++k) {
+                const double vk = vr[k];
+                const double* r_row = rotation.data() + static_cast<size_t>(k) * b;
+                for (int j = 0; j < b; ++j) projected[j] += vk * r_row[j];
+            }
+            for (int j = 0; j < b; ++j) {
+                const double sign = (projected[j] >= 0.0) ? 1.0 : -1.0;
+                error += (sign - projected[j]) * (sign - projected[j]);
+                projected[j] = sign;
+            }
+            // cross += v_row^T sign_row
+            for (int k = 0; k < b; ++k) {
+                const double vk = vr[k];
+                double* c_row = cross.data() + static_cast<size_t>(k) * b;
+                for (int j = 0; j < b; ++j) c_row[j] += vk * projected[j];
+            }
+        }
+        quantization_errors.push_back(error / n);
+
+        // La última pasada sólo mide el error de la rotación final
+        if (iter == iterations || !polar_orthogonal_factor(cross, b, next_rotation)) break;
+        rotation.swap(next_rotation);
+    }
+
+    // 4) Filas del hasher: w_i = (P R)[:, i]
+    std::vector<double> matrix(static_cast<size_t>(b) * d, 0.0);
+    for (int k = 0; k < d; ++k) {
+        const double* p_row = eigenvectors.data() + static_cast<size_t>(k) * d;
+        for (int i = 0; i < b; ++i) {
+            double sum = 0.0;
+            for (int j = 0; j < b; ++j) sum += p_row[j] * rotation[static_cast<size_t>(j) * b + i];
+            matrix[static_cast<size_t>(i) * d + k] = sum;
+        }
+    }
+
+    projection = SRPHasher(d, b, matrix);
+    explained_energy = (energy > 0.0) ? captured / energy : 0.0;
+    return projection.is_initialized();
+}
+
+void ITQHasher::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    projection.generate_packed_code(vec, out);
+}
+
+void ITQHasher::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    projection.hash_batch(vectors, n, stride, out_codes);
+}
+
+char ITQHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
+    if (!is_initialized() || hash_function_index < 0 || hash_function_index >= b ||
+        vec.size() != static_cast<size_t>(d)) {
+        return '0';
+    }
+    double value = std::inner_product(vec.begin(), vec.end(), projection_row(hash_function_index), 0.0);
+    return (value >= 0.0) ? '1' : '0';
+}
+
+void ITQHasher::print_hash_info() const {
+    std::cout << "ITQHasher Información:" << std::endl;
+    std::cout << "  - Dimensiones: " << d << std::endl;
+    std::cout << "  - Número de funciones hash: " << b << std::endl;
+    std::cout << "  - Inicializado: " << (is_initialized() ? "Sí" : "No") << std::endl;
+    if (!quantization_errors.empty()) {
+        std::cout << "  - Iteraciones: " << quantization_errors.size() - 1
+                  << ", error de cuantización " << std::fixed << std::setprecision(4)
+                  << quantization_errors.front() << " -> " << quantization_errors.back() << std::endl;
+        std::cout << "  - Energía capturada por " << b << " componentes: "
+                  << std::setprecision(1) << explained_energy * 100.0 << "%" << std::endl;
+    }
+}
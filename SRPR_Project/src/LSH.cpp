@@ -1,6 +1,15 @@
 #include "../include/LSH.h"
+#include "../include/Philox.h"
+#include "../include/FixedCode.h"
+#include "../include/SimdKernels.h"
 #include <iostream>
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+// Vectores por bloque en el kernel de hashing por lotes: el bucle interno recorre
+// ITEM_BLOCK ítems contiguos del bloque traspuesto y el compilador lo vectoriza.
+static const int HASH_ITEM_BLOCK = 32;
 
 // === Implementación de la clase base LSH ===
 
@@ -14,6 +23,36 @@ std::string LSH::generate_code(const Vector& vec) const {
     return code;
 }
 
+PackedCode LSH::generate_packed_code(const Vector& vec) const {
+    PackedCode code(b);
+    generate_packed_code(vec, code.words.data());
+    return code;
+}
+
+void LSH::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    int words = code_words();
+    for (int w = 0; w < words; ++w) {
+        out[w] = 0;
+    }
+    
+    for (int i = 0; i < b; ++i) {
+        if (hash_to_bit(vec, i) == '1') {
+            out[i >> 6] |= (1ULL << (i & 63));
+        }
+    }
+}
+
+void LSH::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    int words = code_words();
+    Vector row(d);
+    
+    for (int r = 0; r < n; ++r) {
+        std::copy(vectors + static_cast<size_t>(r) * stride, 
+                  vectors + static_cast<size_t>(r) * stride + d, row.begin());
+        generate_packed_code(row, out_codes + static_cast<size_t>(r) * words);
+    }
+}
+
 // === Implementación de SRPHasher ===
 
 SRPHasher::SRPHasher(int dimensions, int num_hashes, unsigned int seed) 
@@ -29,17 +68,27 @@ SRPHasher::SRPHasher(int dimensions, int num_hashes, unsigned int seed)
     
     std::normal_distribution<double> dist(0.0, 1.0);
 
-    random_vectors.resize(num_hashes);
+    // Mismo orden de muestreo que antes (fila i, columna j) para conservar los códigos por seed
+    projection_matrix.resize(static_cast<size_t>(num_hashes) * dimensions);
     for (int i = 0; i < num_hashes; ++i) {
-        random_vectors[i].resize(dimensions);
         for (int j = 0; j < dimensions; ++j) {
-            random_vectors[i][j] = dist(rng);
+            projection_matrix[static_cast<size_t>(i) * dimensions + j] = dist(rng);
         }
     }
     
+    projection_matrix_f32.assign(projection_matrix.begin(), projection_matrix.end());
     initialized = true;
 }
 
+SRPHasher::SRPHasher(int dimensions, int num_hashes, const std::vector<double>& matrix)
+    : LSH(dimensions, num_hashes), initialized(false) {
+    if (dimensions > 0 && num_hashes > 0 && matrix.size() == static_cast<size_t>(num_hashes) * dimensions) {
+        projection_matrix = matrix;
+        projection_matrix_f32.assign(projection_matrix.begin(), projection_matrix.end());
+        initialized = true;
+    }
+}
+
 char SRPHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
     // Verificaciones silenciosas para mayor eficiencia
     if (!initialized || hash_function_index < 0 || hash_function_index >= b || 
@@ -51,7 +100,7 @@ char SRPHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
     double projection = std::inner_product(
         vec.begin(), 
         vec.end(), 
-        random_vectors[hash_function_index].begin(), 
+        projection_row(hash_function_index), 
         0.0
     );
     
@@ -59,28 +108,191 @@ char SRPHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
     return (projection >= 0.0) ? '1' : '0';
 }
 
+// Kernels SRP con la longitud del código como parámetro de plantilla: con Bits > 0 los
+// bucles sobre funciones hash y palabras tienen cota constante y el compilador los
+// despliega; Bits = 0 es la versión genérica (cota b en ejecución). Los signos se
+// empaquetan sin saltos. Ambas variantes suman en el mismo orden: bits idénticos.
+template <int Bits>
+static void srp_encode_kernel(const double* matrix, int b, int d, const double* x, uint64_t* out) {
+    const int bits = (Bits > 0) ? Bits : b;
+    const int words = (bits + 63) / 64;
+    for (int w = 0; w < words; ++w) {
+        out[w] = 0;
+    }
+    
+    // Un solo vector: producto fila a fila sobre la matriz contigua (mismo orden de suma
+    // que el kernel por lotes, así ambos caminos producen bits idénticos)
+    for (int i = 0; i < bits; ++i) {
+        const double* a = matrix + static_cast<size_t>(i) * d;
+        double projection = 0.0;
+        for (int k = 0; k < d; ++k) {
+            projection += a[k] * x[k];
+        }
+        out[i >> 6] |= static_cast<uint64_t>(projection >= 0.0) << (i & 63);
+    }
+}
+
+// 'In' es el escalar de los vectores (double, float, bfloat16 o int8) y 'Acc' el de la proyección
+// y la acumulación (double, o float para los de menor precisión)
+template <int Bits, typename In, typename Acc>
+static void srp_hash_batch_kernel(const Acc* matrix, int b, int d, const In* vectors, int n, int stride,
+                                  uint64_t* out_codes) {
+    const int bits = (Bits > 0) ? Bits : b;
+    const int words = (bits + 63) / 64;
+    std::fill(out_codes, out_codes + static_cast<size_t>(n) * words, 0ULL);
+    
+    // Bloque traspuesto d × ITEM_BLOCK: la columna k contiene la coordenada k de cada ítem
+    std::vector<Acc> block_t(static_cast<size_t>(d) * HASH_ITEM_BLOCK);
+    Acc acc[HASH_ITEM_BLOCK];
+    
+    for (int item0 = 0; item0 < n; item0 += HASH_ITEM_BLOCK) {
+        const int nb = std::min(HASH_ITEM_BLOCK, n - item0);
+        
+        // Trasponer el bloque (las columnas sobrantes quedan en cero)
+        std::fill(block_t.begin(), block_t.end(), Acc(0));
+        for (int j = 0; j < nb; ++j) {
+            const In* x = vectors + static_cast<size_t>(item0 + j) * stride;
+            for (int k = 0; k < d; ++k) {
+                block_t[static_cast<size_t>(k) * HASH_ITEM_BLOCK + j] = to_accumulator(x[k]);
+            }
+        }
+        
+        // El bloque traspuesto (d × ITEM_BLOCK escalares) se queda en L1 y se reutiliza para
+        // las b funciones hash
+        for (int bit = 0; bit < bits; ++bit) {
+            const Acc* a_row = matrix + static_cast<size_t>(bit) * d;
+            for (int j = 0; j < HASH_ITEM_BLOCK; ++j) {
+                acc[j] = Acc(0);
+            }
+            
+            // acc[:] += a[bit][k] * bloque[k][:]  (bucle interno contiguo -> SIMD)
+            for (int k = 0; k < d; ++k) {
+                const Acc a = a_row[k];
+                const Acc* col = block_t.data() + static_cast<size_t>(k) * HASH_ITEM_BLOCK;
+                for (int j = 0; j < HASH_ITEM_BLOCK; ++j) {
+                    acc[j] += a * col[j];
+                }
+            }
+            
+            // Empaquetar signos: h(x) = 1 si a^T x >= 0
+            const int shift = bit & 63;
+            uint64_t* word = out_codes + static_cast<size_t>(item0) * words + (bit >> 6);
+            for (int j = 0; j < nb; ++j) {
+                word[static_cast<size_t>(j) * words] |= static_cast<uint64_t>(acc[j] >= Acc(0)) << shift;
+            }
+        }
+    }
+}
+
+void SRPHasher::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    if (!initialized || vec.size() != static_cast<size_t>(d)) {
+        // Igual que hash_to_bit: vector inválido -> todos los bits en '0'
+        std::fill(out, out + code_words(), 0ULL);
+        return;
+    }
+    
+    // Despacho a la instanciación que coincide con b (ver FixedCode.h)
+    const double* matrix = projection_matrix.data();
+    switch (b) {
+        case 16:  srp_encode_kernel<16>(matrix, b, d, vec.data(), out); break;
+        case 32:  srp_encode_kernel<32>(matrix, b, d, vec.data(), out); break;
+        case 64:  srp_encode_kernel<64>(matrix, b, d, vec.data(), out); break;
+        case 128: srp_encode_kernel<128>(matrix, b, d, vec.data(), out); break;
+        case 256: srp_encode_kernel<256>(matrix, b, d, vec.data(), out); break;
+        default:  srp_encode_kernel<0>(matrix, b, d, vec.data(), out); break;
+    }
+}
+
+void SRPHasher::project(const Vector& vec, double* out) const {
+    if (!initialized || vec.size() != static_cast<size_t>(d)) {
+        std::fill(out, out + b, 0.0);
+        return;
+    }
+    
+    const double* x = vec.data();
+    for (int i = 0; i < b; ++i) {
+        const double* a = projection_row(i);
+        double projection = 0.0;
+        for (int k = 0; k < d; ++k) {
+            projection += a[k] * x[k];
+        }
+        out[i] = projection;
+    }
+}
+
+// Elige la especialización por número de bits
+template <typename In, typename Acc>
+static void srp_hash_batch(const Acc* matrix, int b, int d, const In* vectors, int n, int stride,
+                           uint64_t* out_codes) {
+    switch (b) {
+        case 16:  srp_hash_batch_kernel<16>(matrix, b, d, vectors, n, stride, out_codes); break;
+        case 32:  srp_hash_batch_kernel<32>(matrix, b, d, vectors, n, stride, out_codes); break;
+        case 64:  srp_hash_batch_kernel<64>(matrix, b, d, vectors, n, stride, out_codes); break;
+        case 128: srp_hash_batch_kernel<128>(matrix, b, d, vectors, n, stride, out_codes); break;
+        case 256: srp_hash_batch_kernel<256>(matrix, b, d, vectors, n, stride, out_codes); break;
+        default:  srp_hash_batch_kernel<0>(matrix, b, d, vectors, n, stride, out_codes); break;
+    }
+}
+
+void SRPHasher::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    if (!initialized || n <= 0) {
+        std::fill(out_codes, out_codes + static_cast<size_t>(std::max(n, 0)) * code_words(), 0ULL);
+        return;
+    }
+    srp_hash_batch(projection_matrix.data(), b, d, vectors, n, stride, out_codes);
+}
+
+void SRPHasher::hash_batch(const float* vectors, int n, int stride, uint64_t* out_codes) const {
+    if (!initialized || n <= 0) {
+        std::fill(out_codes, out_codes + static_cast<size_t>(std::max(n, 0)) * code_words(), 0ULL);
+        return;
+    }
+    srp_hash_batch(projection_matrix_f32.data(), b, d, vectors, n, stride, out_codes);
+}
+
+void SRPHasher::hash_batch(const bfloat16* vectors, int n, int stride, uint64_t* out_codes) const {
+    if (!initialized || n <= 0) {
+        std::fill(out_codes, out_codes + static_cast<size_t>(std::max(n, 0)) * code_words(), 0ULL);
+        return;
+    }
+    srp_hash_batch(projection_matrix_f32.data(), b, d, vectors, n, stride, out_codes);
+}
+
+void SRPHasher::hash_batch(const int8_t* vectors, int n, int stride, uint64_t* out_codes) const {
+    if (!initialized || n <= 0) {
+        std::fill(out_codes, out_codes + static_cast<size_t>(std::max(n, 0)) * code_words(), 0ULL);
+        return;
+    }
+    srp_hash_batch(projection_matrix_f32.data(), b, d, vectors, n, stride, out_codes);
+}
+
 void SRPHasher::print_hash_info() const {
     std::cout << "SRPHasher Información:" << std::endl;
     std::cout << "  - Dimensiones: " << d << std::endl;
     std::cout << "  - Número de funciones hash: " << b << std::endl;
     std::cout << "  - Inicializado: " << (initialized ? "Sí" : "No") << std::endl;
+    std::cout << "  - Kernel de hashing: " << (has_fixed_code_kernels(b) ? "especializado" : "genérico")
+              << " (" << b << " bits)" << std::endl;
+    std::cout << "  - Kernels SIMD: " << SimdKernels::active().description() << std::endl;
     
-    if (initialized && !random_vectors.empty()) {
-        std::cout << "  - Vectores aleatorios generados: " << random_vectors.size() << std::endl;
+    if (initialized && !projection_matrix.empty()) {
+        std::cout << "  - Vectores aleatorios generados: " << b 
+                  << " (matriz contigua " << b << "×" << d << ")" << std::endl;
         
         // Mostrar estadísticas del primer vector aleatorio como ejemplo
-        if (!random_vectors[0].empty()) {
+        if (d > 0) {
+            const double* row0 = projection_row(0);
             double sum = 0.0;
-            for (double val : random_vectors[0]) {
-                sum += val;
+            for (int j = 0; j < d; ++j) {
+                sum += row0[j];
             }
-            double mean = sum / random_vectors[0].size();
+            double mean = sum / d;
             
             double variance_sum = 0.0;
-            for (double val : random_vectors[0]) {
-                variance_sum += (val - mean) * (val - mean);
+            for (int j = 0; j < d; ++j) {
+                variance_sum += (row0[j] - mean) * (row0[j] - mean);
             }
-            double variance = variance_sum / random_vectors[0].size();
+            double variance = variance_sum / d;
             double std_dev = std::sqrt(variance);
             
             std::cout << "  - Ejemplo (vector 0): media=" << std::fixed << std::setprecision(4) 
@@ -90,5 +302,472 @@ void SRPHasher::print_hash_info() const {
 }
 
 bool SRPHasher::is_initialized() const {
-    return initialized && random_vectors.size() == static_cast<size_t>(b);
-}
\ No newline at end of file
+    return initialized && projection_matrix.size() == static_cast<size_t>(b) * d;
+}
+// === Implementación de PhiloxSRPHasher ===
+
+PhiloxSRPHasher::PhiloxSRPHasher(int dimensions, int num_hashes, unsigned int seed)
+    : LSH(dimensions, num_hashes), seed(seed) {
+    // Sin estado: los coeficientes se derivan de (seed, función, dimensión) al hashear
+}
+
+float PhiloxSRPHasher::coefficient(int hash_function_index, int dim) const {
+    const uint32_t counter[4] = {static_cast<uint32_t>(hash_function_index), static_cast<uint32_t>(dim / 4), 0u, 0u};
+    const uint32_t key[2] = {static_cast<uint32_t>(seed), 0u};
+    float normals[4];
+    philox_gaussian4(counter, key, normals);
+    return normals[dim % 4];
+}
+
+void PhiloxSRPHasher::generate_row(int hash_function_index, float* row) const {
+    const uint32_t key[2] = {static_cast<uint32_t>(seed), 0u};
+    uint32_t counter[4] = {static_cast<uint32_t>(hash_function_index), 0u, 0u, 0u};
+    float normals[4];
+    
+    // Una llamada a Philox produce 4 coeficientes consecutivos de la fila
+    for (int j = 0; j < d; j += 4) {
+        counter[1] = static_cast<uint32_t>(j / 4);
+        philox_gaussian4(counter, key, normals);
+        for (int k = 0; k < 4 && j + k < d; ++k) {
+            row[j + k] = normals[k];
+        }
+    }
+}
+
+char PhiloxSRPHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
+    if (!is_initialized() || hash_function_index < 0 || hash_function_index >= b ||
+        vec.size() != static_cast<size_t>(d)) {
+        return '0';
+    }
+    
+    std::vector<float> row(d);
+    generate_row(hash_function_index, row.data());
+    double projection = 0.0;
+    for (int k = 0; k < d; ++k) {
+        projection += row[k] * vec[k];
+    }
+    return (projection >= 0.0) ? '1' : '0';
+}
+
+void PhiloxSRPHasher::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    std::fill(out, out + code_words(), 0ULL);
+    if (!is_initialized() || vec.size() != static_cast<size_t>(d)) {
+        return;
+    }
+    
+    std::vector<float> row(d);
+    for (int i = 0; i < b; ++i) {
+        generate_row(i, row.data());
+        double projection = 0.0;
+        for (int k = 0; k < d; ++k) {
+            projection += row[k] * vec[k];
+        }
+        if (projection >= 0.0) {
+            out[i >> 6] |= (1ULL << (i & 63));
+        }
+    }
+}
+
+void PhiloxSRPHasher::project(const Vector& vec, double* out) const {
+    if (!is_initialized() || vec.size() != static_cast<size_t>(d)) {
+        std::fill(out, out + b, 0.0);
+        return;
+    }
+    
+    std::vector<float> row(d);
+    for (int i = 0; i < b; ++i) {
+        generate_row(i, row.data());
+        double projection = 0.0;
+        for (int k = 0; k < d; ++k) {
+            projection += row[k] * vec[k];
+        }
+        out[i] = projection;
+    }
+}
+
+void PhiloxSRPHasher::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    const int words = code_words();
+    std::fill(out_codes, out_codes + static_cast<size_t>(n) * words, 0ULL);
+    if (!is_initialized() || n <= 0) return;
+    
+    // Mismo esquema que SRPHasher::hash_batch, pero la fila 'a' se genera en float por bloque
+    std::vector<double> block_t(static_cast<size_t>(d) * HASH_ITEM_BLOCK);
+    std::vector<float> row(d);
+    double acc[HASH_ITEM_BLOCK];
+    
+    for (int item0 = 0; item0 < n; item0 += HASH_ITEM_BLOCK) {
+        const int nb = std::min(HASH_ITEM_BLOCK, n - item0);
+        
+        std::fill(block_t.begin(), block_t.end(), 0.0);
+        for (int j = 0; j < nb; ++j) {
+            const double* x = vectors + static_cast<size_t>(item0 + j) * stride;
+            for (int k = 0; k < d; ++k) {
+                block_t[static_cast<size_t>(k) * HASH_ITEM_BLOCK + j] = x[k];
+            }
+        }
+        
+        for (int bit = 0; bit < b; ++bit) {
+            generate_row(bit, row.data());
+            for (int j = 0; j < HASH_ITEM_BLOCK; ++j) {
+                acc[j] = 0.0;
+            }
+            
+            for (int k = 0; k < d; ++k) {
+                const double a = row[k];
+                const double* col = block_t.data() + static_cast<size_t>(k) * HASH_ITEM_BLOCK;
+                for (int j = 0; j < HASH_ITEM_BLOCK; ++j) {
+                    acc[j] += a * col[j];
+                }
+            }
+            
+            const uint64_t mask = 1ULL << (bit & 63);
+            uint64_t* word = out_codes + static_cast<size_t>(item0) * words + (bit >> 6);
+            for (int j = 0; j < nb; ++j) {
+                if (acc[j] >= 0.0) {
+                    word[static_cast<size_t>(j) * words] |= mask;
+                }
+            }
+        }
+    }
+}
+
+void PhiloxSRPHasher::print_hash_info() const {
+    std::cout << "PhiloxSRPHasher Información:" << std::endl;
+    std::cout << "  - Dimensiones: " << d << std::endl;
+    std::cout << "  - Número de funciones hash: " << b << std::endl;
+    std::cout << "  - Seed: " << seed << " (coeficientes Philox4x32-10 regenerados al hashear)" << std::endl;
+    std::cout << "  - Memoria de parámetros: 0 bytes (vs " << static_cast<size_t>(b) * d * sizeof(double)
+              << " bytes en SRP denso)" << std::endl;
+}
+
+// === Implementación de SparseSRPHasher ===
+
+SparseSRPHasher::SparseSRPHasher(int dimensions, int num_hashes, unsigned int seed, double density)
+    : LSH(dimensions, num_hashes), density(density), initialized(false) {
+    
+    if (dimensions <= 0 || num_hashes <= 0) {
+        return;
+    }
+    if (this->density <= 0.0 || this->density > 1.0) {
+        this->density = 1.0 / std::sqrt(static_cast<double>(dimensions));
+    }
+    
+    // Usar seed 0 significa usar random_device, cualquier otro valor usa seed fijo
+    std::mt19937 rng;
+    if (seed == 0) {
+        rng.seed(std::random_device{}());
+    } else {
+        rng.seed(seed);
+    }
+    
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double half = this->density / 2.0;
+    
+    plus_offsets.push_back(0);
+    minus_offsets.push_back(0);
+    for (int i = 0; i < num_hashes; ++i) {
+        std::vector<int> plus_row, minus_row;
+        while (plus_row.empty() && minus_row.empty()) {
+            for (int j = 0; j < dimensions; ++j) {
+                double u = uniform(rng);
+                if (u < half) {
+                    plus_row.push_back(j);
+                } else if (u < this->density) {
+                    minus_row.push_back(j);
+                }
+            }
+        }
+        plus_index.insert(plus_index.end(), plus_row.begin(), plus_row.end());
+        minus_index.insert(minus_index.end(), minus_row.begin(), minus_row.end());
+        plus_offsets.push_back(static_cast<int>(plus_index.size()));
+        minus_offsets.push_back(static_cast<int>(minus_index.size()));
+    }
+    
+    initialized = true;
+}
+
+double SparseSRPHasher::projection_at(const double* x, int hash_function_index) const {
+    double projection = 0.0;
+    for (int k = plus_offsets[hash_function_index]; k < plus_offsets[hash_function_index + 1]; ++k) {
+        projection += x[plus_index[k]];
+    }
+    for (int k = minus_offsets[hash_function_index]; k < minus_offsets[hash_function_index + 1]; ++k) {
+        projection -= x[minus_index[k]];
+    }
+    return projection;
+}
+
+void SparseSRPHasher::encode_row(const double* x, uint64_t* out) const {
+    for (int i = 0; i < b; ++i) {
+        if (projection_at(x, i) >= 0.0) {
+            out[i >> 6] |= (1ULL << (i & 63));
+        }
+    }
+}
+
+char SparseSRPHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
+    if (!initialized || hash_function_index < 0 || hash_function_index >= b ||
+        vec.size() != static_cast<size_t>(d)) {
+        return '0';
+    }
+    return (projection_at(vec.data(), hash_function_index) >= 0.0) ? '1' : '0';
+}
+
+void SparseSRPHasher::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    std::fill(out, out + code_words(), 0ULL);
+    if (!initialized || vec.size() != static_cast<size_t>(d)) {
+        return;
+    }
+    encode_row(vec.data(), out);
+}
+
+void SparseSRPHasher::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    const int words = code_words();
+    std::fill(out_codes, out_codes + static_cast<size_t>(n) * words, 0ULL);
+    if (!initialized || n <= 0) return;
+    
+    for (int r = 0; r < n; ++r) {
+        encode_row(vectors + static_cast<size_t>(r) * stride, out_codes + static_cast<size_t>(r) * words);
+    }
+}
+
+void SparseSRPHasher::project(const Vector& vec, double* out) const {
+    if (!initialized || vec.size() != static_cast<size_t>(d)) {
+        std::fill(out, out + b, 0.0);
+        return;
+    }
+    for (int i = 0; i < b; ++i) {
+        out[i] = projection_at(vec.data(), i);
+    }
+}
+
+void SparseSRPHasher::print_hash_info() const {
+    std::cout << "SparseSRPHasher Información:" << std::endl;
+    std::cout << "  - Dimensiones: " << d << std::endl;
+    std::cout << "  - Número de funciones hash: " << b << std::endl;
+    std::cout << "  - Inicializado: " << (initialized ? "Sí" : "No") << std::endl;
+    
+    if (initialized) {
+        std::cout << "  - Densidad: " << std::fixed << std::setprecision(4) << density
+                  << " (" << get_num_nonzeros() << " coeficientes ±1, "
+                  << static_cast<double>(get_num_nonzeros()) / b << " por función)" << std::endl;
+    }
+}
+
+bool SparseSRPHasher::is_initialized() const {
+    return initialized && static_cast<int>(plus_offsets.size()) == b + 1 &&
+           static_cast<int>(minus_offsets.size()) == b + 1;
+}
+
+// === Implementación de FastHadamardHasher ===
+
+// Transformada rápida de Walsh-Hadamard in-place (sin normalizar: el signo no cambia)
+static void fast_walsh_hadamard(double* v, int n) {
+    for (int h = 1; h < n; h <<= 1) {
+        for (int i = 0; i < n; i += (h << 1)) {
+            for (int j = i; j < i + h; ++j) {
+                double a = v[j];
+                double c = v[j + h];
+                v[j] = a + c;
+                v[j + h] = a - c;
+            }
+        }
+    }
+}
+
+FastHadamardHasher::FastHadamardHasher(int dimensions, int num_hashes, unsigned int seed)
+    : LSH(dimensions, num_hashes), p(1), num_blocks(0), initialized(false) {
+    
+    if (dimensions <= 0 || num_hashes <= 0) {
+        return;  // Igual que un hasher sin inicializar: todos los bits en '0'
+    }
+    
+    while (p < dimensions) {
+        p <<= 1;
+    }
+    num_blocks = (num_hashes + p - 1) / p;
+    
+    // Usar seed 0 significa usar random_device, cualquier otro valor usa seed fijo
+    std::mt19937 rng;
+    if (seed == 0) {
+        rng.seed(std::random_device{}());
+    } else {
+        rng.seed(seed);
+    }
+    
+    std::bernoulli_distribution coin(0.5);
+    signs.resize(static_cast<size_t>(num_blocks) * NUM_ROUNDS * p);
+    for (double& s : signs) {
+        s = coin(rng) ? 1.0 : -1.0;
+    }
+    
+    initialized = true;
+}
+
+void FastHadamardHasher::transform_block(const double* x, int block, double* work) const {
+    const double* block_signs = signs.data() + static_cast<size_t>(block) * NUM_ROUNDS * p;
+    
+    // Primera ronda: D1 sobre x rellenado con ceros
+    for (int k = 0; k < d; ++k) {
+        work[k] = block_signs[k] * x[k];
+    }
+    std::fill(work + d, work + p, 0.0);
+    fast_walsh_hadamard(work, p);
+    
+    for (int round = 1; round < NUM_ROUNDS; ++round) {
+        const double* round_signs = block_signs + static_cast<size_t>(round) * p;
+        for (int k = 0; k < p; ++k) {
+            work[k] *= round_signs[k];
+        }
+        fast_walsh_hadamard(work, p);
+    }
+}
+
+void FastHadamardHasher::encode_row(const double* x, uint64_t* out, std::vector<double>& work) const {
+    for (int block = 0; block < num_blocks; ++block) {
+        transform_block(x, block, work.data());
+        
+        const int first_bit = block * p;
+        const int bits = std::min(p, b - first_bit);
+        for (int k = 0; k < bits; ++k) {
+            if (work[k] >= 0.0) {
+                int i = first_bit + k;
+                out[i >> 6] |= (1ULL << (i & 63));
+            }
+        }
+    }
+}
+
+char FastHadamardHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
+    if (!initialized || hash_function_index < 0 || hash_function_index >= b ||
+        vec.size() != static_cast<size_t>(d)) {
+        return '0';
+    }
+    
+    // Camino lento (un bloque completo por bit); generate_packed_code evita repetirlo
+    std::vector<double> work(p);
+    transform_block(vec.data(), hash_function_index / p, work.data());
+    return (work[hash_function_index % p] >= 0.0) ? '1' : '0';
+}
+
+void FastHadamardHasher::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    std::fill(out, out + code_words(), 0ULL);
+    if (!initialized || vec.size() != static_cast<size_t>(d)) {
+        return;
+    }
+    
+    std::vector<double> work(p);
+    encode_row(vec.data(), out, work);
+}
+
+void FastHadamardHasher::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    const int words = code_words();
+    std::fill(out_codes, out_codes + static_cast<size_t>(n) * words, 0ULL);
+    if (!initialized || n <= 0) return;
+    
+    std::vector<double> work(p);
+    for (int r = 0; r < n; ++r) {
+        encode_row(vectors + static_cast<size_t>(r) * stride, out_codes + static_cast<size_t>(r) * words, work);
+    }
+}
+
+void FastHadamardHasher::project(const Vector& vec, double* out) const {
+    if (!initialized || vec.size() != static_cast<size_t>(d)) {
+        std::fill(out, out + b, 0.0);
+        return;
+    }
+    
+    std::vector<double> work(p);
+    for (int block = 0; block < num_blocks; ++block) {
+        transform_block(vec.data(), block, work.data());
+        const int first_bit = block * p;
+        const int bits = std::min(p, b - first_bit);
+        std::copy(work.begin(), work.begin() + bits, out + first_bit);
+    }
+}
+
+void FastHadamardHasher::print_hash_info() const {
+    std::cout << "FastHadamardHasher Información:" << std::endl;
+    std::cout << "  - Dimensiones: " << d << " (rellenadas a " << p << ")" << std::endl;
+    std::cout << "  - Número de funciones hash: " << b << std::endl;
+    std::cout << "  - Inicializado: " << (initialized ? "Sí" : "No") << std::endl;
+    
+    if (initialized) {
+        std::cout << "  - Bloques H·D3·H·D2·H·D1: " << num_blocks 
+                  << " (" << signs.size() << " signos vs " << static_cast<size_t>(b) * d 
+                  << " coeficientes en SRP denso)" << std::endl;
+    }
+}
+
+bool FastHadamardHasher::is_initialized() const {
+    return initialized && signs.size() == static_cast<size_t>(num_blocks) * NUM_ROUNDS * p;
+}
+
+// === Implementación de AsymmetricSRPHasher (Simple-ALSH) ===
+
+// Filas transformadas por bloque en hash_batch
+static const int ASYMMETRIC_BATCH_ROWS = 256;
+
+AsymmetricSRPHasher::AsymmetricSRPHasher(const SRPHasher& projection)
+    : LSH(std::max(0, projection.get_dimensions() - 1), projection.get_num_hashes()),
+      projection(projection) {}
+
+void AsymmetricSRPHasher::generate_packed_code(const Vector& vec, uint64_t* out) const {
+    if (!is_initialized() || vec.size() != static_cast<size_t>(d)) {
+        std::fill(out, out + code_words(), 0ULL);
+        return;
+    }
+    Vector transformed(d + 1);
+    transform(vec.data(), transformed.data());
+    projection.generate_packed_code(transformed, out);
+}
+
+void AsymmetricSRPHasher::hash_batch(const double* vectors, int n, int stride, uint64_t* out_codes) const {
+    const int words = code_words();
+    if (!is_initialized() || n <= 0) {
+        std::fill(out_codes, out_codes + static_cast<size_t>(std::max(n, 0)) * words, 0ULL);
+        return;
+    }
+    
+    const int augmented = d + 1;
+    std::vector<double> block(static_cast<size_t>(ASYMMETRIC_BATCH_ROWS) * augmented);
+    for (int row0 = 0; row0 < n; row0 += ASYMMETRIC_BATCH_ROWS) {
+        int rows = std::min(ASYMMETRIC_BATCH_ROWS, n - row0);
+        for (int r = 0; r < rows; ++r) {
+            transform(vectors + static_cast<size_t>(row0 + r) * stride, block.data() + static_cast<size_t>(r) * augmented);
+        }
+        projection.hash_batch(block.data(), rows, augmented, out_codes + static_cast<size_t>(row0) * words);
+    }
+}
+
+char AsymmetricSRPHasher::hash_to_bit(const Vector& vec, int hash_function_index) const {
+    if (!is_initialized() || hash_function_index < 0 || hash_function_index >= b ||
+        vec.size() != static_cast<size_t>(d)) {
+        return '0';
+    }
+    Vector transformed(d + 1);
+    transform(vec.data(), transformed.data());
+    double value = std::inner_product(transformed.begin(), transformed.end(),
+                                      projection.projection_row(hash_function_index), 0.0);
+    return (value >= 0) ? '1' : '0';
+}
+
+SimpleALSHItemHasher::SimpleALSHItemHasher(const SRPHasher& projection, double max_norm)
+    : AsymmetricSRPHasher(projection), max_norm(max_norm > 0.0 ? max_norm : 1.0) {}
+
+void SimpleALSHItemHasher::transform(const double* vec, double* out) const {
+    double squared_norm = 0.0;
+    for (int k = 0; k < d; ++k) {
+        out[k] = vec[k] / max_norm;
+        squared_norm += out[k] * out[k];
+    }
+    out[d] = std::sqrt(std::max(0.0, 1.0 - squared_norm));
+}
+
+SimpleALSHQueryHasher::SimpleALSHQueryHasher(const SRPHasher& projection)
+    : AsymmetricSRPHasher(projection) {}
+
+void SimpleALSHQueryHasher::transform(const double* vec, double* out) const {
+    std::copy(vec, vec + d, out);
+    out[d] = 0.0;
+}
@@ -0,0 +1,218 @@
+#include "../include/LSHBucketIndex.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <queue>
+#include <cmath>
+
+LSHBucketIndex::LSHBucketIndex(int dimensions, int num_tables, int bits_per_table, unsigned int seed)
+    : num_tables(num_tables), bits_per_table(bits_per_table),
+      hasher(dimensions, num_tables * bits_per_table, seed), codes(hasher) {
+    if (num_tables <= 0 || bits_per_table <= 0 || bits_per_table > 64) {
+        throw std::invalid_argument("LSHBucketIndex: se requiere L > 0 y 0 < k <= 64");
+    }
+}
+
+void LSHBucketIndex::build(const UserItemStore& store) {
+    codes.build(store);
+
+    tables.assign(num_tables, std::unordered_map<uint64_t, std::vector<int>>());
+    for (int t = 0; t < num_tables; ++t) {
+        tables[t].reserve(codes.size());
+        for (int row = 0; row < codes.size(); ++row) {
+            tables[t][bucket_key(codes.code_at(row), t)].push_back(row);
+        }
+    }
+}
+
+int LSHBucketIndex::refresh(const UserItemStore& store, const std::vector<int>& item_ids) {
+    std::vector<int> rows;
+    std::vector<uint64_t> old_keys;
+    rows.reserve(item_ids.size());
+    old_keys.reserve(item_ids.size() * num_tables);
+    for (int item_id : item_ids) {
+        int row = codes.row_of(item_id);
+        if (row < 0) {
+            build(store);
+            return size();
+        }
+        rows.push_back(row);
+        for (int t = 0; t < num_tables; ++t) {
+            old_keys.push_back(bucket_key(codes.code_at(row), t));
+        }
+    }
+
+    codes.refresh(store, item_ids);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        for (int t = 0; t < num_tables; ++t) {
+            uint64_t new_key = bucket_key(codes.code_at(rows[i]), t);
+            if (new_key != old_keys[i * num_tables + t]) {
+                move_bucket_row(tables[t], old_keys[i * num_tables + t], new_key, rows[i]);
+            }
+        }
+    }
+    return static_cast<int>(rows.size());
+}
+
+uint64_t LSHBucketIndex::bucket_key(const uint64_t* code, int table) const {
+    // Extraer k bits a partir de la posición t·k (pueden cruzar el límite de una palabra)
+    return extract_bits(code, table * bits_per_table, bits_per_table);
+}
+
+std::vector<int> LSHBucketIndex::query_candidates(const Vector& query) const {
+    return query_candidates(query, 1, ProbeStrategy::HammingRadius);
+}
+
+std::vector<uint64_t> LSHBucketIndex::probe_sequence(const double* margins, int num_probes,
+                                                     ProbeStrategy strategy) const {
+    std::vector<uint64_t> masks;
+    masks.push_back(0);  // El bucket exacto siempre va primero
+    const int k = bits_per_table;
+
+    if (strategy == ProbeStrategy::HammingRadius) {
+        // Todas las combinaciones de r bits, para r = 1, 2, ... hasta agotar el presupuesto
+        for (int radius = 1; radius <= k && static_cast<int>(masks.size()) < num_probes; ++radius) {
+            std::vector<int> combo(radius);
+            for (int i = 0; i < radius; ++i) combo[i] = i;
+
+            while (static_cast<int>(masks.size()) < num_probes) {
+                uint64_t mask = 0;
+                for (int bit : combo) mask |= (1ULL << bit);
+                masks.push_back(mask);
+
+                // Siguiente combinación en orden lexicográfico
+                int i = radius - 1;
+                while (i >= 0 && combo[i] == k - radius + i) --i;
+                if (i < 0) break;
+                ++combo[i];
+                for (int j = i + 1; j < radius; ++j) combo[j] = combo[j - 1] + 1;
+            }
+        }
+        return masks;
+    }
+
+    // ProjectionMargin (multi-probe dirigido por la consulta, Lv et al. 2007):
+    // invertir el bit i cuesta margin_i^2; se generan los conjuntos de bits en orden de
+    // costo creciente con un heap y las operaciones shift/expand sobre los bits ordenados.
+    std::vector<int> order(k);
+    for (int i = 0; i < k; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [margins](int a, int b) { return std::fabs(margins[a]) < std::fabs(margins[b]); });
+
+    std::vector<double> cost(k);
+    for (int i = 0; i < k; ++i) cost[i] = margins[order[i]] * margins[order[i]];
+
+    // Conjunto de perturbación: posiciones en 'order' (crecientes) y su costo total
+    typedef std::pair<double, std::vector<int>> PerturbationSet;
+    auto greater_cost = [](const PerturbationSet& a, const PerturbationSet& b) { return a.first > b.first; };
+    std::priority_queue<PerturbationSet, std::vector<PerturbationSet>, decltype(greater_cost)> heap(greater_cost);
+    if (k > 0) heap.push(PerturbationSet(cost[0], std::vector<int>(1, 0)));
+
+    while (!heap.empty() && static_cast<int>(masks.size()) < num_probes) {
+        PerturbationSet current = heap.top();
+        heap.pop();
+
+        uint64_t mask = 0;
+        for (int pos : current.second) mask |= (1ULL << order[pos]);
+        masks.push_back(mask);
+
+        int last = current.second.back();
+        if (last + 1 < k) {
+            // shift: reemplazar el último bit por el siguiente
+            PerturbationSet shifted = current;
+            shifted.second.back() = last + 1;
+            shifted.first += cost[last + 1] - cost[last];
+            heap.push(shifted);
+
+            // expand: agregar el siguiente bit
+            PerturbationSet expanded = current;
+            expanded.second.push_back(last + 1);
+            expanded.first += cost[last + 1];
+            heap.push(expanded);
+        }
+    }
+    return masks;
+}
+
+std::vector<int> LSHBucketIndex::query_candidates(const Vector& query, int num_probes,
+                                                  ProbeStrategy strategy) const {
+    std::vector<int> candidate_rows;
+    if (tables.empty()) return candidate_rows;
+    num_probes = std::max(1, num_probes);
+
+    PackedCode query_code = codes.encode(query);
+
+    // Márgenes de proyección (sólo si se usan para ordenar los probes)
+    std::vector<double> projections;
+    if (num_probes > 1 && strategy == ProbeStrategy::ProjectionMargin) {
+        projections.resize(hasher.get_num_hashes());
+        hasher.project(query, projections.data());
+    }
+
+    // Con radio Hamming la secuencia es la misma para todas las tablas
+    std::vector<uint64_t> masks;
+    if (strategy == ProbeStrategy::HammingRadius || num_probes == 1) {
+        masks = probe_sequence(nullptr, num_probes, ProbeStrategy::HammingRadius);
+    }
+
+    for (int t = 0; t < num_tables; ++t) {
+        if (num_probes > 1 && strategy == ProbeStrategy::ProjectionMargin) {
+            masks = probe_sequence(projections.data() + t * bits_per_table, num_probes, strategy);
+        }
+
+        uint64_t key = bucket_key(query_code.words.data(), t);
+        for (uint64_t mask : masks) {
+            auto it = tables[t].find(key ^ mask);
+            if (it != tables[t].end()) {
+                candidate_rows.insert(candidate_rows.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+
+    // Unión: eliminar filas repetidas entre tablas (costo proporcional a los candidatos)
+    std::sort(candidate_rows.begin(), candidate_rows.end());
+    candidate_rows.erase(std::unique(candidate_rows.begin(), candidate_rows.end()), candidate_rows.end());
+
+    std::vector<int> candidates;
+    candidates.reserve(candidate_rows.size());
+    for (int row : candidate_rows) {
+        candidates.push_back(codes.item_id_at(row));
+    }
+    return candidates;
+}
+
+size_t LSHBucketIndex::memory_bytes() const {
+    size_t bytes = codes.memory_bytes();
+    for (const auto& table : tables) {
+        bytes += table.size() * (sizeof(uint64_t) + sizeof(std::vector<int>));
+        for (const auto& bucket : table) {
+            bytes += bucket.second.size() * sizeof(int);
+        }
+    }
+    return bytes;
+}
+
+void LSHBucketIndex::print_info() const {
+    std::cout << "LSHBucketIndex Información:" << std::endl;
+    std::cout << "  - Tablas (L): " << num_tables << std::endl;
+    std::cout << "  - Bits por tabla (k): " << bits_per_table << std::endl;
+    std::cout << "  - Ítems indexados: " << codes.size() << std::endl;
+
+    if (tables.empty()) return;
+
+    size_t total_buckets = 0;
+    size_t max_bucket = 0;
+    for (const auto& table : tables) {
+        total_buckets += table.size();
+        for (const auto& bucket : table) {
+            max_bucket = std::max(max_bucket, bucket.second.size());
+        }
+    }
+    std::cout << "  - Buckets no vacíos (promedio por tabla): " << std::fixed << std::setprecision(1)
+              << static_cast<double>(total_buckets) / num_tables << std::endl;
+    std::cout << "  - Ítems por bucket (promedio): "
+              << static_cast<double>(codes.size()) * num_tables / std::max<size_t>(1, total_buckets) << std::endl;
+    std::cout << "  - Bucket más grande: " << max_bucket << std::endl;
+    std::cout << "  - Memoria aproximada: " << memory_bytes() / 1024.0 << " KB" << std::endl;
+}
@@ -0,0 +1,268 @@
+#include "../include/LSHIndex.h"
+#include "../include/TopK.h"
+#include "../include/SimdKernels.h"
+#include <algorithm>
+
+// Vectores copiados por lote al construir el índice
+static const int BUILD_CHUNK = 1024;
+
+// Copia los primeros 'bits' bits de un código (palabras completas + máscara en la última)
+static void copy_prefix(const uint64_t* code, int bits, uint64_t* out) {
+    const int words = (bits + 63) / 64;
+    for (int w = 0; w < words; ++w) out[w] = code[w];
+    if (bits % 64 != 0) {
+        out[words - 1] &= (1ULL << (bits % 64)) - 1;
+    }
+}
+
+LSHIndex::LSHIndex(const LSH& hasher)
+    : hasher(hasher), query_hasher(hasher), words_per_code(hasher.code_words()) {}
+
+LSHIndex::LSHIndex(const LSH& hasher, const LSH& query_hasher)
+    : hasher(hasher), query_hasher(query_hasher), words_per_code(hasher.code_words()) {}
+
+void LSHIndex::load_codes(const int* ids, int n, const uint64_t* item_codes) {
+    n = std::max(n, 0);
+    item_ids.assign(ids, ids + n);
+    words_per_code = hasher.code_words();
+    codes.assign(item_codes, item_codes + static_cast<size_t>(n) * words_per_code);
+    for (PrefixStage& stage : prefix_stages) {
+        fill_prefix_codes(stage);
+    }
+}
+
+void LSHIndex::build(const UserItemStore& store) {
+    // Mismas filas que el store (ids ascendentes)
+    item_ids = store.get_item_ids();
+
+    words_per_code = hasher.code_words();
+    codes.assign(item_ids.size() * words_per_code, 0);
+
+    // Si el store tiene otra dimensión que el hasher los códigos quedan en cero
+    const int d = hasher.get_dimensions();
+    const int n = size();
+    const bool compatible = store.get_dimensions() == d;
+    if (compatible && store.item_matrix()) {
+        // Matriz contigua: el kernel matricial la recorre directamente con el stride del store
+        hasher.hash_batch(store.item_matrix(), n, store.row_stride(), codes.data());
+    } else if (compatible) {
+        // Hashear por lotes: se copian BUILD_CHUNK vectores a un bloque contiguo n×d y se
+        // delega en el kernel matricial del hasher
+        std::vector<double> chunk(static_cast<size_t>(BUILD_CHUNK) * d);
+        for (int row0 = 0; row0 < n; row0 += BUILD_CHUNK) {
+            int rows = std::min(BUILD_CHUNK, n - row0);
+            for (int r = 0; r < rows; ++r) {
+                const double* item_vector = store.item_data(row0 + r);
+                std::copy(item_vector, item_vector + d, chunk.begin() + static_cast<size_t>(r) * d);
+            }
+            hasher.hash_batch(chunk.data(), rows, d, codes.data() + static_cast<size_t>(row0) * words_per_code);
+        }
+    }
+
+    for (PrefixStage& stage : prefix_stages) {
+        fill_prefix_codes(stage);
+    }
+}
+
+int LSHIndex::row_of(int item_id) const {
+    auto it = std::lower_bound(item_ids.begin(), item_ids.end(), item_id);
+    if (it == item_ids.end() || *it != item_id) return -1;
+    return static_cast<int>(it - item_ids.begin());
+}
+
+int LSHIndex::refresh(const UserItemStore& store, const std::vector<int>& changed_ids) {
+    if (changed_ids.empty()) return 0;
+
+    std::vector<int> rows;
+    rows.reserve(changed_ids.size());
+    for (int item_id : changed_ids) {
+        int row = row_of(item_id);
+        if (row < 0) {
+            build(store);
+            return size();
+        }
+        rows.push_back(row);
+    }
+
+    // Mismo hashing por lotes que build(), sólo sobre las filas modificadas
+    const int d = hasher.get_dimensions();
+    const int count = static_cast<int>(rows.size());
+    std::vector<double> chunk(static_cast<size_t>(std::min(BUILD_CHUNK, count)) * d);
+    std::vector<uint64_t> chunk_codes(static_cast<size_t>(std::min(BUILD_CHUNK, count)) * words_per_code);
+
+    for (int start = 0; start < count; start += BUILD_CHUNK) {
+        int batch = std::min(BUILD_CHUNK, count - start);
+        for (int r = 0; r < batch; ++r) {
+            const int store_row = store.item_row(changed_ids[start + r]);
+            if (store_row >= 0 && store.get_dimensions() == d) {
+                const double* item_vector = store.item_data(store_row);
+                std::copy(item_vector, item_vector + d, chunk.begin() + static_cast<size_t>(r) * d);
+            } else {
+                std::fill(chunk.begin() + static_cast<size_t>(r) * d, chunk.begin() + static_cast<size_t>(r + 1) * d, 0.0);
+            }
+        }
+        hasher.hash_batch(chunk.data(), batch, d, chunk_codes.data());
+
+        for (int r = 0; r < batch; ++r) {
+            const int row = rows[start + r];
+            uint64_t* code = codes.data() + static_cast<size_t>(row) * words_per_code;
+            std::copy(chunk_codes.begin() + static_cast<size_t>(r) * words_per_code,
+                      chunk_codes.begin() + static_cast<size_t>(r + 1) * words_per_code, code);
+            for (PrefixStage& stage : prefix_stages) {
+                copy_prefix(code, stage.bits, stage.codes.data() + static_cast<size_t>(row) * stage.words);
+            }
+        }
+    }
+    return count;
+}
+
+PackedCode LSHIndex::encode(const Vector& query) const {
+    return query_hasher.generate_packed_code(query);
+}
+
+void LSHIndex::compute_distances(const PackedCode& query_code, std::vector<int>& distances) const {
+    int n = size();
+    distances.resize(n);
+
+    // Kernel del nivel SIMD elegido al arrancar, para la cantidad de palabras del índice
+    HammingScanKernel scan = SimdKernels::active().hamming_scan(words_per_code);
+    scan(query_code.words.data(), codes.data(), n, words_per_code, distances.data());
+}
+
+std::vector<std::pair<int, int>> LSHIndex::search(const Vector& query, int top_k) const {
+    return search(encode(query), top_k);
+}
+
+std::vector<std::pair<int, int>> LSHIndex::search(const PackedCode& query_code, int top_k) const {
+    std::vector<std::pair<int, int>> results;
+    if (empty() || top_k <= 0 || query_code.num_words() != words_per_code) {
+        return results;
+    }
+
+    std::vector<int> distances;
+    compute_distances(query_code, distances);
+
+    // Top-k por conteo: la distancia sólo toma b+1 valores, no hace falta ordenar las n filas
+    std::vector<int> top_rows;
+    counting_top_k(distances.data(), size(), get_num_bits(), top_k, top_rows);
+
+    results.reserve(top_rows.size());
+    for (int row : top_rows) {
+        results.emplace_back(item_ids[row], distances[row]);
+    }
+    return results;
+}
+
+// === CASCADA DE PREFIJOS ===
+
+// Distancias Hamming sólo de las filas 'rows' (acceso disperso a los supervivientes)
+static void gather_distances(const uint64_t* query, const uint64_t* codes, int num_words,
+                             const std::vector<int>& rows, std::vector<int>& distances) {
+    distances.resize(rows.size());
+    HammingGatherKernel gather = SimdKernels::active().hamming_gather(num_words);
+    gather(query, codes, num_words, rows.data(), static_cast<int>(rows.size()), distances.data());
+}
+
+void LSHIndex::fill_prefix_codes(PrefixStage& stage) const {
+    const int n = size();
+    stage.codes.assign(static_cast<size_t>(n) * stage.words, 0);
+    for (int row = 0; row < n; ++row) {
+        copy_prefix(code_at(row), stage.bits, stage.codes.data() + static_cast<size_t>(row) * stage.words);
+    }
+}
+
+void LSHIndex::build_prefix_cascade(const std::vector<int>& prefix_bits) {
+    std::vector<int> lengths;
+    for (int bits : prefix_bits) {
+        if (bits > 0 && bits < get_num_bits()) lengths.push_back(bits);
+    }
+    std::sort(lengths.begin(), lengths.end());
+    lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+
+    prefix_stages.clear();
+    for (int bits : lengths) {
+        PrefixStage stage;
+        stage.bits = bits;
+        stage.words = (bits + 63) / 64;
+        fill_prefix_codes(stage);
+        prefix_stages.push_back(std::move(stage));
+    }
+}
+
+std::vector<int> LSHIndex::get_prefix_bits() const {
+    std::vector<int> bits;
+    for (const PrefixStage& stage : prefix_stages) bits.push_back(stage.bits);
+    return bits;
+}
+
+std::vector<std::pair<int, int>> LSHIndex::cascade_search(const PackedCode& query_code, int top_k,
+                                                          const std::vector<int>& survivors,
+                                                          long long* rows_compared) const {
+    if (rows_compared) *rows_compared = 0;
+    if (prefix_stages.empty()) {
+        return search(query_code, top_k);
+    }
+    std::vector<std::pair<int, int>> results;
+    if (empty() || top_k <= 0 || query_code.num_words() != words_per_code) {
+        return results;
+    }
+
+    const int n = size();
+    std::vector<uint64_t> query_prefix(words_per_code);
+    std::vector<int> distances;
+    std::vector<int> selected;
+    std::vector<int> rows;  // Filas supervivientes (vacío antes de la primera etapa)
+
+    for (size_t s = 0; s < prefix_stages.size(); ++s) {
+        const PrefixStage& stage = prefix_stages[s];
+        int budget = (s < survivors.size() && survivors[s] > 0) ? survivors[s] : n;
+        budget = std::max(budget, top_k);
+        copy_prefix(query_code.words.data(), stage.bits, query_prefix.data());
+
+        if (s == 0) {
+            if (budget >= n) {
+                rows.resize(n);
+                for (int row = 0; row < n; ++row) rows[row] = row;
+                continue;
+            }
+            // Filtro grueso: recorrido secuencial del arreglo de prefijos más corto
+            distances.resize(n);
+            HammingScanKernel scan = SimdKernels::active().hamming_scan(stage.words);
+            scan(query_prefix.data(), stage.codes.data(), n, stage.words, distances.data());
+            counting_top_k(distances.data(), n, stage.bits, budget, rows);
+        } else {
+            if (budget >= static_cast<int>(rows.size())) continue;
+            gather_distances(query_prefix.data(), stage.codes.data(), stage.words, rows, distances);
+            if (rows_compared) *rows_compared += static_cast<long long>(rows.size());
+            counting_top_k(distances.data(), static_cast<int>(rows.size()), stage.bits, budget, selected);
+            for (int& index : selected) index = rows[index];
+            rows.swap(selected);
+        }
+    }
+
+    // Etapa final con el código completo; se desempata igual que search(): (distancia, fila)
+    gather_distances(query_code.words.data(), codes.data(), words_per_code, rows, distances);
+    if (rows_compared) *rows_compared += static_cast<long long>(rows.size());
+
+    std::vector<std::pair<int, int>> ranked(rows.size());  // <distancia, fila>
+    for (size_t i = 0; i < rows.size(); ++i) {
+        ranked[i] = std::make_pair(distances[i], rows[i]);
+    }
+    const int count = std::min(top_k, static_cast<int>(ranked.size()));
+    std::nth_element(ranked.begin(), ranked.begin() + (count - 1), ranked.end());
+    std::sort(ranked.begin(), ranked.begin() + count);
+
+    results.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        results.emplace_back(item_ids[ranked[i].second], ranked[i].first);
+    }
+    return results;
+}
+
+size_t LSHIndex::memory_bytes() const {
+    size_t bytes = codes.size() * sizeof(uint64_t) + item_ids.size() * sizeof(int);
+    for (const PrefixStage& stage : prefix_stages) {
+        bytes += stage.codes.size() * sizeof(uint64_t);
+    }
+    return bytes;
+}
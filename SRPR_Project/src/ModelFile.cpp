@@ -0,0 +1,238 @@
+#include "../include/ModelFile.h"
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MODEL_MAGIC[8] = {'S', 'R', 'P', 'R', 'M', 'D', 'L', '\0'};
+static const uint32_t MODEL_BYTE_ORDER = 0x01020304u;
+
+static_assert(sizeof(int) == sizeof(int32_t), "los ids se guardan como int32");
+static_assert(sizeof(ModelFileHeader) == 192, "la cabecera del modelo no debe tener relleno");
+
+static uint64_t align64(uint64_t offset) {
+    return (offset + 63) / 64 * 64;
+}
+
+// Bytes esperados de cada sección según las dimensiones de la cabecera
+static uint64_t expected_section_bytes(const ModelFileHeader& h, int section) {
+    const uint64_t users = static_cast<uint64_t>(h.num_users);
+    const uint64_t items = static_cast<uint64_t>(h.num_items);
+    switch (section) {
+        case SectionUserIds:     return users * sizeof(int32_t);
+        case SectionItemIds:     return items * sizeof(int32_t);
+        case SectionUserMatrix:  return users * h.row_stride * sizeof(double);
+        case SectionItemMatrix:  return items * h.row_stride * sizeof(double);
+        case SectionUserNorms:   return users * sizeof(double);
+        case SectionItemNorms:   return items * sizeof(double);
+        case SectionProjections: return static_cast<uint64_t>(h.lsh_bits) * h.dimensions * sizeof(double);
+        case SectionItemCodes:   return items * h.code_words * sizeof(uint64_t);
+    }
+    return 0;
+}
+
+const char* model_hasher_name(ModelHasher hasher) {
+    switch (hasher) {
+        case ModelHasherSRP: return "srp";
+        case ModelHasherITQ: return "itq";
+        default:             return "?";
+    }
+}
+
+bool parse_model_hasher(const std::string& name, ModelHasher& out) {
+    for (int h = 0; h < NumModelHashers; ++h) {
+        if (name == model_hasher_name(static_cast<ModelHasher>(h))) {
+            out = static_cast<ModelHasher>(h);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool save_model(const std::string& path, const UserItemStore& store, const SRPHasher& projection,
+                ModelHasher kind, unsigned int hasher_seed) {
+    if (!store.user_matrix() || !store.item_matrix() || !projection.is_initialized() ||
+        projection.get_dimensions() != store.get_dimensions()) {
+        return false;
+    }
+    const int num_users = store.num_users();
+    const int num_items = store.num_items();
+    const int stride = store.row_stride();
+    const int d = store.get_dimensions();
+    const int b = projection.get_num_hashes();
+
+    ModelFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    header.version = MODEL_FILE_VERSION;
+    header.header_bytes = sizeof(ModelFileHeader);
+    header.byte_order = MODEL_BYTE_ORDER;
+    header.dimensions = d;
+    header.row_stride = stride;
+    header.num_users = num_users;
+    header.num_items = num_items;
+    header.lsh_bits = b;
+    header.code_words = projection.code_words();
+    header.hasher_seed = hasher_seed;
+    header.hasher = static_cast<uint32_t>(kind);
+
+    uint64_t offset = align64(sizeof(ModelFileHeader));
+    for (int s = 0; s < NumModelSections; ++s) {
+        header.sections[s].offset = offset;
+        header.sections[s].bytes = expected_section_bytes(header, s);
+        offset = align64(offset + header.sections[s].bytes);
+    }
+    header.file_bytes = offset;
+
+    // Arreglos que no están ya contiguos en el almacén
+    std::vector<double> user_norms(num_users), item_norms(num_items);
+    for (int row = 0; row < num_users; ++row) user_norms[row] = store.user_norm(row);
+    for (int row = 0; row < num_items; ++row) item_norms[row] = store.item_norm(row);
+    std::vector<double> projections(static_cast<size_t>(b) * d);
+    for (int i = 0; i < b; ++i) {
+        std::copy(projection.projection_row(i), projection.projection_row(i) + d, projections.begin() + static_cast<size_t>(i) * d);
+    }
+    std::vector<uint64_t> codes(static_cast<size_t>(num_items) * header.code_words);
+    projection.hash_batch(store.item_matrix(), num_items, stride, codes.data());
+
+    const void* data[NumModelSections] = {
+        store.get_user_ids().data(), store.get_item_ids().data(),
+        store.user_matrix(), store.item_matrix(),
+        user_norms.data(), item_norms.data(),
+        projections.data(), codes.data()
+    };
+
+    // Se escribe a un temporal y se renombra: un proceso que tenga mapeado el modelo
+    // anterior no ve un archivo a medio escribir
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        const char zeros[64] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t position = sizeof(header);
+        for (int s = 0; s < NumModelSections; ++s) {
+            file.write(zeros, static_cast<std::streamsize>(header.sections[s].offset - position));
+            file.write(static_cast<const char*>(data[s]), static_cast<std::streamsize>(header.sections[s].bytes));
+            position = header.sections[s].offset + header.sections[s].bytes;
+        }
+        file.write(zeros, static_cast<std::streamsize>(header.file_bytes - position));
+        if (!file.good()) {
+            file.close();
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// === MappedModel ===
+
+MappedModel::MappedModel() : base(nullptr), mapped_bytes(0) {}
+
+MappedModel::~MappedModel() {
+    close();
+}
+
+void MappedModel::close() {
+#ifdef _WIN32
+    buffer.clear();
+    buffer.shrink_to_fit();
+#else
+    if (base) {
+        munmap(const_cast<unsigned char*>(base), mapped_bytes);
+    }
+#endif
+    base = nullptr;
+    mapped_bytes = 0;
+}
+
+bool MappedModel::open(const std::string& path, std::string* error) {
+    close();
+    auto fail = [&](const std::string& reason) {
+        close();
+        if (error) *error = reason;
+        return false;
+    };
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return fail("no se pudo abrir " + path);
+    const std::streamoff size = file.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(ModelFileHeader))) return fail("archivo demasiado pequeño");
+    buffer.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), size)) return fail("error de lectura");
+    base = buffer.data();
+    mapped_bytes = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail("no se pudo abrir " + path);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(ModelFileHeader))) {
+        ::close(fd);
+        return fail("archivo demasiado pequeño");
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return fail("mmap falló");
+    base = static_cast<const unsigned char*>(mapping);
+    mapped_bytes = static_cast<size_t>(info.st_size);
+#endif
+
+    const ModelFileHeader& h = header();
+    if (std::memcmp(h.magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0) return fail("no es un modelo SRPR");
+    if (h.byte_order != MODEL_BYTE_ORDER) return fail("orden de bytes distinto al de esta máquina");
+    if (h.version != MODEL_FILE_VERSION) {
+        return fail("versión " + std::to_string(h.version) + " no soportada (se espera " +
+                    std::to_string(MODEL_FILE_VERSION) + ")");
+    }
+    if (h.header_bytes != sizeof(ModelFileHeader) || h.file_bytes != mapped_bytes) {
+        return fail("cabecera o tamaño de archivo inconsistentes");
+    }
+    if (h.dimensions <= 0 || h.row_stride < h.dimensions || h.num_users < 0 || h.num_items < 0 ||
+        h.lsh_bits <= 0 || h.code_words != code_words_for_bits(h.lsh_bits)) {
+        return fail("dimensiones inválidas");
+    }
+    if (h.hasher >= static_cast<uint32_t>(NumModelHashers)) {
+        return fail("tipo de hasher " + std::to_string(h.hasher) + " desconocido");
+    }
+    for (int s = 0; s < NumModelSections; ++s) {
+        const ModelSectionEntry& entry = h.sections[s];
+        if (entry.offset % 64 != 0 || entry.offset < sizeof(ModelFileHeader) ||
+            entry.bytes != expected_section_bytes(h, s) || entry.offset > mapped_bytes ||
+            entry.bytes > mapped_bytes - entry.offset) {
+            return fail("sección " + std::to_string(s) + " fuera de rango");
+        }
+    }
+    return true;
+}
+
+static int find_row(const int32_t* ids, int n, int id) {
+    const int32_t* it = std::lower_bound(ids, ids + n, id);
+    return (it != ids + n && *it == id) ? static_cast<int>(it - ids) : -1;
+}
+
+int MappedModel::user_row(int user_id) const {
+    return find_row(user_ids(), num_users(), user_id);
+}
+
+int MappedModel::item_row(int item_id) const {
+    return find_row(item_ids(), num_items(), item_id);
+}
+
+SRPHasher MappedModel::make_hasher() const {
+    const size_t size = static_cast<size_t>(get_num_bits()) * get_dimensions();
+    return SRPHasher(get_dimensions(), get_num_bits(), std::vector<double>(projections(), projections() + size));
+}
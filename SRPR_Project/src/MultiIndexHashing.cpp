@@ -0,0 +1,261 @@
+#include "../include/MultiIndexHashing.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include <cmath>
+
+// C(n, k) acotado a 'cap' (sólo se usa para comparar con el tamaño del catálogo)
+static long long binomial_capped(int n, int k, long long cap) {
+    if (k < 0 || k > n) return 0;
+    k = std::min(k, n - k);
+    long long result = 1;
+    for (int i = 1; i <= k; ++i) {
+        result = result * (n - k + i) / i;
+        if (result > cap) return cap;
+    }
+    return result;
+}
+
+MultiIndexHashing::MultiIndexHashing(const LSHIndex& index, int num_substrings)
+    : index(index), num_substrings(num_substrings) {
+    const int bits = index.get_num_bits();
+    if (num_substrings <= 0 || num_substrings > bits) {
+        throw std::invalid_argument("MultiIndexHashing: se requiere 1 <= m <= bits del código");
+    }
+    if ((bits + num_substrings - 1) / num_substrings > 64) {
+        throw std::invalid_argument("MultiIndexHashing: las subcadenas no pueden superar 64 bits");
+    }
+
+    // Las primeras (B mod m) subcadenas llevan un bit extra
+    int start = 0;
+    for (int j = 0; j < num_substrings; ++j) {
+        int length = bits / num_substrings + (j < bits % num_substrings ? 1 : 0);
+        offsets.push_back(start);
+        lengths.push_back(length);
+        start += length;
+    }
+}
+
+int MultiIndexHashing::suggested_substrings(int num_bits, int num_items) {
+    double log_n = std::log2(static_cast<double>(std::max(2, num_items)));
+    int m = static_cast<int>(std::round(num_bits / log_n));
+    m = std::max(m, (num_bits + 63) / 64);  // Subcadenas de a lo sumo 64 bits
+    return std::max(1, std::min(m, num_bits));
+}
+
+void MultiIndexHashing::build() {
+    tables.assign(num_substrings, std::unordered_map<uint64_t, std::vector<int>>());
+    for (int j = 0; j < num_substrings; ++j) {
+        tables[j].reserve(index.size());
+        for (int row = 0; row < index.size(); ++row) {
+            tables[j][substring_key(index.code_at(row), j)].push_back(row);
+        }
+    }
+}
+
+void MultiIndexHashing::update_rows(const std::vector<int>& rows, const std::vector<uint64_t>& previous_codes) {
+    const int words = index.get_code_words();
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const uint64_t* previous = previous_codes.data() + i * words;
+        const uint64_t* current = index.code_at(rows[i]);
+        for (int j = 0; j < num_substrings; ++j) {
+            uint64_t old_key = substring_key(previous, j);
+            uint64_t new_key = substring_key(current, j);
+            if (old_key != new_key) {
+                move_bucket_row(tables[j], old_key, new_key, rows[i]);
+            }
+        }
+    }
+}
+
+uint64_t MultiIndexHashing::substring_key(const uint64_t* code, int j) const {
+    return extract_bits(code, offsets[j], lengths[j]);
+}
+
+void MultiIndexHashing::probe_radius(int j, uint64_t key, int radius, std::vector<int>& rows) const {
+    const int length = lengths[j];
+    if (radius < 0 || radius > length) return;
+
+    // Todas las máscaras de 'radius' bits sobre 'length' bits, en orden lexicográfico
+    std::vector<int> combo(radius);
+    for (int i = 0; i < radius; ++i) combo[i] = i;
+
+    while (true) {
+        uint64_t mask = 0;
+        for (int bit : combo) mask |= (1ULL << bit);
+
+        auto it = tables[j].find(key ^ mask);
+        if (it != tables[j].end()) {
+            rows.insert(rows.end(), it->second.begin(), it->second.end());
+        }
+
+        int i = radius - 1;
+        while (i >= 0 && combo[i] == length - radius + i) --i;
+        if (i < 0) break;
+        ++combo[i];
+        for (int k = i + 1; k < radius; ++k) combo[k] = combo[k - 1] + 1;
+    }
+}
+
+std::vector<std::pair<int, int>> MultiIndexHashing::range_search(const PackedCode& query_code, int radius,
+                                                                 int* num_candidates) const {
+    std::vector<std::pair<int, int>> results;
+    if (num_candidates) *num_candidates = 0;
+    if (tables.empty() || radius < 0 || query_code.num_words() != index.get_code_words()) {
+        return results;
+    }
+
+    // Palomar ajustado: las primeras (r mod m)+1 tablas con radio floor(r/m), el resto con uno menos
+    const int base_radius = radius / num_substrings;
+    const int wide_tables = radius % num_substrings + 1;
+
+    std::unordered_set<int> seen;
+    std::vector<int> rows;
+    std::vector<std::pair<int, int>> matches;  // <distancia, fila>
+    for (int j = 0; j < num_substrings; ++j) {
+        uint64_t key = substring_key(query_code.words.data(), j);
+        int table_radius = (j < wide_tables) ? base_radius : base_radius - 1;
+        for (int s = 0; s <= table_radius; ++s) {
+            rows.clear();
+            probe_radius(j, key, s, rows);
+            for (int row : rows) {
+                if (!seen.insert(row).second) continue;
+                int distance = hamming_distance_words(query_code.words.data(), index.code_at(row),
+                                                      index.get_code_words());
+                if (distance <= radius) {
+                    matches.emplace_back(distance, row);
+                }
+            }
+        }
+    }
+
+    if (num_candidates) *num_candidates = static_cast<int>(seen.size());
+    std::sort(matches.begin(), matches.end());
+    results.reserve(matches.size());
+    for (const auto& match : matches) {
+        results.emplace_back(index.item_id_at(match.second), match.first);
+    }
+    return results;
+}
+
+std::vector<std::pair<int, int>> MultiIndexHashing::search(const Vector& query, int top_k) const {
+    return search(index.encode(query), top_k);
+}
+
+std::vector<std::pair<int, int>> MultiIndexHashing::search(const PackedCode& query_code, int top_k,
+                                                           const ItemFilter& filter,
+                                                           int* num_candidates) const {
+    std::vector<std::pair<int, int>> results;
+    if (num_candidates) *num_candidates = 0;
+    const int n = index.size();
+    if (tables.empty() || top_k <= 0 || n == 0 || query_code.num_words() != index.get_code_words()) {
+        return results;
+    }
+
+    const int bits = index.get_num_bits();
+    const int words = index.get_code_words();
+    const uint64_t* query = query_code.words.data();
+
+    std::vector<uint64_t> keys(num_substrings);
+    for (int j = 0; j < num_substrings; ++j) {
+        keys[j] = substring_key(query, j);
+    }
+
+    std::unordered_set<int> seen;
+    std::vector<std::pair<int, int>> accepted;   // <distancia, fila> que pasan el filtro
+    std::vector<int> histogram(bits + 1, 0);     // Distancias de los aceptados
+    std::vector<int> rows;
+
+    auto visit = [&](int row) {
+        if (!seen.insert(row).second) return;
+        if (filter && !filter(index.item_id_at(row))) return;
+        int distance = hamming_distance_words(query, index.code_at(row), words);
+        accepted.emplace_back(distance, row);
+        ++histogram[distance];
+    };
+
+    // k-ésima menor distancia entre los aceptados (bits + 1 si aún no hay k)
+    auto kth_distance = [&]() {
+        int count = 0;
+        for (int d = 0; d <= bits; ++d) {
+            count += histogram[d];
+            if (count >= top_k) return d;
+        }
+        return bits + 1;
+    };
+
+    // Radio s creciente en todas las tablas. Tras sondear el radio s en las tablas 0..j
+    // (y s-1 en el resto), un ítem no visto difiere en >= s+1 bits en cada tabla 0..j y
+    // >= s en las demás: su distancia es >= s·m + j + 1. Si el k-ésimo aceptado está a
+    // <= s·m + j, ningún ítem sin ver puede entrar (ni empatar) en el top-k.
+    bool done = false;
+    const int max_length = *std::max_element(lengths.begin(), lengths.end());
+    for (int s = 0; s <= max_length && !done; ++s) {
+        for (int j = 0; j < num_substrings && !done; ++j) {
+            if (binomial_capped(lengths[j], s, n + 1LL) > n) {
+                // Sondear este radio costaría más que recorrer el catálogo: completar linealmente
+                for (int row = 0; row < n; ++row) {
+                    visit(row);
+                }
+                done = true;
+                break;
+            }
+
+            rows.clear();
+            probe_radius(j, keys[j], s, rows);
+            for (int row : rows) {
+                visit(row);
+            }
+
+            if (static_cast<int>(seen.size()) == n ||
+                kth_distance() <= s * num_substrings + j) {
+                done = true;
+            }
+        }
+    }
+
+    if (num_candidates) *num_candidates = static_cast<int>(seen.size());
+
+    // Orden final (distancia, fila): igual que el ranking lineal de LSHIndex::search
+    int k = std::min(top_k, static_cast<int>(accepted.size()));
+    std::partial_sort(accepted.begin(), accepted.begin() + k, accepted.end());
+    results.reserve(k);
+    for (int i = 0; i < k; ++i) {
+        results.emplace_back(index.item_id_at(accepted[i].second), accepted[i].first);
+    }
+    return results;
+}
+
+size_t MultiIndexHashing::memory_bytes() const {
+    size_t bytes = 0;
+    for (const auto& table : tables) {
+        bytes += table.size() * (sizeof(uint64_t) + sizeof(std::vector<int>) + sizeof(void*));
+        for (const auto& bucket : table) {
+            bytes += bucket.second.capacity() * sizeof(int);
+        }
+    }
+    return bytes;
+}
+
+void MultiIndexHashing::print_info() const {
+    std::cout << "MultiIndexHashing Información:" << std::endl;
+    std::cout << "  - Bits por código: " << index.get_num_bits() << std::endl;
+    std::cout << "  - Subcadenas (m): " << num_substrings << " (";
+    for (int j = 0; j < num_substrings; ++j) {
+        std::cout << (j ? ", " : "") << lengths[j];
+    }
+    std::cout << " bits)" << std::endl;
+    std::cout << "  - Ítems indexados: " << index.size() << std::endl;
+
+    if (tables.empty()) return;
+
+    size_t total_buckets = 0;
+    for (const auto& table : tables) {
+        total_buckets += table.size();
+    }
+    std::cout << "  - Buckets no vacíos (promedio por tabla): " << std::fixed << std::setprecision(1)
+              << static_cast<double>(total_buckets) / num_substrings << std::endl;
+    std::cout << "  - Memoria de tablas: " << memory_bytes() / 1024.0 << " KB" << std::endl;
+}
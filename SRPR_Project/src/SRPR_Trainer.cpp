@@ -1,34 +1,47 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "../include/SRPR_Trainer.h"
+#include "../include/SimdKernels.h"
 #include <iostream>
 #include <numeric>
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
+#include <stdexcept>
+#include <string>
 
 // Función de utilidad para calcular la norma de un vector
 static double norm(const Vector& v) {
-    return std::sqrt(std::inner_product(v.begin(), v.end(), v.begin(), 0.0));
+    return std::sqrt(SimdKernels::active().dot(v.data(), v.data(), static_cast<int>(v.size())));
 }
 
-// Función de utilidad para el producto punto
-static double dot_product(const Vector& v1, const Vector& v2) {
-    return std::inner_product(v1.begin(), v1.end(), v2.begin(), 0.0);
+// Función de utilidad para el producto punto (kernel SIMD elegido al arrancar)
+static double dot_product(const double* v1, const double* v2, int d) {
+    return SimdKernels::active().dot(v1, v2, d);
 }
 
 SRPR_Trainer::SRPR_Trainer(UserItemStore& data_store) : store(data_store) {}
 
-double SRPR_Trainer::calculate_p_srp(const Vector& v1, const Vector& v2) const {
-    double n1 = norm(v1);
-    double n2 = norm(v2);
-    
+SRPR_Trainer::TripletRows SRPR_Trainer::resolve_rows(const Triplet& triplet) const {
+    TripletRows rows;
+    rows.user = store.user_row(triplet.user_id);
+    rows.preferred = store.item_row(triplet.preferred_item_id);
+    rows.less_preferred = store.item_row(triplet.less_preferred_item_id);
+    if (rows.user < 0 || rows.preferred < 0 || rows.less_preferred < 0) {
+        throw std::out_of_range("SRPR_Trainer: tripleta (" + std::to_string(triplet.user_id) + ", " +
+                                std::to_string(triplet.preferred_item_id) + ", " +
+                                std::to_string(triplet.less_preferred_item_id) + ") fuera del almacén");
+    }
+    return rows;
+}
+
+double SRPR_Trainer::calculate_p_srp(double dot, double n1, double n2) const {
     // Manejar casos extremos
     if (n1 < 1e-12 || n2 < 1e-12) {
         return 0.5; // Probabilidad neutral si algún vector es casi cero
     }
 
-    double cosine_sim = dot_product(v1, v2) / (n1 * n2);
+    double cosine_sim = dot / (n1 * n2);
     
     // Asegurar que el valor esté en [-1, 1] para acos
     cosine_sim = std::max(-1.0, std::min(1.0, cosine_sim));
@@ -81,19 +94,16 @@ std::pair<double, double> SRPR_Trainer::calculate_gamma_derivatives(double p_ui,
     return {dgamma_dpui, dgamma_dpuj};
 }
 
-std::pair<Vector, Vector> SRPR_Trainer::calculate_p_srp_derivatives(const Vector& v1, const Vector& v2) const {
-    int d = v1.size();
+std::pair<Vector, Vector> SRPR_Trainer::calculate_p_srp_derivatives(const double* v1, double n1,
+                                                                     const double* v2, double n2,
+                                                                     double dot_prod, int d) const {
     Vector grad_v1(d, 0.0);
     Vector grad_v2(d, 0.0);
     
-    double n1 = norm(v1);
-    double n2 = norm(v2);
-    
     if (n1 < 1e-12 || n2 < 1e-12) {
         return {grad_v1, grad_v2}; // Gradientes cero si normas muy pequeñas
     }
     
-    double dot_prod = dot_product(v1, v2);
     double cosine_sim = dot_prod / (n1 * n2);
     cosine_sim = std::max(-1.0, std::min(1.0, cosine_sim));
     
@@ -121,19 +131,31 @@ std::pair<Vector, Vector> SRPR_Trainer::calculate_p_srp_derivatives(const Vector
 
 void SRPR_Trainer::compute_gradients(const Triplet& triplet, const TrainingParams& params,
                                     Vector& grad_xu, Vector& grad_yi, Vector& grad_yj) const {
+    compute_gradients(resolve_rows(triplet), params, grad_xu, grad_yi, grad_yj);
+}
+
+void SRPR_Trainer::compute_gradients(const TripletRows& rows, const TrainingParams& params,
+                                    Vector& grad_xu, Vector& grad_yi, Vector& grad_yj) const {
     
-    const Vector& xu = store.get_user_vector(triplet.user_id);
-    const Vector& yi = store.get_item_vector(triplet.preferred_item_id);
-    const Vector& yj = store.get_item_vector(triplet.less_preferred_item_id);
+    const double* xu = store.user_data(rows.user);
+    const double* yi = store.item_data(rows.preferred);
+    const double* yj = store.item_data(rows.less_preferred);
     
-    int d = xu.size();
+    int d = store.get_dimensions();
     grad_xu.assign(d, 0.0);
     grad_yi.assign(d, 0.0);
     grad_yj.assign(d, 0.0);
     
+    // Normas cacheadas en el store: un solo producto punto por par
+    const double n_u = store.user_norm(rows.user);
+    const double n_i = store.item_norm(rows.preferred);
+    const double n_j = store.item_norm(rows.less_preferred);
+    const double dot_ui = dot_product(xu, yi, d);
+    const double dot_uj = dot_product(xu, yj, d);
+    
     // Calcular probabilidades de colisión
-    double p_ui = calculate_p_srp(xu, yi);
-    double p_uj = calculate_p_srp(xu, yj);
+    double p_ui = calculate_p_srp(dot_ui, n_u, n_i);
+    double p_uj = calculate_p_srp(dot_uj, n_u, n_j);
     
     // Calcular gamma
     double gamma = calculate_gamma(p_ui, p_uj, params.b_lsh_length);
@@ -156,11 +178,11 @@ void SRPR_Trainer::compute_gradients(const Triplet& triplet, const TrainingParam
     double common_factor = (phi_prime_val / phi_val) * std::sqrt(params.b_lsh_length);
     
     // Calcular derivadas de p_ui y p_uj respecto a los vectores
-    std::pair<Vector, Vector> dpui_derivs = calculate_p_srp_derivatives(xu, yi);
+    std::pair<Vector, Vector> dpui_derivs = calculate_p_srp_derivatives(xu, n_u, yi, n_i, dot_ui, d);
     Vector dpui_dxu = dpui_derivs.first;
     Vector dpui_dyi = dpui_derivs.second;
     
-    std::pair<Vector, Vector> dpuj_derivs = calculate_p_srp_derivatives(xu, yj);
+    std::pair<Vector, Vector> dpuj_derivs = calculate_p_srp_derivatives(xu, n_u, yj, n_j, dot_uj, d);
     Vector dpuj_dxu = dpuj_derivs.first;
     Vector dpuj_dyj = dpuj_derivs.second;
     
@@ -180,12 +202,18 @@ void SRPR_Trainer::compute_gradients(const Triplet& triplet, const TrainingParam
 void SRPR_Trainer::update_vectors(const Triplet& triplet, const Vector& grad_xu, 
                                  const Vector& grad_yi, const Vector& grad_yj,
                                  const TrainingParams& params) {
+    update_vectors(triplet, resolve_rows(triplet), grad_xu, grad_yi, grad_yj, params);
+}
+
+void SRPR_Trainer::update_vectors(const Triplet& triplet, const TripletRows& rows, const Vector& grad_xu,
+                                 const Vector& grad_yi, const Vector& grad_yj,
+                                 const TrainingParams& params) {
     
-    Vector& xu = store.get_user_vector(triplet.user_id);
-    Vector& yi = store.get_item_vector(triplet.preferred_item_id);
-    Vector& yj = store.get_item_vector(triplet.less_preferred_item_id);
+    double* xu = store.user_data(rows.user);
+    double* yi = store.item_data(rows.preferred);
+    double* yj = store.item_data(rows.less_preferred);
     
-    int d = xu.size();
+    int d = store.get_dimensions();
     
     // Actualizar vectores usando gradiente ascendente (maximizar log-likelihood)
     for (int k = 0; k < d; ++k) {
@@ -195,9 +223,14 @@ void SRPR_Trainer::update_vectors(const Triplet& triplet, const Vector& grad_xu,
     }
     
     // Aplicar regularización
-    apply_regularization(xu, params.regularization, params.learning_rate);
-    apply_regularization(yi, params.regularization, params.learning_rate);
-    apply_regularization(yj, params.regularization, params.learning_rate);
+    apply_regularization(xu, d, params.regularization, params.learning_rate);
+    apply_regularization(yi, d, params.regularization, params.learning_rate);
+    apply_regularization(yj, d, params.regularization, params.learning_rate);
+    
+    // Registrar los cambios para que los índices de códigos rehasheen sólo estos vectores
+    store.mark_user_dirty(triplet.user_id);
+    store.mark_item_dirty(triplet.preferred_item_id);
+    store.mark_item_dirty(triplet.less_preferred_item_id);
 }
 
 double SRPR_Trainer::phi(double x) const {
@@ -214,9 +247,9 @@ double SRPR_Trainer::safe_acos(double x) const {
     return std::acos(std::max(-1.0, std::min(1.0, x)));
 }
 
-void SRPR_Trainer::apply_regularization(Vector& vector, double reg_factor, double learning_rate) const {
-    for (double& val : vector) {
-        val -= learning_rate * reg_factor * val;
+void SRPR_Trainer::apply_regularization(double* vector, int d, double reg_factor, double learning_rate) const {
+    for (int k = 0; k < d; ++k) {
+        vector[k] -= learning_rate * reg_factor * vector[k];
     }
 }
 
@@ -229,12 +262,17 @@ bool SRPR_Trainer::check_convergence(const std::vector<double>& losses, double t
 }
 
 double SRPR_Trainer::evaluate_triplet(const Triplet& triplet, const TrainingParams& params) const {
-    const Vector& xu = store.get_user_vector(triplet.user_id);
-    const Vector& yi = store.get_item_vector(triplet.preferred_item_id);
-    const Vector& yj = store.get_item_vector(triplet.less_preferred_item_id);
-    
-    double p_ui = calculate_p_srp(xu, yi);
-    double p_uj = calculate_p_srp(xu, yj);
+    return evaluate_triplet(resolve_rows(triplet), params);
+}
+
+double SRPR_Trainer::evaluate_triplet(const TripletRows& rows, const TrainingParams& params) const {
+    const double* xu = store.user_data(rows.user);
+    const double* yi = store.item_data(rows.preferred);
+    const double* yj = store.item_data(rows.less_preferred);
+    const int d = store.get_dimensions();
+    
+    double p_ui = calculate_p_srp(dot_product(xu, yi, d), store.user_norm(rows.user), store.item_norm(rows.preferred));
+    double p_uj = calculate_p_srp(dot_product(xu, yj, d), store.user_norm(rows.user), store.item_norm(rows.less_preferred));
     double gamma = calculate_gamma(p_ui, p_uj, params.b_lsh_length);
     double sqrt_b_gamma = std::sqrt(params.b_lsh_length) * gamma;
     
@@ -270,6 +308,17 @@ SRPR_Trainer::TrainingStats SRPR_Trainer::train(const std::vector<Triplet>& trai
         std::cout << std::endl;
     }
     
+    // Normas al día aunque se hayan escrito vectores sin marcarlos; durante el entrenamiento
+    // update_vectors las mantiene al marcar cada vector modificado
+    store.recompute_norms();
+    
+    // Las filas de cada tripleta se resuelven una sola vez (no cambian entre epochs)
+    std::vector<TripletRows> training_rows;
+    training_rows.reserve(training_triplets.size());
+    for (const auto& triplet : training_triplets) {
+        training_rows.push_back(resolve_rows(triplet));
+    }
+    
     for (int epoch = 0; epoch < params.epochs; ++epoch) {
         double epoch_loss = 0.0;
         int updates = 0;
@@ -277,17 +326,17 @@ SRPR_Trainer::TrainingStats SRPR_Trainer::train(const std::vector<Triplet>& trai
         auto epoch_start = std::chrono::high_resolution_clock::now();
         
         // Entrenar con todas las tripletas
-        for (const auto& triplet : training_triplets) {
+        for (size_t t = 0; t < training_triplets.size(); ++t) {
             Vector grad_xu, grad_yi, grad_yj;
             
             // Calcular gradientes
-            compute_gradients(triplet, params, grad_xu, grad_yi, grad_yj);
+            compute_gradients(training_rows[t], params, grad_xu, grad_yi, grad_yj);
             
             // Actualizar vectores
-            update_vectors(triplet, grad_xu, grad_yi, grad_yj, params);
+            update_vectors(training_triplets[t], training_rows[t], grad_xu, grad_yi, grad_yj, params);
             
             // Acumular pérdida
-            epoch_loss += evaluate_triplet(triplet, params);
+            epoch_loss += evaluate_triplet(training_rows[t], params);
             updates++;
         }
         
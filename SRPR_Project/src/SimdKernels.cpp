@@ -0,0 +1,791 @@
+#include "../include/SimdKernels.h"
+#include "../include/CpuFeatures.h"
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#ifdef SRPR_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE42:  return "sse4.2";
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+    }
+    return "scalar";
+}
+
+// === Versiones escalares (portables) ===
+
+static double dot_scalar(const double* a, const double* b, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static double dot_f32_scalar(const float* a, const float* b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static double dot_bf16_scalar(const bfloat16* a, const float* b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        sum += a[i].to_float() * b[i];
+    }
+    return sum;
+}
+
+static int32_t dot_int8_scalar(const int8_t* a, const int8_t* b, int n) {
+    int32_t sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+// Suma vertical bit-sliced: cada grupo se cuenta en un contador local de 5 bits (sumador
+// sin ramas por plano) y ese valor se suma a los contadores una sola vez por grupo
+static void bit_sliced_accumulate_scalar(uint64_t* counters, int counter_bits, const uint64_t* planes,
+                                         const uint64_t* query_masks, int count) {
+    for (int l = 0; l < 4; ++l) {
+        uint64_t local[5] = {0, 0, 0, 0, 0};
+        for (int i = 0; i < count; ++i) {
+            uint64_t carry = planes[4 * i + l] ^ query_masks[i];
+            for (int c = 0; c < 5; ++c) {
+                uint64_t next = local[c] & carry;
+                local[c] ^= carry;
+                carry = next;
+            }
+        }
+
+        // counters += local (suma con acarreo sobre todos los niveles)
+        uint64_t carry = 0;
+        for (int c = 0; c < counter_bits; ++c) {
+            uint64_t addend = (c < 5) ? local[c] : 0;
+            uint64_t current = counters[4 * c + l];
+            uint64_t partial = current ^ addend;
+            counters[4 * c + l] = partial ^ carry;
+            carry = (current & addend) | (carry & partial);
+        }
+    }
+}
+
+static void bit_sliced_at_most_scalar(const uint64_t* counters, int counter_bits, int threshold, uint64_t* out) {
+    for (int l = 0; l < 4; ++l) {
+        uint64_t less = 0;
+        uint64_t equal = ~0ULL;
+        for (int c = counter_bits - 1; c >= 0; --c) {
+            uint64_t bit = counters[4 * c + l];
+            if ((threshold >> c) & 1) {
+                less |= equal & ~bit;
+                equal &= bit;
+            } else {
+                equal &= ~bit;
+            }
+        }
+        out[l] = less | equal;
+    }
+}
+
+#ifdef SRPR_X86_DISPATCH
+
+// === SSE4.2: POPCNT por instrucción, producto punto SSE2 ===
+
+template <int Words>
+__attribute__((target("popcnt")))
+static void hamming_scan_popcnt_fixed(const uint64_t* query, const uint64_t* codes, int n, int /*num_words*/,
+                                      int* distances) {
+    uint64_t q[Words];
+    for (int w = 0; w < Words; ++w) q[w] = query[w];
+    for (int row = 0; row < n; ++row, codes += Words) {
+        int distance = 0;
+        for (int w = 0; w < Words; ++w) {
+            distance += __builtin_popcountll(q[w] ^ codes[w]);
+        }
+        distances[row] = distance;
+    }
+}
+
+__attribute__((target("popcnt")))
+static void hamming_scan_popcnt(const uint64_t* query, const uint64_t* codes, int n, int num_words,
+                                int* distances) {
+    for (int row = 0; row < n; ++row, codes += num_words) {
+        int distance = 0;
+        for (int w = 0; w < num_words; ++w) {
+            distance += __builtin_popcountll(query[w] ^ codes[w]);
+        }
+        distances[row] = distance;
+    }
+}
+
+static HammingScanKernel select_popcnt_scan(int num_words) {
+    switch (num_words) {
+        case 1: return &hamming_scan_popcnt_fixed<1>;
+        case 2: return &hamming_scan_popcnt_fixed<2>;
+        case 3: return &hamming_scan_popcnt_fixed<3>;
+        case 4: return &hamming_scan_popcnt_fixed<4>;
+        default: return &hamming_scan_popcnt;
+    }
+}
+
+template <int Words>
+__attribute__((target("popcnt")))
+static void hamming_gather_popcnt_fixed(const uint64_t* query, const uint64_t* codes, int /*num_words*/,
+                                        const int* rows, int count, int* distances) {
+    uint64_t q[Words];
+    for (int w = 0; w < Words; ++w) q[w] = query[w];
+    for (int i = 0; i < count; ++i) {
+        const uint64_t* code = codes + static_cast<size_t>(rows[i]) * Words;
+        int distance = 0;
+        for (int w = 0; w < Words; ++w) {
+            distance += __builtin_popcountll(q[w] ^ code[w]);
+        }
+        distances[i] = distance;
+    }
+}
+
+__attribute__((target("popcnt")))
+static void hamming_gather_popcnt(const uint64_t* query, const uint64_t* codes, int num_words,
+                                  const int* rows, int count, int* distances) {
+    for (int i = 0; i < count; ++i) {
+        const uint64_t* code = codes + static_cast<size_t>(rows[i]) * num_words;
+        int distance = 0;
+        for (int w = 0; w < num_words; ++w) {
+            distance += __builtin_popcountll(query[w] ^ code[w]);
+        }
+        distances[i] = distance;
+    }
+}
+
+static HammingGatherKernel select_popcnt_gather(int num_words) {
+    switch (num_words) {
+        case 1: return &hamming_gather_popcnt_fixed<1>;
+        case 2: return &hamming_gather_popcnt_fixed<2>;
+        case 3: return &hamming_gather_popcnt_fixed<3>;
+        case 4: return &hamming_gather_popcnt_fixed<4>;
+        default: return &hamming_gather_popcnt;
+    }
+}
+
+static double dot_sse2(const double* a, const double* b, int n) {
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    double sum = lanes[0] + lanes[1];
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static double dot_f32_sse2(const float* a, const float* b, int n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// bfloat16 -> float: intercalar 16 bits en cero como mitad baja de cada float
+static double dot_bf16_sse2(const bfloat16* a, const float* b, int n) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(zero, packed)), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(zero, packed)), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; ++i) {
+        sum += a[i].to_float() * b[i];
+    }
+    return sum;
+}
+
+// int8: PMADDUBSW multiplica bytes sin signo por bytes con signo y suma pares en 16 bits;
+// con |a| como operando sin signo y b con el signo de a el producto es el mismo, y con
+// valores en [-127, 127] cada par (<= 2·127²) cabe sin saturar. PMADDWD con unos suma los
+// pares en 32 bits.
+__attribute__((target("ssse3")))
+static int32_t dot_int8_ssse3(const int8_t* a, const int8_t* b, int n) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i pairs = _mm_maddubs_epi16(_mm_abs_epi8(va), _mm_sign_epi8(vb, va));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(pairs, ones));
+    }
+    int32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    int32_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        sum += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+// === AVX2: FMA de 256 bits (Hamming con POPCNT: el popcount por tabla de nibbles con
+// VPSHUFB resultó más lento que POPCNT escalar para códigos de 1 a 8 palabras) ===
+
+__attribute__((target("avx2,fma")))
+static double dot_avx2(const double* a, const double* b, int n) {
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), acc1);
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc0);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2,fma")))
+static double dot_f32_avx2(const float* a, const float* b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, _mm256_add_ps(acc0, acc1));
+    float sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// bfloat16 -> float: extender 8 valores de 16 a 32 bits y desplazar a la mitad alta
+__attribute__((target("avx2,fma")))
+static double dot_bf16_avx2(const bfloat16* a, const float* b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i lo = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        __m256i hi = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 8)));
+        acc0 = _mm256_fmadd_ps(_mm256_castsi256_ps(_mm256_slli_epi32(lo, 16)), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_castsi256_ps(_mm256_slli_epi32(hi, 16)), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        __m256i lo = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        acc0 = _mm256_fmadd_ps(_mm256_castsi256_ps(_mm256_slli_epi32(lo, 16)), _mm256_loadu_ps(b + i), acc0);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, _mm256_add_ps(acc0, acc1));
+    float sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    for (; i < n; ++i) {
+        sum += a[i].to_float() * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+static int32_t dot_int8_avx2(const int8_t* a, const int8_t* b, int n) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i pairs = _mm256_maddubs_epi16(_mm256_abs_epi8(va), _mm256_sign_epi8(vb, va));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(pairs, ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    int32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), half);
+    int32_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        sum += static_cast<int32_t>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+// Suma vertical bit-sliced en registros de 256 bits (un plano completo de 256 ítems).
+// Sumador de acarreo guardado: a + b + c = 2·high + low en cada posición de bit.
+__attribute__((target("avx2")))
+static inline void csa_avx2(__m256i& high, __m256i& low, __m256i a, __m256i b, __m256i c) {
+    const __m256i u = _mm256_xor_si256(a, b);
+    high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+    low = _mm256_xor_si256(u, c);
+}
+
+// Plano i XOR consulta; los planos desde 'count' hasta 16 valen cero
+__attribute__((target("avx2")))
+static inline void load_bit_sliced_group(const uint64_t* planes, const uint64_t* query_masks, int count,
+                                         __m256i* x) {
+    for (int i = 0; i < 16; ++i) {
+        x[i] = (i < count) ? _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes + 4 * i)),
+                                              _mm256_set1_epi64x(static_cast<long long>(query_masks[i])))
+                           : _mm256_setzero_si256();
+    }
+}
+
+// Los 16 planos se reducen con 15 sumadores (Harley-Seal) a 5 planos de peso 1, 2, 4, 8 y
+// 16, que se suman una sola vez a los contadores
+__attribute__((target("avx2")))
+static void bit_sliced_accumulate_avx2(uint64_t* counters, int counter_bits, const uint64_t* planes,
+                                       const uint64_t* query_masks, int count) {
+    __m256i x[16];
+    load_bit_sliced_group(planes, query_masks, count, x);
+
+    __m256i ones = _mm256_setzero_si256(), twos = _mm256_setzero_si256(), fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256(), sixteens;
+    __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    csa_avx2(twos_a, ones, ones, x[0], x[1]);
+    csa_avx2(twos_b, ones, ones, x[2], x[3]);
+    csa_avx2(fours_a, twos, twos, twos_a, twos_b);
+    csa_avx2(twos_a, ones, ones, x[4], x[5]);
+    csa_avx2(twos_b, ones, ones, x[6], x[7]);
+    csa_avx2(fours_b, twos, twos, twos_a, twos_b);
+    csa_avx2(eights_a, fours, fours, fours_a, fours_b);
+    csa_avx2(twos_a, ones, ones, x[8], x[9]);
+    csa_avx2(twos_b, ones, ones, x[10], x[11]);
+    csa_avx2(fours_a, twos, twos, twos_a, twos_b);
+    csa_avx2(twos_a, ones, ones, x[12], x[13]);
+    csa_avx2(twos_b, ones, ones, x[14], x[15]);
+    csa_avx2(fours_b, twos, twos, twos_a, twos_b);
+    csa_avx2(eights_b, fours, fours, fours_a, fours_b);
+    csa_avx2(sixteens, eights, eights, eights_a, eights_b);
+
+    const __m256i local[5] = {ones, twos, fours, eights, sixteens};
+    __m256i carry = _mm256_setzero_si256();
+    for (int c = 0; c < counter_bits; ++c) {
+        __m256i* counter = reinterpret_cast<__m256i*>(counters + 4 * c);
+        __m256i sum;
+        csa_avx2(carry, sum, _mm256_loadu_si256(counter), (c < 5) ? local[c] : _mm256_setzero_si256(), carry);
+        _mm256_storeu_si256(counter, sum);
+    }
+}
+
+// Los 256 contadores a la vez: 'less' marca los ya menores que el umbral y 'equal' los que
+// coinciden con él en los bits vistos
+__attribute__((target("avx2")))
+static void bit_sliced_at_most_avx2(const uint64_t* counters, int counter_bits, int threshold, uint64_t* out) {
+    __m256i less = _mm256_setzero_si256();
+    __m256i equal = _mm256_set1_epi64x(-1);
+    for (int c = counter_bits - 1; c >= 0; --c) {
+        const __m256i bit = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counters + 4 * c));
+        if ((threshold >> c) & 1) {
+            less = _mm256_or_si256(less, _mm256_andnot_si256(bit, equal));
+            equal = _mm256_and_si256(equal, bit);
+        } else {
+            equal = _mm256_andnot_si256(bit, equal);
+        }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_or_si256(less, equal));
+}
+
+// === AVX-512: 8 doubles por FMA; Hamming con VPOPCNTDQ ===
+
+// Sumas horizontales: las macros _mm512_reduce_add_* y las formas no enmascaradas de
+// varios intrínsecos de GCC parten de un _mm*_undefined_*() y avisan con -Wuninitialized.
+// Aquí se guarda el registro y se pliega por mitades (mismo orden que _mm512_reduce_add_pd);
+// donde hace falta otra instrucción se usa su forma maskz con la máscara completa.
+__attribute__((target("avx512f")))
+static inline double sum_lanes(__m512d v) {
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, v);
+    for (int width = 4; width >= 1; width /= 2) {
+        for (int k = 0; k < width; ++k) lanes[k] += lanes[k + width];
+    }
+    return lanes[0];
+}
+
+__attribute__((target("avx512f")))
+static inline float sum_lanes(__m512 v) {
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, v);
+    for (int width = 8; width >= 1; width /= 2) {
+        for (int k = 0; k < width; ++k) lanes[k] += lanes[k + width];
+    }
+    return lanes[0];
+}
+
+__attribute__((target("avx512f")))
+static inline int32_t sum_lanes_epi32(__m512i v) {
+    alignas(64) int32_t lanes[16];
+    _mm512_store_si512(lanes, v);
+    int32_t sum = 0;
+    for (int k = 0; k < 16; ++k) sum += lanes[k];
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+static inline int64_t sum_lanes_epi64(__m512i v) {
+    alignas(64) int64_t lanes[8];
+    _mm512_store_si512(lanes, v);
+    int64_t sum = 0;
+    for (int k = 0; k < 8; ++k) sum += lanes[k];
+    return sum;
+}
+
+// 16 bfloat16 -> 16 float (los 16 bits bajos de cada float a cero)
+__attribute__((target("avx512f")))
+static inline __m512 load_bf16x16(const bfloat16* p) {
+    const __m512i wide = _mm512_maskz_cvtepu16_epi32(0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(0xFFFF, wide, 16));
+}
+
+__attribute__((target("avx512f")))
+static double dot_avx512(const double* a, const double* b, int n) {
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), acc0);
+    }
+    if (i < n) {
+        // Resto con carga enmascarada (las posiciones fuera de rango valen 0)
+        const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), acc1);
+    }
+    return sum_lanes(_mm512_add_pd(acc0, acc1));
+}
+
+__attribute__((target("avx512f")))
+static double dot_f32_avx512(const float* a, const float* b, int n) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < n) {
+        const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+    }
+    return sum_lanes(_mm512_add_ps(acc0, acc1));
+}
+
+// 32 bfloat16 por iteración en dos acumuladores y luego bloques de 16 (el resto, escalar:
+// la carga enmascarada de 16 bits requiere BW)
+__attribute__((target("avx512f")))
+static double dot_bf16_avx512(const bfloat16* a, const float* b, int n) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm512_fmadd_ps(load_bf16x16(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(load_bf16x16(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_ps(load_bf16x16(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    float sum = sum_lanes(_mm512_add_ps(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += a[i].to_float() * b[i];
+    }
+    return sum;
+}
+
+// VPDPBUSD: 4 productos u8 × s8 sumados en cada carril de 32 bits en una instrucción (sin
+// resultados intermedios de 16 bits). VPSIGNB no existe en AVX-512: el signo de a se aplica
+// a b restando con máscara. El resto va con carga enmascarada.
+__attribute__((target("avx512f,avx512bw,avx512vnni")))
+static int32_t dot_int8_avx512vnni(const int8_t* a, const int8_t* b, int n) {
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + i);
+        __m512i vb_signed = _mm512_mask_sub_epi8(vb, _mm512_movepi8_mask(va), zero, vb);
+        acc0 = _mm512_dpbusd_epi32(acc0, _mm512_abs_epi8(va), vb_signed);
+    }
+    if (i < n) {
+        const __mmask64 mask = (1ULL << (n - i)) - 1;
+        __m512i va = _mm512_maskz_loadu_epi8(mask, a + i);
+        __m512i vb = _mm512_maskz_loadu_epi8(mask, b + i);
+        __m512i vb_signed = _mm512_mask_sub_epi8(vb, _mm512_movepi8_mask(va), zero, vb);
+        acc1 = _mm512_dpbusd_epi32(acc1, _mm512_abs_epi8(va), vb_signed);
+    }
+    return sum_lanes_epi32(_mm512_add_epi32(acc0, acc1));
+}
+
+// Suma vertical bit-sliced con VPTERNLOGQ: cada sumador son dos instrucciones (a ^ b ^ c y
+// mayoría) en vez de cinco; mismos registros de 256 bits que la versión AVX2
+__attribute__((target("avx512f,avx512vl")))
+static inline void csa_avx512(__m256i& high, __m256i& low, __m256i a, __m256i b, __m256i c) {
+    high = _mm256_ternarylogic_epi64(a, b, c, 0xE8);
+    low = _mm256_ternarylogic_epi64(a, b, c, 0x96);
+}
+
+__attribute__((target("avx512f,avx512vl")))
+static void bit_sliced_accumulate_avx512(uint64_t* counters, int counter_bits, const uint64_t* planes,
+                                         const uint64_t* query_masks, int count) {
+    __m256i x[16];
+    load_bit_sliced_group(planes, query_masks, count, x);
+
+    __m256i ones = _mm256_setzero_si256(), twos = _mm256_setzero_si256(), fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256(), sixteens;
+    __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    csa_avx512(twos_a, ones, ones, x[0], x[1]);
+    csa_avx512(twos_b, ones, ones, x[2], x[3]);
+    csa_avx512(fours_a, twos, twos, twos_a, twos_b);
+    csa_avx512(twos_a, ones, ones, x[4], x[5]);
+    csa_avx512(twos_b, ones, ones, x[6], x[7]);
+    csa_avx512(fours_b, twos, twos, twos_a, twos_b);
+    csa_avx512(eights_a, fours, fours, fours_a, fours_b);
+    csa_avx512(twos_a, ones, ones, x[8], x[9]);
+    csa_avx512(twos_b, ones, ones, x[10], x[11]);
+    csa_avx512(fours_a, twos, twos, twos_a, twos_b);
+    csa_avx512(twos_a, ones, ones, x[12], x[13]);
+    csa_avx512(twos_b, ones, ones, x[14], x[15]);
+    csa_avx512(fours_b, twos, twos, twos_a, twos_b);
+    csa_avx512(eights_b, fours, fours, fours_a, fours_b);
+    csa_avx512(sixteens, eights, eights, eights_a, eights_b);
+
+    const __m256i local[5] = {ones, twos, fours, eights, sixteens};
+    __m256i carry = _mm256_setzero_si256();
+    for (int c = 0; c < counter_bits; ++c) {
+        __m256i* counter = reinterpret_cast<__m256i*>(counters + 4 * c);
+        __m256i sum;
+        csa_avx512(carry, sum, _mm256_loadu_si256(counter), (c < 5) ? local[c] : _mm256_setzero_si256(), carry);
+        _mm256_storeu_si256(counter, sum);
+    }
+}
+
+// Con el bit del umbral a 1: less |= equal & ~bit y equal &= bit en una instrucción cada uno
+__attribute__((target("avx512f,avx512vl")))
+static void bit_sliced_at_most_avx512(const uint64_t* counters, int counter_bits, int threshold, uint64_t* out) {
+    __m256i less = _mm256_setzero_si256();
+    __m256i equal = _mm256_set1_epi64x(-1);
+    for (int c = counter_bits - 1; c >= 0; --c) {
+        const __m256i bit = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counters + 4 * c));
+        if ((threshold >> c) & 1) {
+            less = _mm256_ternarylogic_epi64(less, equal, bit, 0xF4);
+            equal = _mm256_and_si256(equal, bit);
+        } else {
+            equal = _mm256_andnot_si256(bit, equal);
+        }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_or_si256(less, equal));
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+static void hamming_scan_avx512(const uint64_t* query, const uint64_t* codes, int n, int num_words,
+                                int* distances) {
+    int row = 0;
+    if (8 % num_words == 0) {
+        // 8 / num_words códigos por registro de 512 bits; las palabras de cada código se suman
+        // dentro del registro (pares, cuartetos, octetos) y las distancias se compactan
+        const int per_vector = 8 / num_words;
+        alignas(64) uint64_t pattern[8];
+        for (int i = 0; i < 8; ++i) pattern[i] = query[i % num_words];
+        const __m512i q = _mm512_load_si512(pattern);
+        const __m512i swap_1 = _mm512_set_epi64(6, 7, 4, 5, 2, 3, 0, 1);
+        const __m512i swap_2 = _mm512_set_epi64(5, 4, 7, 6, 1, 0, 3, 2);
+        const __m512i swap_4 = _mm512_set_epi64(3, 2, 1, 0, 7, 6, 5, 4);
+        // Carril que queda con el total de cada código
+        const __mmask8 totals = (num_words == 1) ? 0xFF : (num_words == 2) ? 0x55 : (num_words == 4) ? 0x11 : 0x01;
+        const __mmask8 store_mask = static_cast<__mmask8>((1u << per_vector) - 1);
+
+        for (; row + per_vector <= n; row += per_vector) {
+            const __m512i c = _mm512_loadu_si512(codes + static_cast<size_t>(row) * num_words);
+            __m512i sums = _mm512_popcnt_epi64(_mm512_xor_si512(c, q));
+            if (num_words >= 2) sums = _mm512_add_epi64(sums, _mm512_maskz_permutexvar_epi64(0xFF, swap_1, sums));
+            if (num_words >= 4) sums = _mm512_add_epi64(sums, _mm512_maskz_permutexvar_epi64(0xFF, swap_2, sums));
+            if (num_words >= 8) sums = _mm512_add_epi64(sums, _mm512_maskz_permutexvar_epi64(0xFF, swap_4, sums));
+            _mm512_mask_cvtepi64_storeu_epi32(distances + row, store_mask, _mm512_maskz_compress_epi64(totals, sums));
+        }
+        hamming_scan_popcnt(query, codes + static_cast<size_t>(row) * num_words, n - row, num_words, distances + row);
+        return;
+    }
+
+    // Múltiplos de 8 palabras (y otras longitudes): bloques de 8 palabras con la cola enmascarada
+    for (; row < n; ++row) {
+        const uint64_t* code = codes + static_cast<size_t>(row) * num_words;
+        __m512i acc = _mm512_setzero_si512();
+        for (int w = 0; w < num_words; w += 8) {
+            const int remaining = std::min(8, num_words - w);
+            const __mmask8 mask = static_cast<__mmask8>((1u << remaining) - 1);
+            const __m512i x = _mm512_xor_si512(_mm512_maskz_loadu_epi64(mask, code + w),
+                                               _mm512_maskz_loadu_epi64(mask, query + w));
+            acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+        }
+        distances[row] = static_cast<int>(sum_lanes_epi64(acc));
+    }
+}
+
+#endif // SRPR_X86_DISPATCH
+
+// === Selección ===
+
+SimdLevel SimdKernels::best_supported_level() {
+    const CpuFeatures& cpu = CpuFeatures::get();
+    if (cpu.avx512f && cpu.avx2 && cpu.fma && cpu.popcnt) return SimdLevel::AVX512;
+    if (cpu.avx2 && cpu.fma && cpu.popcnt) return SimdLevel::AVX2;
+    if (cpu.sse42 && cpu.popcnt) return SimdLevel::SSE42;
+    return SimdLevel::Scalar;
+}
+
+SimdKernels::SimdKernels(SimdLevel level)
+    : simd_level(std::min(level, best_supported_level())), use_vpopcntdq(false), use_vnni(false),
+      use_ternlog(false), dot_kernel(&dot_scalar), float_dot_kernel(&dot_f32_scalar),
+      bf16_dot_kernel(&dot_bf16_scalar), int8_dot_kernel(&dot_int8_scalar),
+      bit_sliced_kernel(&bit_sliced_accumulate_scalar), bit_sliced_at_most_kernel(&bit_sliced_at_most_scalar) {
+#ifdef SRPR_X86_DISPATCH
+    switch (simd_level) {
+        case SimdLevel::AVX512:
+            dot_kernel = &dot_avx512;
+            float_dot_kernel = &dot_f32_avx512;
+            bf16_dot_kernel = &dot_bf16_avx512;
+            use_vpopcntdq = CpuFeatures::get().avx512_vpopcntdq;
+            use_vnni = CpuFeatures::get().avx512bw && CpuFeatures::get().avx512_vnni;
+            int8_dot_kernel = use_vnni ? &dot_int8_avx512vnni : &dot_int8_avx2;
+            use_ternlog = CpuFeatures::get().avx512vl;
+            bit_sliced_kernel = use_ternlog ? &bit_sliced_accumulate_avx512 : &bit_sliced_accumulate_avx2;
+            bit_sliced_at_most_kernel = use_ternlog ? &bit_sliced_at_most_avx512 : &bit_sliced_at_most_avx2;
+            break;
+        case SimdLevel::AVX2:
+            dot_kernel = &dot_avx2;
+            float_dot_kernel = &dot_f32_avx2;
+            bf16_dot_kernel = &dot_bf16_avx2;
+            int8_dot_kernel = &dot_int8_avx2;
+            bit_sliced_kernel = &bit_sliced_accumulate_avx2;
+            bit_sliced_at_most_kernel = &bit_sliced_at_most_avx2;
+            break;
+        case SimdLevel::SSE42:
+            dot_kernel = &dot_sse2;
+            float_dot_kernel = &dot_f32_sse2;
+            bf16_dot_kernel = &dot_bf16_sse2;
+            int8_dot_kernel = &dot_int8_ssse3;
+            break;
+        case SimdLevel::Scalar:
+            break;
+    }
+#else
+    simd_level = SimdLevel::Scalar;
+#endif
+}
+
+SimdKernels SimdKernels::for_level(SimdLevel level) {
+    return SimdKernels(level);
+}
+
+const SimdKernels& SimdKernels::active() {
+    static const SimdKernels kernels = []() {
+        SimdLevel level = best_supported_level();
+        const char* requested = std::getenv("SRPR_SIMD_LEVEL");
+        if (requested) {
+            for (SimdLevel candidate : {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512}) {
+                if (std::strcmp(requested, simd_level_name(candidate)) == 0) {
+                    level = std::min(level, candidate);
+                }
+            }
+        }
+        return SimdKernels(level);
+    }();
+    return kernels;
+}
+
+HammingScanKernel SimdKernels::hamming_scan(int num_words) const {
+#ifdef SRPR_X86_DISPATCH
+    switch (simd_level) {
+        case SimdLevel::AVX512:
+            // Con 3, 5, 6, 7... palabras los bloques enmascarados no ganan a POPCNT
+            if (use_vpopcntdq && (8 % num_words == 0 || num_words % 8 == 0)) return &hamming_scan_avx512;
+            return select_popcnt_scan(num_words);
+        case SimdLevel::AVX2:
+        case SimdLevel::SSE42:
+            return select_popcnt_scan(num_words);
+        case SimdLevel::Scalar:
+            break;
+    }
+#endif
+    return select_hamming_scan(num_words);
+}
+
+HammingGatherKernel SimdKernels::hamming_gather(int num_words) const {
+#ifdef SRPR_X86_DISPATCH
+    // Acceso disperso: POPCNT escalar en todos los niveles con la instrucción
+    if (simd_level != SimdLevel::Scalar) return select_popcnt_gather(num_words);
+#else
+    (void)num_words;
+#endif
+    return &hamming_gather_generic;
+}
+
+std::string SimdKernels::description() const {
+    std::string dot_name = "scalar";
+    std::string int8_name = "scalar";
+    std::string hamming_name = "scalar";
+    std::string bit_sliced_name = "scalar";
+    switch (simd_level) {
+        case SimdLevel::AVX512:
+            dot_name = "avx512f";
+            int8_name = use_vnni ? "avx512vnni" : "avx2";
+            hamming_name = use_vpopcntdq ? "avx512vpopcntdq" : "popcnt";
+            bit_sliced_name = use_ternlog ? "avx512vl" : "avx2";
+            break;
+        case SimdLevel::AVX2:
+            dot_name = "avx2+fma";
+            int8_name = "avx2";
+            hamming_name = "popcnt";
+            bit_sliced_name = "avx2";
+            break;
+        case SimdLevel::SSE42:
+            dot_name = "sse2";
+            int8_name = "ssse3";
+            hamming_name = "popcnt";
+            break;
+        case SimdLevel::Scalar:
+            break;
+    }
+    return std::string(simd_level_name(simd_level)) + " (dot: " + dot_name + ", int8: " + int8_name + ", hamming: " + hamming_name +
+           ", bit-sliced: " + bit_sliced_name + ")";
+}
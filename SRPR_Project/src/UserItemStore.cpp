@@ -1,8 +1,34 @@
 #include "../include/UserItemStore.h"
+#include "../include/SimdKernels.h"
+#include <cmath>
 #include <iostream>
 #include <set>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 
-UserItemStore::UserItemStore(int dimensions) : d(dimensions), rng(std::random_device{}()), dist(0.0, 0.1) {}
+UserItemStore::UserItemStore(int dimensions, StorageLayout layout)
+    : d(dimensions), layout(layout), stride((std::max(dimensions, 0) + 7) / 8 * 8),
+      modification_count(0), rng(std::random_device{}()), dist(0.0, 0.1) {}
+
+// Modo Dense: une 'new_ids' a las filas existentes (ids ascendentes) y copia los vectores
+// ya presentes a su nueva fila; las filas nuevas quedan en cero
+static void grow_dense(const std::vector<int>& old_ids, AlignedDoubleArray& storage, int stride,
+                       const std::set<int>& new_ids, std::vector<int>& merged_ids) {
+    merged_ids.clear();
+    std::set_union(old_ids.begin(), old_ids.end(), new_ids.begin(), new_ids.end(), std::back_inserter(merged_ids));
+    if (merged_ids.size() == old_ids.size()) return;
+
+    AlignedDoubleArray grown(merged_ids.size() * stride, 0.0);
+    size_t row = 0;
+    for (size_t old_row = 0; old_row < old_ids.size(); ++old_row) {
+        while (merged_ids[row] != old_ids[old_row]) ++row;
+        std::copy(storage.begin() + old_row * stride, storage.begin() + (old_row + 1) * stride,
+                  grown.begin() + row * stride);
+    }
+    storage.swap(grown);
+}
 
 void UserItemStore::initialize(const std::vector<Triplet>& triplets) {
     std::set<int> user_ids;
@@ -14,6 +40,31 @@ void UserItemStore::initialize(const std::vector<Triplet>& triplets) {
         item_ids.insert(t.less_preferred_item_id);
     }
 
+    if (layout == StorageLayout::Dense) {
+        // Mismo orden de muestreo que el modo Map: usuarios y luego ítems, ids ascendentes
+        std::vector<int> merged;
+        grow_dense(user_index.ids, user_storage, stride, user_ids, merged);
+        user_index.build(merged);
+        grow_dense(item_index.ids, item_storage, stride, item_ids, merged);
+        item_index.build(merged);
+
+        for (int id : user_ids) {
+            double* row = user_storage.data() + static_cast<size_t>(user_index.row_of(id)) * stride;
+            for (int i = 0; i < d; ++i) {
+                row[i] = dist(rng);
+            }
+        }
+        for (int id : item_ids) {
+            double* row = item_storage.data() + static_cast<size_t>(item_index.row_of(id)) * stride;
+            for (int i = 0; i < d; ++i) {
+                row[i] = dist(rng);
+            }
+        }
+        build_rows();
+        recompute_norms();
+        return;
+    }
+
     for (int id : user_ids) {
         user_vectors[id] = Vector(d);
         for (int i = 0; i < d; ++i) {
@@ -27,31 +78,184 @@ void UserItemStore::initialize(const std::vector<Triplet>& triplets) {
             item_vectors[id][i] = dist(rng);
         }
     }
+
+    std::vector<int> ids;
+    for (const auto& user_pair : user_vectors) ids.push_back(user_pair.first);
+    std::sort(ids.begin(), ids.end());
+    user_index.build(ids);
+    ids.clear();
+    for (const auto& item_pair : item_vectors) ids.push_back(item_pair.first);
+    std::sort(ids.begin(), ids.end());
+    item_index.build(ids);
+    build_rows();
+    recompute_norms();
+}
+
+void UserItemStore::IdIndex::build(std::vector<int> sorted_ids) {
+    ids.swap(sorted_ids);
+    table.clear();
+    if (ids.empty()) return;
+
+    // Tabla directa sólo si el rango de ids no es mucho mayor que su cantidad
+    min_id = ids.front();
+    long long range = static_cast<long long>(ids.back()) - min_id + 1;
+    if (range <= 4LL * static_cast<long long>(ids.size()) + 1024) {
+        table.assign(static_cast<size_t>(range), -1);
+        for (size_t row = 0; row < ids.size(); ++row) {
+            table[ids[row] - min_id] = static_cast<int>(row);
+        }
+    }
+}
+
+void UserItemStore::build_rows() {
+    user_rows.resize(user_index.ids.size());
+    item_rows.resize(item_index.ids.size());
+    if (layout == StorageLayout::Dense) {
+        for (size_t row = 0; row < user_rows.size(); ++row) user_rows[row] = user_storage.data() + row * stride;
+        for (size_t row = 0; row < item_rows.size(); ++row) item_rows[row] = item_storage.data() + row * stride;
+    } else {
+        // Los nodos del unordered_map y el buffer de cada Vector no se mueven al rehashear
+        for (size_t row = 0; row < user_rows.size(); ++row) user_rows[row] = user_vectors.at(user_index.ids[row]).data();
+        for (size_t row = 0; row < item_rows.size(); ++row) item_rows[row] = item_vectors.at(item_index.ids[row]).data();
+    }
+}
+
+// Norma L2 de una fila con el kernel SIMD elegido al arrancar
+static double row_norm(const double* v, int d) {
+    return std::sqrt(SimdKernels::active().dot(v, v, d));
+}
+
+void UserItemStore::recompute_norms() {
+    user_norms.resize(user_rows.size());
+    item_norms.resize(item_rows.size());
+    for (size_t row = 0; row < user_rows.size(); ++row) user_norms[row] = row_norm(user_rows[row], d);
+    for (size_t row = 0; row < item_rows.size(); ++row) item_norms[row] = row_norm(item_rows[row], d);
+    if (!normalized_items.empty()) {
+        build_normalized_items();
+    }
+}
+
+void UserItemStore::build_normalized_items() {
+    normalized_items.assign(item_rows.size() * stride, 0.0);
+    for (int row = 0; row < num_items(); ++row) {
+        normalize_item_row(row);
+    }
+}
+
+void UserItemStore::release_normalized_items() {
+    AlignedDoubleArray().swap(normalized_items);
+}
+
+void UserItemStore::normalize_item_row(int row) {
+    const double* in = item_rows[row];
+    double* out = normalized_items.data() + static_cast<size_t>(row) * stride;
+    const double n = item_norms[row];
+    for (int i = 0; i < d; ++i) {
+        out[i] = n > 0.0 ? in[i] / n : 0.0;
+    }
+}
+
+// Acceso por Vector: sólo en el modo Map
+static void require_map_layout(StorageLayout layout, const char* method) {
+    if (layout != StorageLayout::Map) {
+        throw std::logic_error(std::string("UserItemStore::") + method +
+                               " requiere StorageLayout::Map (usar el acceso por fila)");
+    }
 }
 
 Vector& UserItemStore::get_user_vector(int user_id) {
+    require_map_layout(layout, "get_user_vector");
     return user_vectors.at(user_id);
 }
 
 Vector& UserItemStore::get_item_vector(int item_id) {
+    require_map_layout(layout, "get_item_vector");
     return item_vectors.at(item_id);
 }
 
 const Vector& UserItemStore::get_user_vector(int user_id) const {
+    require_map_layout(layout, "get_user_vector");
     return user_vectors.at(user_id);
 }
 
 const Vector& UserItemStore::get_item_vector(int item_id) const {
+    require_map_layout(layout, "get_item_vector");
     return item_vectors.at(item_id);
 }
 
 const std::unordered_map<int, Vector>& UserItemStore::get_all_item_vectors() const {
+    require_map_layout(layout, "get_all_item_vectors");
     return item_vectors;
 }
 
+Vector UserItemStore::copy_user_vector(int user_id) const {
+    int row = user_row(user_id);
+    if (row < 0) {
+        throw std::out_of_range("UserItemStore: usuario " + std::to_string(user_id) + " no existe");
+    }
+    return Vector(user_data(row), user_data(row) + d);
+}
+
+Vector UserItemStore::copy_item_vector(int item_id) const {
+    int row = item_row(item_id);
+    if (row < 0) {
+        throw std::out_of_range("UserItemStore: ítem " + std::to_string(item_id) + " no existe");
+    }
+    return Vector(item_data(row), item_data(row) + d);
+}
+
+size_t UserItemStore::memory_bytes() const {
+    size_t bytes = 0;
+    if (layout == StorageLayout::Dense) {
+        bytes += (user_storage.size() + item_storage.size()) * sizeof(double);
+    } else {
+        bytes += (user_vectors.size() + item_vectors.size()) * static_cast<size_t>(d) * sizeof(double);
+    }
+    bytes += (user_index.ids.size() + user_index.table.size() + item_index.ids.size() + item_index.table.size()) * sizeof(int);
+    bytes += (user_rows.size() + item_rows.size()) * sizeof(double*);
+    bytes += (user_norms.size() + item_norms.size() + normalized_items.size()) * sizeof(double);
+    return bytes;
+}
+
+void UserItemStore::mark_user_dirty(int user_id) {
+    int row = user_row(user_id);
+    if (row >= 0) {
+        user_norms[row] = row_norm(user_rows[row], d);
+    }
+    ++modification_count;
+    if (dirty_user_set.insert(user_id).second) {
+        dirty_users.push_back(user_id);
+    }
+}
+
+void UserItemStore::mark_item_dirty(int item_id) {
+    int row = item_row(item_id);
+    if (row >= 0) {
+        item_norms[row] = row_norm(item_rows[row], d);
+        if (!normalized_items.empty()) normalize_item_row(row);
+    }
+    ++modification_count;
+    if (dirty_item_set.insert(item_id).second) {
+        dirty_items.push_back(item_id);
+    }
+}
+
+void UserItemStore::clear_dirty_users() {
+    dirty_users.clear();
+    dirty_user_set.clear();
+}
+
+void UserItemStore::clear_dirty_items() {
+    dirty_items.clear();
+    dirty_item_set.clear();
+}
+
 void UserItemStore::print_summary() const {
     std::cout << "UserItemStore Resumen:" << std::endl;
-    std::cout << "  - " << user_vectors.size() << " usuarios." << std::endl;
-    std::cout << "  - " << item_vectors.size() << " items." << std::endl;
+    std::cout << "  - " << num_users() << " usuarios." << std::endl;
+    std::cout << "  - " << num_items() << " items." << std::endl;
     std::cout << "  - Dimensiones: " << d << std::endl;
+    std::cout << "  - Disposición: " << (layout == StorageLayout::Dense
+        ? "densa (matrices contiguas, filas de " + std::to_string(stride) + " doubles alineadas a 64 bytes)"
+        : std::string("unordered_map (un Vector por id)")) << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef TEST_DATA_H
+#define TEST_DATA_H
+
+#include "../include/Triplet.h"
+#include "../include/UserItemStore.h"
+#include <vector>
+#include <random>
+
+// Datos sintéticos compartidos por las pruebas, para no depender de archivos de datos
+
+// 'per_user' tripletas por usuario (ids 1..num_users) con ítems uniformes en 1..num_items
+inline std::vector<Triplet> make_synthetic_triplets(int num_users, int num_items, int per_user,
+                                                    unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> item_dist(1, num_items);
+    std::vector<Triplet> triplets;
+    for (int u = 1; u <= num_users; ++u) {
+        for (int t = 0; t < per_user; ++t) {
+            triplets.push_back({u, item_dist(rng), item_dist(rng)});
+        }
+    }
+    return triplets;
+}
+
+// Catálogo agrupado (ids 1..num_items, usuarios 1..num_users, modo Map): cada ítem es uno
+// de 'num_centers' centros más ruido N(0, noise²) y cada usuario cae cerca de otro centro,
+// como embeddings entrenados, donde los vecinos Hamming están mucho más cerca que el resto
+inline void make_clustered_store(UserItemStore& store, int num_users, int num_items, int num_centers,
+                                 int dimensions, double noise, unsigned int seed) {
+    std::vector<Triplet> triplets;
+    for (int i = 1; i <= num_items; ++i) {
+        triplets.push_back({1 + i % num_users, i, 1 + static_cast<int>(static_cast<long long>(i) * 7 % num_items)});
+    }
+    store.initialize(triplets);
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<Vector> centers(num_centers, Vector(dimensions));
+    for (Vector& c : centers) {
+        for (double& x : c) x = dist(rng);
+    }
+    for (int i = 1; i <= num_items; ++i) {
+        Vector& v = store.get_item_vector(i);
+        const Vector& c = centers[i % num_centers];
+        for (int k = 0; k < dimensions; ++k) v[k] = c[k] + noise * dist(rng);
+    }
+    for (int u = 1; u <= num_users; ++u) {
+        Vector& v = store.get_user_vector(u);
+        const Vector& c = centers[(u * 7) % num_centers];
+        for (int k = 0; k < dimensions; ++k) v[k] = c[k] + noise * dist(rng);
+    }
+}
+
+#endif // TEST_DATA_H
@@ -0,0 +1,83 @@
+#include "../include/BitSlicedCodeStore.h"
+#include "../include/LSHIndex.h"
+#include "../include/LSH.h"
+#include "../include/UserItemStore.h"
+#include "../include/Triplet.h"
+#include "TestData.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+int main() {
+    std::cout << "=== Prueba de BitSlicedCodeStore (códigos traspuestos por bits) ===" << std::endl;
+
+    const int dimensions = 16;
+    const int num_users = 40;
+    const int num_items = 200003;
+    const int top_k = 10;
+
+    UserItemStore store(dimensions);
+    make_clustered_store(store, num_users, num_items, 200, dimensions, 0.3, 11);
+    store.print_summary();
+
+    for (int bits : {64, 100, 256, 512}) {
+        std::cout << "\n--- Códigos de " << bits << " bits ---" << std::endl;
+
+        SRPHasher hasher(dimensions, bits, 42);
+        LSHIndex index(hasher);
+        index.build(store);
+
+        BitSlicedCodeStore sliced(index);
+        sliced.build();
+
+        // === PRUEBA 1: Distancias de bloque ===
+        PackedCode query = index.encode(store.get_user_vector(1));
+        std::vector<int> block_distances(BitSlicedCodeStore::BLOCK_ITEMS);
+        int last_block = sliced.get_num_blocks() - 1;
+        for (int block : {0, last_block}) {
+            sliced.compute_block_distances(query, block, block_distances.data());
+            for (int slot = 0; slot < BitSlicedCodeStore::BLOCK_ITEMS; ++slot) {
+                int row = block * BitSlicedCodeStore::BLOCK_ITEMS + slot;
+                if (row >= index.size()) break;
+                int expected = hamming_distance_words(query.words.data(), index.code_at(row), index.get_code_words());
+                if (block_distances[slot] != expected) {
+                    std::cerr << "ERROR: Distancia vertical incorrecta en la fila " << row << std::endl;
+                    return 1;
+                }
+            }
+        }
+        std::cout << "✓ Sumas verticales idénticas a XOR + POPCNT (incluido el último bloque parcial)" << std::endl;
+
+        // === PRUEBA 2: Top-k idéntico y rendimiento ===
+        double packed_us = 0.0, sliced_us = 0.0, pruned_sum = 0.0;
+        for (int user_id = 1; user_id <= num_users; ++user_id) {
+            PackedCode user_code = index.encode(store.get_user_vector(user_id));
+
+            auto packed_start = std::chrono::high_resolution_clock::now();
+            auto expected = index.search(user_code, top_k);
+            auto packed_end = std::chrono::high_resolution_clock::now();
+            int pruned = 0;
+            auto results = sliced.search(user_code, top_k, &pruned);
+            auto sliced_end = std::chrono::high_resolution_clock::now();
+
+            packed_us += std::chrono::duration<double, std::micro>(packed_end - packed_start).count();
+            sliced_us += std::chrono::duration<double, std::micro>(sliced_end - packed_end).count();
+            pruned_sum += pruned;
+
+            if (results != expected) {
+                std::cerr << "ERROR: Top-k bit-sliced difiere de LSHIndex::search para usuario " << user_id << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "✓ Top-" << top_k << " idéntico a LSHIndex::search (" << num_users << " consultas)" << std::endl;
+        std::cout << "  - Empaquetado: " << std::fixed << std::setprecision(0) << packed_us / num_users
+                  << " μs, bit-sliced: " << sliced_us / num_users << " μs, bloques podados: "
+                  << std::setprecision(1) << 100.0 * pruned_sum / (num_users * sliced.get_num_blocks()) << "%"
+                  << " (" << sliced.memory_bytes() / (1024 * 1024) << " MB)" << std::endl;
+    }
+
+    std::cout << "\n🎉 ¡Todas las pruebas de BitSlicedCodeStore completadas exitosamente!" << std::endl;
+    return 0;
+}
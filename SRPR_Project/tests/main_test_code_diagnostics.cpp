@@ -0,0 +1,187 @@
+#include "../include/CodeDiagnostics.h"
+#include "../include/LSH.h"
+#include "../include/PackedCode.h"
+#include <iostream>
+#include <vector>
+#include <map>
+#include <set>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+int main() {
+    std::cout << "=== Prueba de CodeDiagnostics (distribución de códigos) ===" << std::endl;
+
+    // Códigos de 70 bits (2 palabras) con propiedades conocidas:
+    //   bit 0 siempre 1, bit 1 = bit 2, bit 3 = NOT bit 2, bit 69 con p = 0.9, resto aleatorio
+    const int num_bits = 70;
+    const int words = code_words_for_bits(num_bits);
+    const int n = 20011;
+    std::mt19937_64 rng(3);
+    std::vector<uint64_t> codes(static_cast<size_t>(n) * words);
+    for (int row = 0; row < n; ++row) {
+        PackedCode code(num_bits);
+        for (int i = 0; i < num_bits; ++i) {
+            if (rng() & 1ULL) code.set_bit(i);
+        }
+        code.words[0] |= 1ULL;
+        code.words[0] &= ~(3ULL << 2);
+        if (code.get_bit(1)) code.set_bit(2);
+        if (!code.get_bit(2)) code.set_bit(3);
+        code.words[1] &= ~(1ULL << 5);
+        if (rng() % 10 != 0) code.set_bit(69);
+        std::copy(code.words.begin(), code.words.end(), codes.begin() + static_cast<size_t>(row) * words);
+    }
+    auto bit = [&](int row, int i) {
+        return static_cast<int>((codes[static_cast<size_t>(row) * words + (i >> 6)] >> (i & 63)) & 1ULL);
+    };
+
+    // === PRUEBA 1: Balance y correlaciones contra el cálculo directo ===
+    std::cout << "\n--- Prueba 1: Balance por bit y correlación phi ---" << std::endl;
+    auto start = std::chrono::high_resolution_clock::now();
+    CodeDiagnostics diagnostics = CodeDiagnostics::analyze(codes.data(), n, num_bits, {4, 8, 12, 0, 99, 8});
+    auto end = std::chrono::high_resolution_clock::now();
+    diagnostics.print_summary();
+    std::cout << "  - Tiempo: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " μs" << std::endl;
+
+    for (int i = 0; i < num_bits; ++i) {
+        for (int j = i + 1; j < num_bits; ++j) {
+            double ones_i = 0, ones_j = 0, both = 0;
+            for (int row = 0; row < n; ++row) {
+                ones_i += bit(row, i);
+                ones_j += bit(row, j);
+                both += bit(row, i) & bit(row, j);
+            }
+            double variance = ones_i * (n - ones_i) * ones_j * (n - ones_j);
+            double expected = variance > 0 ? (n * both - ones_i * ones_j) / std::sqrt(variance) : 0.0;
+            if (std::fabs(diagnostics.bit_correlation[i * num_bits + j] - expected) > 1e-9 ||
+                diagnostics.bit_correlation[j * num_bits + i] != diagnostics.bit_correlation[i * num_bits + j]) {
+                std::cerr << "ERROR: Correlación de los bits " << i << " y " << j << " incorrecta" << std::endl;
+                return 1;
+            }
+            if (j == i + 1 && std::fabs(diagnostics.bit_balance[i] - ones_i / n) > 1e-12) {
+                std::cerr << "ERROR: Balance del bit " << i << " incorrecto" << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (diagnostics.bit_balance[0] != 1.0 || std::fabs(diagnostics.max_bit_imbalance - 0.5) > 1e-12 ||
+        std::fabs(diagnostics.bit_balance[69] - 0.9) > 0.02) {
+        std::cerr << "ERROR: Balance de los bits constante/sesgado incorrecto" << std::endl;
+        return 1;
+    }
+    if (std::fabs(diagnostics.bit_correlation[1 * num_bits + 2] - 1.0) > 1e-12 ||
+        std::fabs(diagnostics.bit_correlation[2 * num_bits + 3] + 1.0) > 1e-12 ||
+        diagnostics.bit_correlation[0 * num_bits + 5] != 0.0 || diagnostics.max_abs_correlation < 1.0 - 1e-12) {
+        std::cerr << "ERROR: Correlaciones de los bits duplicados/complementarios incorrectas" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Balance y phi idénticos al cálculo directo (bit constante -> phi 0, duplicado -> 1, "
+              << "complemento -> -1)" << std::endl;
+
+    // === PRUEBA 2: Ocupación de prefijos y entropía ===
+    std::cout << "\n--- Prueba 2: Buckets por prefijo y entropía ---" << std::endl;
+    std::vector<int> expected_bits = {4, 8, 12};
+    if (diagnostics.prefixes.size() != expected_bits.size()) {
+        std::cerr << "ERROR: Prefijos fuera de rango o duplicados no descartados" << std::endl;
+        return 1;
+    }
+    for (size_t p = 0; p < expected_bits.size(); ++p) {
+        const CodeDiagnostics::PrefixOccupancy& occupancy = diagnostics.prefixes[p];
+        std::map<uint64_t, long long> buckets;
+        for (int row = 0; row < n; ++row) {
+            buckets[extract_bits(codes.data() + static_cast<size_t>(row) * words, 0, expected_bits[p])]++;
+        }
+        long long max_size = 0, histogram_total = 0;
+        double squares = 0.0, entropy = 0.0;
+        for (const auto& bucket : buckets) {
+            max_size = std::max(max_size, bucket.second);
+            squares += static_cast<double>(bucket.second) * bucket.second;
+            double prob = static_cast<double>(bucket.second) / n;
+            entropy -= prob * std::log2(prob);
+        }
+        for (long long count : occupancy.size_histogram) histogram_total += count;
+        if (occupancy.bits != expected_bits[p] || occupancy.occupied_buckets != static_cast<long long>(buckets.size()) ||
+            occupancy.max_bucket_size != max_size || std::fabs(occupancy.expected_candidates - squares / n) > 1e-9 ||
+            std::fabs(occupancy.entropy - entropy) > 1e-9 || histogram_total != occupancy.occupied_buckets) {
+            std::cerr << "ERROR: Ocupación del prefijo de " << expected_bits[p] << " bits incorrecta" << std::endl;
+            return 1;
+        }
+    }
+    // En los 4 primeros bits sólo el bit 1 es libre (0 constante, 2 y 3 derivados de él)
+    if (diagnostics.prefixes[0].occupied_buckets != 2 || std::fabs(diagnostics.prefixes[0].entropy - 1.0) > 0.01) {
+        std::cerr << "ERROR: El prefijo de 4 bits debería tener 2 buckets (1 bit de entropía)" << std::endl;
+        return 1;
+    }
+
+    std::set<std::vector<uint64_t>> unique;
+    for (int row = 0; row < n; ++row) {
+        unique.insert(std::vector<uint64_t>(codes.begin() + static_cast<size_t>(row) * words,
+                                            codes.begin() + static_cast<size_t>(row + 1) * words));
+    }
+    if (diagnostics.unique_codes != static_cast<long long>(unique.size()) ||
+        std::fabs(diagnostics.code_entropy - std::log2(static_cast<double>(n))) > 1e-6) {
+        std::cerr << "ERROR: Códigos distintos o entropía de códigos incorrectos" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Buckets, candidatos esperados, histograma y entropía coinciden con std::map" << std::endl;
+
+    // === PRUEBA 3: JSON y casos límite ===
+    std::cout << "\n--- Prueba 3: Salida JSON y casos límite ---" << std::endl;
+    std::string json = diagnostics.to_json();
+    std::string compact = diagnostics.to_json(false);
+    int depth = 0;
+    bool balanced = true;
+    for (char c : json) {
+        if (c == '{' || c == '[') ++depth;
+        if (c == '}' || c == ']') --depth;
+        if (depth < 0) balanced = false;
+    }
+    if (!balanced || depth != 0 || json.front() != '{' || json.find("\"bit_balance\"") == std::string::npos ||
+        json.find("\"matrix\"") == std::string::npos || compact.find("\"matrix\"") != std::string::npos ||
+        json.find("\"expected_candidates\"") == std::string::npos || json.find("nan") != std::string::npos) {
+        std::cerr << "ERROR: JSON mal formado o incompleto" << std::endl;
+        return 1;
+    }
+    std::cout << "  - JSON: " << json.size() << " bytes (" << compact.size() << " sin matriz)" << std::endl;
+
+    CodeDiagnostics empty = CodeDiagnostics::analyze(nullptr, 0, 16, {8});
+    bool threw = false;
+    try {
+        CodeDiagnostics::analyze(codes.data(), n, 0, {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    if (empty.num_codes != 0 || empty.diversity() != 0.0 || !empty.prefixes.empty() || !threw) {
+        std::cerr << "ERROR: Casos límite (conjunto vacío / num_bits <= 0)" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ JSON balanceado; conjunto vacío sin métricas y num_bits <= 0 rechazado" << std::endl;
+
+    // === PRUEBA 4: Códigos SRP reales ===
+    std::cout << "\n--- Prueba 4: Códigos SRP de vectores gaussianos ---" << std::endl;
+    const int dimensions = 32, bits = 64, items = 50000;
+    SRPHasher hasher(dimensions, bits, 42);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<double> vectors(static_cast<size_t>(items) * dimensions);
+    for (double& x : vectors) x = dist(rng);
+    std::vector<uint64_t> srp_codes(static_cast<size_t>(items) * hasher.code_words());
+    hasher.hash_batch(vectors.data(), items, dimensions, srp_codes.data());
+
+    start = std::chrono::high_resolution_clock::now();
+    CodeDiagnostics srp = CodeDiagnostics::analyze(srp_codes.data(), items, bits, {8, 16});
+    end = std::chrono::high_resolution_clock::now();
+    srp.print_summary();
+    std::cout << "  - Tiempo: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << " ms" << std::endl;
+    if (srp.max_bit_imbalance > 0.05 || srp.diversity() < 0.99 || srp.prefixes[0].entropy < 7.5) {
+        std::cerr << "ERROR: SRP sobre datos isótropos debería dar bits balanceados y códigos distintos" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Bits balanceados y prefijos casi uniformes en datos isótropos" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de CodeDiagnostics completadas exitosamente!" << std::endl;
+    return 0;
+}
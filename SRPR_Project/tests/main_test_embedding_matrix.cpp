@@ -0,0 +1,189 @@
+#include "../include/EmbeddingMatrix.h"
+#include "../include/LSH.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+int main() {
+    std::cout << "=== Prueba de EmbeddingMatrix (almacenamiento float / bf16) ===" << std::endl;
+
+    // === PRUEBA 1: Conversión a bfloat16 ===
+    std::cout << "\n--- Prueba 1: Redondeo a bfloat16 ---" << std::endl;
+    // 1 + 2^-8 está justo a medio camino entre 1 y 1 + 2^-7: empate a par -> 1
+    // 1 + 3·2^-8 está a medio camino entre 1 + 2^-7 y 1 + 2^-6: empate a par -> 1 + 2^-6
+    if (bfloat16::from_float(1.0f).to_float() != 1.0f ||
+        bfloat16::from_float(1.0f + 1.0f / 256).to_float() != 1.0f ||
+        bfloat16::from_float(1.0f + 3.0f / 256).to_float() != 1.0f + 1.0f / 64 ||
+        bfloat16::from_float(-2.5f).to_float() != -2.5f) {
+        std::cerr << "ERROR: Redondeo al más cercano (empates a par) incorrecto" << std::endl;
+        return 1;
+    }
+    float inf = std::numeric_limits<float>::infinity();
+    if (bfloat16::from_float(inf).to_float() != inf || bfloat16::from_float(-inf).to_float() != -inf ||
+        !std::isnan(bfloat16::from_float(std::numeric_limits<float>::quiet_NaN()).to_float()) ||
+        bfloat16::from_float(3.4e38f).to_float() != inf) {
+        std::cerr << "ERROR: Infinitos, NaN o desbordamiento en bfloat16 incorrectos" << std::endl;
+        return 1;
+    }
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    double max_relative = 0.0;
+    for (int i = 0; i < 100000; ++i) {
+        double x = dist(rng);
+        if (x == 0.0) continue;
+        max_relative = std::max(max_relative, std::fabs(from_double<bfloat16>(x).to_float() - x) / std::fabs(x));
+    }
+    if (max_relative > 1.0 / 256 + 1e-7) {
+        std::cerr << "ERROR: Error relativo de bfloat16 mayor que 2^-8: " << max_relative << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Empates a par, inf/NaN conservados; error relativo máximo " << max_relative << " (<= 2^-8)" << std::endl;
+
+    // === PRUEBA 2: Disposición en memoria ===
+    std::cout << "\n--- Prueba 2: Stride, alineación y memoria ---" << std::endl;
+    const int rows = 1000, dimensions = 48, source_stride = 50;
+    std::vector<double> source(static_cast<size_t>(rows) * source_stride);
+    for (double& x : source) x = dist(rng);
+    EmbeddingMatrix<double> as_double = EmbeddingMatrix<double>::from_doubles(source.data(), rows, dimensions, source_stride);
+    EmbeddingMatrix<float> as_float = EmbeddingMatrix<float>::from_doubles(source.data(), rows, dimensions, source_stride);
+    EmbeddingMatrix<bfloat16> as_bf16 = EmbeddingMatrix<bfloat16>::from_doubles(source.data(), rows, dimensions, source_stride);
+    // 48 coordenadas: 384 B (ya múltiplo de 64), 192 B (idem), 96 B -> 128 B (64 bf16 con relleno)
+    if (as_double.stride() != 48 || as_float.stride() != 48 || as_bf16.stride() != 64) {
+        std::cerr << "ERROR: Stride no redondeado a 64 bytes" << std::endl;
+        return 1;
+    }
+    for (int r = 0; r < rows; ++r) {
+        if (reinterpret_cast<uintptr_t>(as_float.row(r)) % 64 != 0 ||
+            reinterpret_cast<uintptr_t>(as_bf16.row(r)) % 64 != 0 ||
+            as_bf16.row(r)[dimensions].bits != 0 || as_bf16.row(r)[as_bf16.stride() - 1].bits != 0) {
+            std::cerr << "ERROR: Fila " << r << " no alineada o relleno distinto de cero" << std::endl;
+            return 1;
+        }
+    }
+    std::vector<double> back(dimensions);
+    as_float.get_row(7, back.data());
+    for (int k = 0; k < dimensions; ++k) {
+        if (back[k] != static_cast<double>(static_cast<float>(source[7 * source_stride + k]))) {
+            std::cerr << "ERROR: get_row no devuelve los floats guardados" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "  - double: " << as_double.memory_bytes() / 1024 << " KB, float: " << as_float.memory_bytes() / 1024
+              << " KB, bf16: " << as_bf16.memory_bytes() / 1024 << " KB" << std::endl;
+    if (as_float.memory_bytes() * 2 != as_double.memory_bytes() || as_bf16.memory_bytes() >= as_float.memory_bytes()) {
+        std::cerr << "ERROR: Memoria de las copias reducidas incorrecta" << std::endl;
+        return 1;
+    }
+    Precision parsed;
+    if (!parse_precision("bf16", parsed) || parsed != Precision::BFloat16 || parse_precision("half", parsed) ||
+        precision_bytes(Precision::Float) != 4 || std::string(precision_name(Precision::Double)) != "double") {
+        std::cerr << "ERROR: Nombres de precisión mal interpretados" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Filas alineadas a 64 bytes con relleno cero; float ocupa la mitad que double" << std::endl;
+
+    // === PRUEBA 3: Códigos SRP desde float / bf16 ===
+    std::cout << "\n--- Prueba 3: Códigos SRP desde copias reducidas ---" << std::endl;
+    const int items = 20000, dims = 32, bits = 64;
+    SRPHasher hasher(dims, bits, 42);
+    std::vector<double> vectors(static_cast<size_t>(items) * dims);
+    for (double& x : vectors) x = dist(rng);
+    EmbeddingMatrix<float> vectors_f32 = EmbeddingMatrix<float>::from_doubles(vectors.data(), items, dims, dims);
+    EmbeddingMatrix<bfloat16> vectors_bf16 = EmbeddingMatrix<bfloat16>::from_doubles(vectors.data(), items, dims, dims);
+
+    const int words = hasher.code_words();
+    std::vector<uint64_t> reference(static_cast<size_t>(items) * words);
+    std::vector<uint64_t> codes_f32(reference.size()), codes_bf16(reference.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    hasher.hash_batch(vectors.data(), items, dims, reference.data());
+    auto mid = std::chrono::high_resolution_clock::now();
+    hasher.hash_batch(vectors_f32.data(), items, vectors_f32.stride(), codes_f32.data());
+    auto mid2 = std::chrono::high_resolution_clock::now();
+    hasher.hash_batch(vectors_bf16.data(), items, vectors_bf16.stride(), codes_bf16.data());
+    auto end = std::chrono::high_resolution_clock::now();
+
+    // Sólo cambian los bits cuya proyección está casi en cero
+    long long diff_f32 = 0, diff_bf16 = 0;
+    for (size_t w = 0; w < reference.size(); ++w) {
+        diff_f32 += popcount64(reference[w] ^ codes_f32[w]);
+        diff_bf16 += popcount64(reference[w] ^ codes_bf16[w]);
+    }
+    double total_bits = static_cast<double>(items) * bits;
+    double agreement_f32 = 1.0 - diff_f32 / total_bits;
+    double agreement_bf16 = 1.0 - diff_bf16 / total_bits;
+    std::cout << "  - double: " << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count()
+              << " μs, float: " << std::chrono::duration_cast<std::chrono::microseconds>(mid2 - mid).count()
+              << " μs, bf16: " << std::chrono::duration_cast<std::chrono::microseconds>(end - mid2).count()
+              << " μs" << std::endl;
+    std::cout << "  - Bits idénticos a double: float " << agreement_f32 * 100 << "%, bf16 "
+              << agreement_bf16 * 100 << "%" << std::endl;
+    if (agreement_f32 < 0.9999 || agreement_bf16 < 0.99) {
+        std::cerr << "ERROR: Los códigos reducidos se alejan demasiado de los de double" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Códigos desde float/bf16 prácticamente idénticos a los de double" << std::endl;
+
+    // === PRUEBA 4: Cuantización int8 con escala por fila ===
+    std::cout << "\n--- Prueba 4: Int8Matrix (escala por fila) ---" << std::endl;
+    // Una fila nula y una fila con normas muy distintas a las demás
+    std::fill(vectors.begin(), vectors.begin() + dims, 0.0);
+    for (int k = 0; k < dims; ++k) vectors[dims + k] *= 1e-3;
+    Int8Matrix vectors_int8 = Int8Matrix::from_doubles(vectors.data(), items, dims, dims);
+    if (vectors_int8.stride() != 32 || vectors_int8.scale(0) != 0.0f ||
+        reinterpret_cast<uintptr_t>(vectors_int8.row(items - 1)) % 32 != 0) {
+        std::cerr << "ERROR: Stride, alineación o escala de la fila nula incorrectos" << std::endl;
+        return 1;
+    }
+    for (int r = 0; r < items; ++r) {
+        const int8_t* q = vectors_int8.row(r);
+        const double* x = vectors.data() + static_cast<size_t>(r) * dims;
+        int max_q = 0;
+        for (int k = 0; k < dims; ++k) {
+            max_q = std::max(max_q, std::abs(static_cast<int>(q[k])));
+            if (q[k] == -128 || std::fabs(q[k] * static_cast<double>(vectors_int8.scale(r)) - x[k]) >
+                                    0.5 * vectors_int8.scale(r) * (1.0 + 1e-6)) {
+                std::cerr << "ERROR: Cuantización de la fila " << r << " fuera de medio paso" << std::endl;
+                return 1;
+            }
+        }
+        if (r > 0 && max_q != 127) {
+            std::cerr << "ERROR: La fila " << r << " no usa todo el rango [-127, 127]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<uint64_t> codes_int8(reference.size());
+    start = std::chrono::high_resolution_clock::now();
+    hasher.hash_batch(vectors_int8.data(), items, vectors_int8.stride(), codes_int8.data());
+    end = std::chrono::high_resolution_clock::now();
+    hasher.hash_batch(vectors.data(), items, dims, reference.data());
+    long long diff_int8 = 0;
+    for (size_t w = 0; w < reference.size(); ++w) {
+        diff_int8 += popcount64(reference[w] ^ codes_int8[w]);
+    }
+    double agreement_int8 = 1.0 - diff_int8 / total_bits;
+    std::cout << "  - int8: " << vectors_int8.memory_bytes() / 1024 << " KB (double: "
+              << static_cast<size_t>(items) * dims * sizeof(double) / 1024 << " KB), códigos en "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " μs, bits idénticos a double: " << agreement_int8 * 100 << "%" << std::endl;
+    if (agreement_int8 < 0.98) {
+        std::cerr << "ERROR: Los códigos desde int8 se alejan demasiado de los de double" << std::endl;
+        return 1;
+    }
+    Precision int8_precision;
+    if (!parse_precision("int8", int8_precision) || int8_precision != Precision::Int8 ||
+        precision_bytes(Precision::Int8) != 1) {
+        std::cerr << "ERROR: Precisión int8 mal interpretada" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Error <= medio paso por coordenada, rango completo por fila y códigos casi idénticos" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de EmbeddingMatrix completadas exitosamente!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "../include/LSH.h"
+#include "../include/PackedCode.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <iomanip>
+
+// Vector aleatorio gaussiano de 'd' dimensiones
+Vector random_vector(int d, std::mt19937& rng) {
+    std::normal_distribution<double> dist(0.0, 1.0);
+    Vector v(d);
+    for (double& x : v) x = dist(rng);
+    return v;
+}
+
+// Vector a un ángulo 'theta' de 'base' (en el plano de base y un vector aleatorio)
+Vector vector_at_angle(const Vector& base, double theta, std::mt19937& rng) {
+    Vector other = random_vector(static_cast<int>(base.size()), rng);
+    double base_norm = std::sqrt(std::inner_product(base.begin(), base.end(), base.begin(), 0.0));
+    double proj = std::inner_product(base.begin(), base.end(), other.begin(), 0.0) / (base_norm * base_norm);
+    for (size_t i = 0; i < other.size(); ++i) other[i] -= proj * base[i];
+    double other_norm = std::sqrt(std::inner_product(other.begin(), other.end(), other.begin(), 0.0));
+
+    Vector result(base.size());
+    for (size_t i = 0; i < base.size(); ++i) {
+        result[i] = std::cos(theta) * base[i] / base_norm + std::sin(theta) * other[i] / other_norm;
+    }
+    return result;
+}
+
+int main() {
+    std::cout << "=== Prueba de FastHadamardHasher (SRP estructurado) ===" << std::endl;
+
+    std::mt19937 rng(2024);
+
+    // === PRUEBA 1: Configuración ===
+    std::cout << "\n--- Prueba 1: Configuración ---" << std::endl;
+
+    FastHadamardHasher hasher(50, 256, 42);
+    hasher.print_hash_info();
+    if (!hasher.is_initialized() || hasher.get_padded_dimensions() != 64 || hasher.get_num_blocks() != 4) {
+        std::cerr << "ERROR: Se esperaban d rellenado a 64 y 4 bloques para 256 bits" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ 50D rellenado a 64, 256 bits en 4 bloques" << std::endl;
+
+    // === PRUEBA 2: Caminos de hashing consistentes ===
+    std::cout << "\n--- Prueba 2: generate_code / generate_packed_code / hash_batch ---" << std::endl;
+
+    const int n = 200;
+    std::vector<double> batch;
+    for (int r = 0; r < n; ++r) {
+        Vector v = random_vector(50, rng);
+        batch.insert(batch.end(), v.begin(), v.end());
+    }
+    std::vector<uint64_t> batch_codes(static_cast<size_t>(n) * hasher.code_words());
+    hasher.hash_batch(batch.data(), n, 50, batch_codes.data());
+
+    for (int r = 0; r < n; ++r) {
+        Vector v(batch.begin() + r * 50, batch.begin() + (r + 1) * 50);
+        PackedCode packed = hasher.generate_packed_code(v);
+        if (packed.to_string() != hasher.generate_code(v)) {
+            std::cerr << "ERROR: generate_packed_code difiere de generate_code en la fila " << r << std::endl;
+            return 1;
+        }
+        if (hamming_distance_words(packed.words.data(), batch_codes.data() + static_cast<size_t>(r) * packed.num_words(),
+                                   packed.num_words()) != 0) {
+            std::cerr << "ERROR: hash_batch difiere de generate_packed_code en la fila " << r << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Los tres caminos producen los mismos bits" << std::endl;
+
+    // === PRUEBA 3: Probabilidad de colisión ≈ 1 - θ/π ===
+    std::cout << "\n--- Prueba 3: Colisión por bit vs ángulo ---" << std::endl;
+    std::cout << "θ (grados) | Esperado | Hadamard | SRP denso" << std::endl;
+    std::cout << std::string(46, '-') << std::endl;
+
+    SRPHasher dense(50, 256, 42);
+    const int trials = 300;
+    for (double degrees : {10.0, 45.0, 90.0, 135.0}) {
+        double theta = degrees * M_PI / 180.0;
+        double fast_agree = 0.0, dense_agree = 0.0;
+        for (int t = 0; t < trials; ++t) {
+            Vector x = random_vector(50, rng);
+            Vector y = vector_at_angle(x, theta, rng);
+            fast_agree += 256 - hamming_distance(hasher.generate_packed_code(x), hasher.generate_packed_code(y));
+            dense_agree += 256 - hamming_distance(dense.generate_packed_code(x), dense.generate_packed_code(y));
+        }
+        double expected = 1.0 - theta / M_PI;
+        double fast_rate = fast_agree / (trials * 256.0);
+        double dense_rate = dense_agree / (trials * 256.0);
+        std::cout << std::setw(10) << std::fixed << std::setprecision(0) << degrees
+                  << " | " << std::setw(8) << std::setprecision(3) << expected
+                  << " | " << std::setw(8) << fast_rate
+                  << " | " << std::setw(9) << dense_rate << std::endl;
+
+        if (std::fabs(fast_rate - expected) > 0.03) {
+            std::cerr << "ERROR: La colisión del hasher Hadamard se aleja de 1 - θ/π" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Colisiones consistentes con SRP (1 - θ/π)" << std::endl;
+
+    // === PRUEBA 4: Rendimiento con códigos largos ===
+    std::cout << "\n--- Prueba 4: Throughput de hashing (códigos largos) ---" << std::endl;
+
+    const int dims = 128;
+    const int items = 20000;
+    std::vector<double> catalog(static_cast<size_t>(items) * dims);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    for (double& x : catalog) x = dist(rng);
+
+    for (int bits : {128, 256, 512}) {
+        SRPHasher srp(dims, bits, 7);
+        FastHadamardHasher fast(dims, bits, 7);
+        std::vector<uint64_t> codes(static_cast<size_t>(items) * code_words_for_bits(bits));
+
+        auto srp_start = std::chrono::high_resolution_clock::now();
+        srp.hash_batch(catalog.data(), items, dims, codes.data());
+        auto srp_end = std::chrono::high_resolution_clock::now();
+        fast.hash_batch(catalog.data(), items, dims, codes.data());
+        auto fast_end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "  - " << bits << " bits: SRP denso "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(srp_end - srp_start).count()
+                  << " ms, Hadamard "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(fast_end - srp_end).count()
+                  << " ms (" << items << " vectores de " << dims << "D)" << std::endl;
+    }
+
+    std::cout << "\n🎉 ¡Todas las pruebas de FastHadamardHasher completadas exitosamente!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include "../include/ITQHasher.h"
+#include "../include/LSHIndex.h"
+#include "../include/UserItemStore.h"
+#include "../include/ModelFile.h"
+#include <iostream>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+
+// Recall@K promedio: fracción del top-K exacto por coseno que aparece entre los
+// 'candidates' primeros ítems del ranking Hamming del hasher
+static double candidate_recall(const LSH& hasher, const UserItemStore& store, const std::vector<int>& users,
+                               const std::vector<std::set<int>>& truths, int candidates) {
+    LSHIndex index(hasher);
+    index.build(store);
+    double recall_sum = 0.0;
+    for (size_t u = 0; u < users.size(); ++u) {
+        int hits = 0;
+        for (const auto& item_distance : index.search(store.get_user_vector(users[u]), candidates)) {
+            hits += static_cast<int>(truths[u].count(item_distance.first));
+        }
+        recall_sum += static_cast<double>(hits) / truths[u].size();
+    }
+    return recall_sum / users.size();
+}
+
+int main() {
+    std::cout << "=== Prueba de ITQHasher (proyecciones aprendidas) ===" << std::endl;
+
+    // Catálogo sintético con estructura de bajo rango (como unos embeddings entrenados):
+    // x = A z + ruido, con A de 64×24 y escalas decrecientes en z
+    const int dimensions = 64;
+    const int rank = 24;
+    const int num_users = 200;
+    const int num_items = 6000;
+
+    std::vector<Triplet> triplets;
+    for (int u = 0; u < num_users; ++u) {
+        triplets.push_back({u, 2 * u % num_items, (2 * u + 1) % num_items});
+    }
+    for (int i = 0; i < num_items; i += 2) {
+        triplets.push_back({0, i, i + 1});
+    }
+    UserItemStore store(dimensions);
+    store.initialize(triplets);
+
+    std::mt19937 rng(11);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<double> mixing(static_cast<size_t>(dimensions) * rank);
+    for (double& x : mixing) x = dist(rng);
+    auto sample = [&](Vector& out) {
+        double z[rank];
+        for (int j = 0; j < rank; ++j) z[j] = dist(rng) / (1.0 + 0.3 * j);
+        for (int k = 0; k < dimensions; ++k) {
+            double value = 0.1 * dist(rng);
+            for (int j = 0; j < rank; ++j) value += mixing[static_cast<size_t>(k) * rank + j] * z[j];
+            out[k] = value;
+        }
+    };
+    for (int u = 0; u < num_users; ++u) sample(store.get_user_vector(u));
+    for (int i = 0; i < num_items; ++i) sample(store.get_item_vector(i));
+
+    // === PRUEBA 1: Ajuste y parámetros inválidos ===
+    std::cout << "\n--- Prueba 1: Ajuste sobre el catálogo ---" << std::endl;
+    ITQHasher too_long(dimensions, dimensions + 1);
+    if (too_long.fit(store) || too_long.is_initialized()) {
+        std::cerr << "ERROR: b > d no debería poder ajustarse" << std::endl;
+        return 1;
+    }
+    ITQHasher unfitted(dimensions, 16);
+    if (unfitted.is_initialized() || unfitted.generate_packed_code(store.get_user_vector(0)).words[0] != 0) {
+        std::cerr << "ERROR: Sin fit() el hasher debe estar sin inicializar (códigos en cero)" << std::endl;
+        return 1;
+    }
+
+    ITQHasher itq(dimensions, 16);
+    auto fit_start = std::chrono::high_resolution_clock::now();
+    if (!itq.fit(store, 50, 7)) {
+        std::cerr << "ERROR: fit() falló" << std::endl;
+        return 1;
+    }
+    auto fit_end = std::chrono::high_resolution_clock::now();
+    itq.print_hash_info();
+    std::cout << "  - Tiempo de ajuste: "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(fit_end - fit_start).count() << " ms" << std::endl;
+
+    // Las filas aprendidas (P R)^T son ortonormales
+    double max_deviation = 0.0;
+    for (int i = 0; i < 16; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            double dot = std::inner_product(itq.projection_row(i), itq.projection_row(i) + dimensions,
+                                            itq.projection_row(j), 0.0);
+            max_deviation = std::max(max_deviation, std::fabs(dot - (i == j ? 1.0 : 0.0)));
+        }
+    }
+    if (max_deviation > 1e-8) {
+        std::cerr << "ERROR: Las proyecciones aprendidas no son ortonormales (desviación "
+                  << max_deviation << ")" << std::endl;
+        return 1;
+    }
+    if (itq.get_explained_energy() < 0.5) {
+        std::cerr << "ERROR: Las 16 componentes principales deberían capturar la mayor parte de la energía" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Filas ortonormales (desviación " << std::scientific << std::setprecision(1)
+              << max_deviation << std::fixed << ")" << std::endl;
+
+    // === PRUEBA 2: El error de cuantización no crece ===
+    std::cout << "\n--- Prueba 2: Error de cuantización por iteración ---" << std::endl;
+    const std::vector<double>& errors = itq.get_quantization_errors();
+    for (size_t i = 1; i < errors.size(); ++i) {
+        if (errors[i] > errors[i - 1] * (1.0 + 1e-12)) {
+            std::cerr << "ERROR: El error de cuantización creció en la iteración " << i << std::endl;
+            return 1;
+        }
+    }
+    if (!(errors.back() < errors.front())) {
+        std::cerr << "ERROR: La rotación aprendida debería reducir el error inicial" << std::endl;
+        return 1;
+    }
+    std::cout << "  - Error: " << std::setprecision(4) << errors.front() << " (rotación aleatoria) -> "
+              << errors.back() << " tras " << errors.size() - 1 << " iteraciones" << std::endl;
+    std::cout << "✓ Error monótono no creciente" << std::endl;
+
+    // === PRUEBA 3: Caminos de hashing y guardado/carga ===
+    std::cout << "\n--- Prueba 3: Hashing por lotes y modelo guardado ---" << std::endl;
+    std::vector<double> batch(static_cast<size_t>(num_users) * dimensions);
+    for (int u = 0; u < num_users; ++u) {
+        const Vector& v = store.get_user_vector(u);
+        std::copy(v.begin(), v.end(), batch.begin() + static_cast<size_t>(u) * dimensions);
+    }
+    std::vector<uint64_t> codes(static_cast<size_t>(num_users) * itq.code_words());
+    itq.hash_batch(batch.data(), num_users, dimensions, codes.data());
+
+    // Las proyecciones aprendidas viajan en el modelo binario (save_model exige modo Dense)
+    const std::string path = "itq_test_model.srpr";
+    UserItemStore dense(dimensions, StorageLayout::Dense);
+    dense.initialize(triplets);
+    for (int u = 0; u < num_users; ++u) {
+        const Vector& v = store.get_user_vector(u);
+        std::copy(v.begin(), v.end(), dense.user_data(dense.user_row(u)));
+    }
+    for (int i = 0; i < num_items; ++i) {
+        const Vector& v = store.get_item_vector(i);
+        std::copy(v.begin(), v.end(), dense.item_data(dense.item_row(i)));
+    }
+    dense.recompute_norms();
+    MappedModel model;
+    if (!save_model(path, dense, itq.get_projection(), ModelHasherITQ, 7) || !model.open(path) ||
+        model.get_hasher() != ModelHasherITQ || model.get_num_bits() != 16) {
+        std::cerr << "ERROR: Guardado/apertura del modelo con proyecciones ITQ" << std::endl;
+        return 1;
+    }
+    SRPHasher loaded = model.make_hasher();
+    std::vector<uint64_t> item_codes(static_cast<size_t>(num_items) * itq.code_words());
+    itq.hash_batch(dense.item_matrix(), num_items, dense.row_stride(), item_codes.data());
+    if (!std::equal(item_codes.begin(), item_codes.end(), model.item_codes())) {
+        std::cerr << "ERROR: Códigos de ítems del modelo distintos a los de ITQ" << std::endl;
+        return 1;
+    }
+    model.close();
+    std::remove(path.c_str());
+
+    ITQHasher refit(dimensions, 16);
+    refit.fit(store, 50, 7);
+    for (int u = 0; u < num_users; ++u) {
+        const Vector& v = store.get_user_vector(u);
+        PackedCode packed = itq.generate_packed_code(v);
+        if (packed.words[0] != codes[u] || loaded.generate_packed_code(v).words[0] != codes[u] ||
+            refit.generate_packed_code(v).words[0] != codes[u] || itq.generate_code(v) != packed.to_string()) {
+            std::cerr << "ERROR: Códigos distintos entre caminos/modelos en el usuario " << u << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ hash_batch, generate_packed_code, generate_code, modelo cargado y reajuste con la misma seed coinciden" << std::endl;
+
+    // === PRUEBA 4: Recall con la mitad de bits ===
+    std::cout << "\n--- Prueba 4: Recall ITQ con b/2 bits vs SRP con b bits ---" << std::endl;
+    const int top_k = 10;
+    const int candidates = 100;
+    std::vector<int> users;
+    std::vector<std::set<int>> truths;
+    for (int u = 0; u < num_users; ++u) {
+        const Vector& q = store.get_user_vector(u);
+        std::vector<std::pair<double, int>> scored;
+        for (int i = 0; i < num_items; ++i) {
+            const Vector& x = store.get_item_vector(i);
+            double dot = std::inner_product(q.begin(), q.end(), x.begin(), 0.0);
+            double norm = std::sqrt(std::inner_product(x.begin(), x.end(), x.begin(), 0.0));
+            scored.emplace_back(-dot / norm, i);
+        }
+        std::partial_sort(scored.begin(), scored.begin() + top_k, scored.end());
+        std::set<int> truth;
+        for (int i = 0; i < top_k; ++i) truth.insert(scored[i].second);
+        users.push_back(u);
+        truths.push_back(truth);
+    }
+
+    std::cout << "Recall@" << top_k << " dentro del top-" << candidates << " Hamming:" << std::endl;
+    for (int bits : {8, 16, 32}) {
+        SRPHasher srp(dimensions, 2 * bits, 42);
+        ITQHasher learned(dimensions, bits);
+        learned.fit(store, 50, 42);
+        SRPHasher srp_same(dimensions, bits, 42);
+        double srp_recall = candidate_recall(srp, store, users, truths, candidates);
+        double srp_same_recall = candidate_recall(srp_same, store, users, truths, candidates);
+        double itq_recall = candidate_recall(learned, store, users, truths, candidates);
+        std::cout << "  SRP " << std::setw(2) << 2 * bits << " bits: " << std::setprecision(3) << srp_recall
+                  << " | SRP " << std::setw(2) << bits << " bits: " << srp_same_recall
+                  << " | ITQ " << std::setw(2) << bits << " bits: " << itq_recall << std::endl;
+        if (itq_recall <= srp_same_recall) {
+            std::cerr << "ERROR: ITQ con " << bits << " bits debería superar a SRP con los mismos bits" << std::endl;
+            return 1;
+        }
+        // Con códigos cortos la rotación aprendida vale el doble de bits aleatorios
+        if (bits == 8 && itq_recall < srp_recall - 0.02) {
+            std::cerr << "ERROR: ITQ con 8 bits debería igualar a SRP con 16 bits" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ ITQ supera a SRP con los mismos bits e iguala con 8 bits a SRP con 16" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de ITQHasher completadas exitosamente!" << std::endl;
+    return 0;
+}
@@ -7,6 +7,8 @@
 #include <map>
 #include <chrono>
 #include <cmath>
+#include <iomanip>
+#include <random>
 
 // Función para calcular la distancia de Hamming entre dos códigos
 int hamming_distance(const std::string& code1, const std::string& code2) {
@@ -277,6 +279,129 @@ int main() {
         std::cout << "  " << std::setw(2) << length << " bits: " << config_code << std::endl;
     }
     
+    // === PRUEBA 8b: Códigos empaquetados ===
+    std::cout << "\n--- Prueba 8b: Códigos empaquetados y Hamming con POPCNT ---" << std::endl;
+    
+    std::mt19937 packed_rng(7);
+    std::normal_distribution<double> packed_dist(0.0, 1.0);
+    for (int length : {16, 64, 100, 128}) {
+        SRPHasher packed_hasher(dimensions, length, 42);
+        Vector va(dimensions), vb(dimensions);
+        for (int i = 0; i < dimensions; ++i) {
+            va[i] = packed_dist(packed_rng);
+            vb[i] = packed_dist(packed_rng);
+        }
+        
+        PackedCode pa = packed_hasher.generate_packed_code(va);
+        PackedCode pb = packed_hasher.generate_packed_code(vb);
+        std::string sa = packed_hasher.generate_code(va);
+        std::string sb = packed_hasher.generate_code(vb);
+        
+        if (pa.to_string() != sa || pb.to_string() != sb) {
+            std::cerr << "ERROR: Código empaquetado no coincide con el código de texto (" << length << " bits)" << std::endl;
+            return 1;
+        }
+        if (hamming_distance(pa, pb) != hamming_distance(sa, sb)) {
+            std::cerr << "ERROR: Distancia Hamming empaquetada incorrecta (" << length << " bits)" << std::endl;
+            return 1;
+        }
+        std::cout << "  " << std::setw(3) << length << " bits: " << pa.num_words() 
+                  << " palabra(s), distancia = " << hamming_distance(pa, pb) << std::endl;
+    }
+    std::cout << "✓ Códigos empaquetados equivalentes a los códigos de texto" << std::endl;
+    
+    // === PRUEBA 8c: Proyecciones dispersas ===
+    std::cout << "\n--- Prueba 8c: SparseSRPHasher (coeficientes ±1 dispersos) ---" << std::endl;
+    
+    SparseSRPHasher sparse_hasher(dimensions, 64, 42);
+    sparse_hasher.print_hash_info();
+    if (!sparse_hasher.is_initialized() || sparse_hasher.get_num_nonzeros() < 64) {
+        std::cerr << "ERROR: Cada función hash dispersa necesita al menos un coeficiente no nulo" << std::endl;
+        return 1;
+    }
+    
+    const int sparse_n = 100;
+    std::vector<double> sparse_batch(static_cast<size_t>(sparse_n) * dimensions);
+    for (double& x : sparse_batch) x = packed_dist(packed_rng);
+    std::vector<uint64_t> sparse_codes(static_cast<size_t>(sparse_n) * sparse_hasher.code_words());
+    sparse_hasher.hash_batch(sparse_batch.data(), sparse_n, dimensions, sparse_codes.data());
+    
+    int sparse_agree = 0, dense_agree = 0;
+    SRPHasher dense_hasher(dimensions, 64, 42);
+    for (int r = 0; r < sparse_n; ++r) {
+        Vector v(sparse_batch.begin() + r * dimensions, sparse_batch.begin() + (r + 1) * dimensions);
+        PackedCode packed = sparse_hasher.generate_packed_code(v);
+        if (packed.to_string() != sparse_hasher.generate_code(v) ||
+            hamming_distance_words(packed.words.data(), sparse_codes.data() + r * packed.num_words(), packed.num_words()) != 0) {
+            std::cerr << "ERROR: Los caminos de hashing disperso no coinciden en la fila " << r << std::endl;
+            return 1;
+        }
+        
+        // Vector cercano (ruido pequeño): ambos hashers deben conservar casi todos los bits
+        Vector near = v;
+        for (double& x : near) x += 0.1 * packed_dist(packed_rng);
+        sparse_agree += 64 - hamming_distance(packed, sparse_hasher.generate_packed_code(near));
+        dense_agree += 64 - hamming_distance(dense_hasher.generate_packed_code(v), dense_hasher.generate_packed_code(near));
+    }
+    double sparse_rate = sparse_agree / (64.0 * sparse_n);
+    double dense_rate = dense_agree / (64.0 * sparse_n);
+    std::cout << "  Coincidencia de bits con vecino cercano: disperso " << sparse_rate 
+              << ", denso " << dense_rate << std::endl;
+    if (sparse_rate < dense_rate - 0.05) {
+        std::cerr << "ERROR: El hasher disperso preserva la similitud mucho peor que el denso" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ SparseSRPHasher consistente y con colisiones comparables a SRP denso" << std::endl;
+
+    // === PRUEBA 8d: Hashing asimétrico (Simple-ALSH) ===
+    std::cout << "\n--- Prueba 8d: Simple-ALSH (MIPS con transformaciones asimétricas) ---" << std::endl;
+
+    const int alsh_bits = 1024;
+    SRPHasher alsh_projection(dimensions + 1, alsh_bits, 42);
+    SimpleALSHItemHasher alsh_items(alsh_projection, 1.0);
+    SimpleALSHQueryHasher alsh_queries(alsh_projection);
+    if (!alsh_items.is_initialized() || alsh_items.get_dimensions() != dimensions ||
+        alsh_queries.get_num_hashes() != alsh_bits) {
+        std::cerr << "ERROR: Los hashers asimétricos deben tener d = dimensiones de la proyección - 1" << std::endl;
+        return 1;
+    }
+
+    // Los tres caminos de hashing deben coincidir también tras la transformación
+    std::vector<uint64_t> alsh_codes(static_cast<size_t>(sparse_n) * alsh_items.code_words());
+    alsh_items.hash_batch(sparse_batch.data(), sparse_n, dimensions, alsh_codes.data());
+    for (int r = 0; r < sparse_n; ++r) {
+        Vector v(sparse_batch.begin() + r * dimensions, sparse_batch.begin() + (r + 1) * dimensions);
+        PackedCode packed = alsh_items.generate_packed_code(v);
+        if (packed.to_string() != alsh_items.generate_code(v) ||
+            hamming_distance_words(packed.words.data(), alsh_codes.data() + r * packed.num_words(), packed.num_words()) != 0) {
+            std::cerr << "ERROR: Los caminos de hashing Simple-ALSH no coinciden en la fila " << r << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ generate_code, generate_packed_code y hash_batch coinciden" << std::endl;
+
+    // Dos ítems con la misma dirección que la consulta y normas 0.2 y 0.9: SRP coseno no los
+    // distingue; Simple-ALSH debe acercar más el de mayor producto interno
+    Vector direction(dimensions);
+    for (double& x : direction) x = packed_dist(packed_rng);
+    double direction_norm = std::sqrt(std::inner_product(direction.begin(), direction.end(), direction.begin(), 0.0));
+    Vector small_item(dimensions), large_item(dimensions);
+    for (int k = 0; k < dimensions; ++k) {
+        small_item[k] = 0.2 * direction[k] / direction_norm;
+        large_item[k] = 0.9 * direction[k] / direction_norm;
+    }
+    PackedCode query_code = alsh_queries.generate_packed_code(direction);
+    int small_distance = hamming_distance(query_code, alsh_items.generate_packed_code(small_item));
+    int large_distance = hamming_distance(query_code, alsh_items.generate_packed_code(large_item));
+    std::cout << "  Distancia Hamming (de " << alsh_bits << "): norma 0.2 -> " << small_distance
+              << " (esperado ~" << static_cast<int>(alsh_bits * std::acos(0.2) / std::acos(-1.0)) << "), norma 0.9 -> "
+              << large_distance << " (esperado ~" << static_cast<int>(alsh_bits * std::acos(0.9) / std::acos(-1.0)) << ")" << std::endl;
+    if (large_distance >= small_distance) {
+        std::cerr << "ERROR: Simple-ALSH no ordena por producto interno" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Simple-ALSH preserva el orden por producto interno (la norma del ítem cuenta)" << std::endl;
+
     // === PRUEBA 9: Manejo de errores ===
     std::cout << "\n--- Prueba 9: Manejo de errores ---" << std::endl;
     
@@ -312,6 +437,7 @@ int main() {
     std::cout << "   ✓ Correlación entre similitud y distancia Hamming" << std::endl;
     std::cout << "   ✓ Rendimiento eficiente de hashing" << std::endl;
     std::cout << "   ✓ Soporte para diferentes configuraciones" << std::endl;
+    std::cout << "   ✓ Códigos empaquetados con Hamming por POPCNT" << std::endl;
     std::cout << "   ✓ Manejo robusto de errores" << std::endl;
     
     std::cout << "\n📊 Configuración verificada:" << std::endl;
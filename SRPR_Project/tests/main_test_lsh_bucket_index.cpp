@@ -0,0 +1,252 @@
+#include "../include/LSHBucketIndex.h"
+#include "../include/ExhaustiveBenchmark.h"
+#include "../include/SRPR_Trainer.h"
+#include "../include/UserItemStore.h"
+#include "../include/Triplet.h"
+#include "TestData.h"
+#include <iostream>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <random>
+
+int main() {
+    std::cout << "=== Prueba de LSHBucketIndex (L tablas × k bits) ===" << std::endl;
+
+    const int dimensions = 32;
+    const int top_k = 10;
+    const int num_users = 40;
+
+    std::vector<Triplet> triplets = make_synthetic_triplets(num_users, 20000, 200, 321);
+    UserItemStore store(dimensions);
+    store.initialize(triplets);
+    store.print_summary();
+
+    // === PRUEBA 1: Construcción y claves de bucket ===
+    std::cout << "\n--- Prueba 1: Construcción y claves de bucket ---" << std::endl;
+
+    LSHBucketIndex index(dimensions, 4, 12, 7);
+    index.build(store);
+    index.print_info();
+
+    if (index.size() != static_cast<int>(store.get_all_item_vectors().size())) {
+        std::cerr << "ERROR: El índice no contiene todos los ítems!" << std::endl;
+        return 1;
+    }
+
+    // Todo candidato debe compartir al menos un bucket con la consulta
+    const SRPHasher& hasher = index.get_hasher();
+    for (int user_id = 1; user_id <= 5; ++user_id) {
+        const Vector& user_vector = store.get_user_vector(user_id);
+        PackedCode user_code = hasher.generate_packed_code(user_vector);
+        for (int item_id : index.query_candidates(user_vector)) {
+            PackedCode item_code = hasher.generate_packed_code(store.get_item_vector(item_id));
+            bool shares_bucket = false;
+            for (int t = 0; t < index.get_num_tables(); ++t) {
+                if (index.bucket_key(user_code.words.data(), t) == index.bucket_key(item_code.words.data(), t)) {
+                    shares_bucket = true;
+                    break;
+                }
+            }
+            if (!shares_bucket) {
+                std::cerr << "ERROR: Candidato " << item_id << " no comparte bucket con el usuario " << user_id << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "✓ Todos los candidatos comparten bucket con la consulta" << std::endl;
+
+    // Claves que cruzan el límite de palabra (k = 24 -> la tabla 2 usa los bits 48..71)
+    LSHBucketIndex wide_index(dimensions, 3, 24, 7);
+    PackedCode code(72);
+    for (int i = 40; i < 72; i += 3) code.set_bit(i);
+    uint64_t expected_key = 0;
+    for (int i = 0; i < 24; ++i) {
+        if (code.get_bit(48 + i)) expected_key |= (1ULL << i);
+    }
+    if (wide_index.bucket_key(code.words.data(), 2) != expected_key) {
+        std::cerr << "ERROR: Clave de bucket incorrecta al cruzar palabras de 64 bits" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Claves de bucket correctas al cruzar palabras de 64 bits" << std::endl;
+
+    // === PRUEBA 2: Recall vs número de tablas ===
+    std::cout << "\n--- Prueba 2: Recall@" << top_k << " vs número de tablas ---" << std::endl;
+
+    SRPHasher benchmark_hasher(dimensions, 16, 42);
+    ExhaustiveBenchmark benchmark(store, benchmark_hasher);
+
+    std::cout << "L  | k  | Recall@K | Candidatos | Tiempo (ms) | Exhaustivo (ms)" << std::endl;
+    std::cout << std::string(65, '-') << std::endl;
+
+    double previous_candidates = -1.0;
+    for (int tables : {1, 4, 16}) {
+        benchmark.build_bucket_index(tables, 10, 7);
+
+        double recall_sum = 0.0, candidate_sum = 0.0, bucket_ms = 0.0, exhaustive_ms = 0.0;
+        for (int user_id = 1; user_id <= num_users; ++user_id) {
+            std::chrono::microseconds ex_time, bucket_time;
+            auto exact = benchmark.exhaustive_search(user_id, top_k, ex_time);
+            int candidates = 0;
+            auto approx = benchmark.bucket_search(user_id, top_k, bucket_time, &candidates);
+
+            std::set<int> truth;
+            for (const auto& rec : exact) truth.insert(rec.item_id);
+            recall_sum += benchmark.calculate_recall_at_k(approx, truth, top_k);
+            candidate_sum += candidates;
+            bucket_ms += bucket_time.count() / 1000.0;
+            exhaustive_ms += ex_time.count() / 1000.0;
+        }
+
+        double avg_candidates = candidate_sum / num_users;
+        std::cout << std::setw(2) << tables << " | " << std::setw(2) << 10
+                  << " | " << std::setw(8) << std::fixed << std::setprecision(3) << recall_sum / num_users
+                  << " | " << std::setw(10) << std::setprecision(1) << avg_candidates
+                  << " | " << std::setw(11) << std::setprecision(3) << bucket_ms / num_users
+                  << " | " << std::setw(15) << exhaustive_ms / num_users << std::endl;
+
+        if (avg_candidates < previous_candidates) {
+            std::cerr << "ERROR: Más tablas no pueden producir menos candidatos" << std::endl;
+            return 1;
+        }
+        previous_candidates = avg_candidates;
+    }
+    std::cout << "✓ Candidatos crecen con el número de tablas, sin recorrer el catálogo" << std::endl;
+
+    // === PRUEBA 3: Secuencias de probes ===
+    std::cout << "\n--- Prueba 3: Secuencias multi-probe ---" << std::endl;
+
+    LSHBucketIndex probe_index(dimensions, 2, 6, 7);
+    std::vector<uint64_t> radius_masks = probe_index.probe_sequence(nullptr, 1 + 6 + 15, ProbeStrategy::HammingRadius);
+    std::set<uint64_t> distinct_masks(radius_masks.begin(), radius_masks.end());
+    if (radius_masks.size() != 22 || distinct_masks.size() != 22 || radius_masks[0] != 0) {
+        std::cerr << "ERROR: La secuencia por radio Hamming debe tener 22 máscaras distintas empezando por 0" << std::endl;
+        return 1;
+    }
+    for (size_t i = 1; i < radius_masks.size(); ++i) {
+        if (popcount64(radius_masks[i]) < popcount64(radius_masks[i - 1])) {
+            std::cerr << "ERROR: Radio Hamming no creciente en la secuencia de probes" << std::endl;
+            return 1;
+        }
+    }
+
+    // Con márgenes conocidos, el primer vecino invierte el bit más dudoso y los costos no decrecen
+    const double margins[6] = {0.9, -0.05, 0.4, -0.3, 1.5, 0.1};
+    std::vector<uint64_t> margin_masks = probe_index.probe_sequence(margins, 20, ProbeStrategy::ProjectionMargin);
+    distinct_masks = std::set<uint64_t>(margin_masks.begin(), margin_masks.end());
+    if (margin_masks.size() != 20 || distinct_masks.size() != 20 || margin_masks[1] != (1ULL << 1)) {
+        std::cerr << "ERROR: Secuencia por margen incorrecta" << std::endl;
+        return 1;
+    }
+    double previous_cost = 0.0;
+    for (uint64_t mask : margin_masks) {
+        double cost = 0.0;
+        for (int i = 0; i < 6; ++i) {
+            if ((mask >> i) & 1ULL) cost += margins[i] * margins[i];
+        }
+        if (cost + 1e-12 < previous_cost) {
+            std::cerr << "ERROR: Costos de perturbación no crecientes" << std::endl;
+            return 1;
+        }
+        previous_cost = cost;
+    }
+    std::cout << "✓ Secuencias por radio Hamming y por margen en orden correcto" << std::endl;
+
+    // === PRUEBA 4: Recall vs probes por tabla ===
+    std::cout << "\n--- Prueba 4: Recall@" << top_k << " vs probes por tabla (L=4, k=10) ---" << std::endl;
+
+    benchmark.build_bucket_index(4, 10, 7);
+    std::vector<int> test_users;
+    for (int user_id = 1; user_id <= num_users; ++user_id) test_users.push_back(user_id);
+
+    // Más probes visitan un superconjunto de buckets: nunca menos candidatos
+    for (ProbeStrategy strategy : {ProbeStrategy::HammingRadius, ProbeStrategy::ProjectionMargin}) {
+        for (int user_id = 1; user_id <= 5; ++user_id) {
+            std::chrono::microseconds t;
+            int previous = -1;
+            for (int probes : {1, 4, 16}) {
+                int candidates = 0;
+                benchmark.bucket_search(user_id, top_k, probes, strategy, t, &candidates);
+                if (candidates < previous) {
+                    std::cerr << "ERROR: Más probes no pueden producir menos candidatos" << std::endl;
+                    return 1;
+                }
+                previous = candidates;
+            }
+        }
+    }
+    std::cout << "✓ Candidatos crecen con el presupuesto de probes" << std::endl;
+
+    benchmark.lsh_configuration_analysis({16}, test_users, top_k, {1, 4, 16, 32});
+
+    // === PRUEBA 5: Refresco incremental tras entrenar ===
+    std::cout << "\n--- Prueba 5: Refresco incremental de índices tras entrenar ---" << std::endl;
+
+    benchmark.build_mih_index();
+    benchmark.build_bit_sliced_index();
+    store.clear_dirty_items();
+
+    SRPR_Trainer trainer(store);
+    SRPR_Trainer::TrainingParams params;
+    params.epochs = 1;
+    params.learning_rate = 0.5;
+    params.verbose = false;
+    std::vector<Triplet> batch(triplets.begin(), triplets.begin() + 300);
+    trainer.train(batch, params);
+
+    const int dirty_items = static_cast<int>(store.get_dirty_items().size());
+    if (dirty_items == 0 || store.get_dirty_users().empty()) {
+        std::cerr << "ERROR: El entrenamiento no marcó vectores modificados" << std::endl;
+        return 1;
+    }
+
+    auto refresh_start = std::chrono::high_resolution_clock::now();
+    int refreshed = benchmark.refresh_index();
+    auto refresh_end = std::chrono::high_resolution_clock::now();
+    if (refreshed != dirty_items || !store.get_dirty_items().empty()) {
+        std::cerr << "ERROR: refresh_index rehasheó " << refreshed << " de " << dirty_items << " ítems" << std::endl;
+        return 1;
+    }
+
+    // Referencia: mismos índices construidos desde cero sobre los vectores entrenados
+    ExhaustiveBenchmark fresh(store, benchmark_hasher);
+    fresh.build_bucket_index(4, 10, 7);
+    fresh.build_mih_index();
+    auto rebuild_start = std::chrono::high_resolution_clock::now();
+    fresh.rebuild_index();
+    auto rebuild_end = std::chrono::high_resolution_clock::now();
+    fresh.build_bit_sliced_index();
+
+    if (benchmark.get_index().get_codes() != fresh.get_index().get_codes()) {
+        std::cerr << "ERROR: Códigos refrescados distintos a los reconstruidos" << std::endl;
+        return 1;
+    }
+    for (int user_id = 1; user_id <= num_users; ++user_id) {
+        std::chrono::microseconds t;
+        int candidates_a = 0, candidates_b = 0;
+        auto same = [](const std::vector<RecommendationResult>& a, const std::vector<RecommendationResult>& b) {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (a[i].item_id != b[i].item_id || a[i].hamming_distance != b[i].hamming_distance) return false;
+            }
+            return true;
+        };
+        if (!same(benchmark.lsh_search(user_id, top_k, t), fresh.lsh_search(user_id, top_k, t)) ||
+            !same(benchmark.mih_search(user_id, top_k, t), fresh.mih_search(user_id, top_k, t)) ||
+            !same(benchmark.bucket_search(user_id, top_k, 4, ProbeStrategy::HammingRadius, t, &candidates_a),
+                  fresh.bucket_search(user_id, top_k, 4, ProbeStrategy::HammingRadius, t, &candidates_b)) ||
+            candidates_a != candidates_b) {
+            std::cerr << "ERROR: Índices refrescados difieren de los reconstruidos para usuario " << user_id << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "  - " << dirty_items << " de " << benchmark.get_index().size() << " ítems modificados: refresco "
+              << std::chrono::duration_cast<std::chrono::microseconds>(refresh_end - refresh_start).count()
+              << " μs, reconstrucción completa "
+              << std::chrono::duration_cast<std::chrono::microseconds>(rebuild_end - rebuild_start).count()
+              << " μs" << std::endl;
+    std::cout << "✓ Códigos, tablas hash, MIH y almacén bit-sliced idénticos a una reconstrucción" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de LSHBucketIndex completadas exitosamente!" << std::endl;
+    return 0;
+}
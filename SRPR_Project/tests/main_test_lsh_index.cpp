@@ -0,0 +1,361 @@
+#include "../include/LSHIndex.h"
+#include "../include/TopK.h"
+#include "../include/FixedCode.h"
+#include "../include/LSH.h"
+#include "../include/UserItemStore.h"
+#include "../include/Triplet.h"
+#include "TestData.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+
+int main() {
+    std::cout << "=== Prueba de LSHIndex (códigos persistentes del catálogo) ===" << std::endl;
+
+    const int dimensions = 32;
+    const int num_hashes = 64;
+    const int top_k = 10;
+
+    std::vector<Triplet> triplets = make_synthetic_triplets(50, 3000, 40, 123);
+    UserItemStore store(dimensions);
+    store.initialize(triplets);
+    store.print_summary();
+
+    SRPHasher hasher(dimensions, num_hashes, 42);
+
+    // === PRUEBA 1: Construcción ===
+    std::cout << "\n--- Prueba 1: Construcción del índice ---" << std::endl;
+
+    auto build_start = std::chrono::high_resolution_clock::now();
+    LSHIndex index(hasher);
+    index.build(store);
+    auto build_end = std::chrono::high_resolution_clock::now();
+
+    if (index.size() != static_cast<int>(store.get_all_item_vectors().size())) {
+        std::cerr << "ERROR: El índice no contiene todos los ítems!" << std::endl;
+        return 1;
+    }
+    if (!std::is_sorted(index.get_item_ids().begin(), index.get_item_ids().end())) {
+        std::cerr << "ERROR: Las filas del índice no están ordenadas por item_id!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "✓ " << index.size() << " ítems indexados en "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(build_end - build_start).count()
+              << " ms (" << index.memory_bytes() / 1024.0 << " KB)" << std::endl;
+
+    // === PRUEBA 2: Los códigos coinciden con el hasher ===
+    std::cout << "\n--- Prueba 2: Códigos almacenados ---" << std::endl;
+
+    for (int row = 0; row < index.size(); row += 97) {
+        PackedCode expected = hasher.generate_packed_code(store.get_item_vector(index.item_id_at(row)));
+        if (hamming_distance_words(expected.words.data(), index.code_at(row), index.get_code_words()) != 0) {
+            std::cerr << "ERROR: Código almacenado distinto para fila " << row << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Códigos del índice idénticos a los del hasher" << std::endl;
+
+    // === PRUEBA 3: Búsqueda equivalente a re-hashear el catálogo ===
+    std::cout << "\n--- Prueba 3: Búsqueda vs Hamming ranking ingenuo ---" << std::endl;
+
+    for (int user_id = 1; user_id <= 10; ++user_id) {
+        const Vector& user_vector = store.get_user_vector(user_id);
+        auto results = index.search(user_vector, top_k);
+
+        // Ranking de referencia re-hasheando cada ítem
+        PackedCode user_code = hasher.generate_packed_code(user_vector);
+        std::vector<int> all_distances;
+        for (const auto& item_pair : store.get_all_item_vectors()) {
+            all_distances.push_back(hamming_distance(user_code, hasher.generate_packed_code(item_pair.second)));
+        }
+        std::sort(all_distances.begin(), all_distances.end());
+
+        if (static_cast<int>(results.size()) != top_k) {
+            std::cerr << "ERROR: Se esperaban " << top_k << " resultados" << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < top_k; ++i) {
+            if (results[i].second != all_distances[i]) {
+                std::cerr << "ERROR: Distancia en posición " << i << " no coincide para usuario " << user_id << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "✓ Distancias top-" << top_k << " idénticas al ranking ingenuo" << std::endl;
+
+    // === PRUEBA 4: Rendimiento por consulta ===
+    std::cout << "\n--- Prueba 4: Rendimiento por consulta ---" << std::endl;
+
+    const int num_queries = 200;
+    auto query_start = std::chrono::high_resolution_clock::now();
+    int checksum = 0;
+    for (int q = 0; q < num_queries; ++q) {
+        auto results = index.search(store.get_user_vector(1 + q % 50), top_k);
+        checksum += results.empty() ? 0 : results[0].second;
+    }
+    auto query_end = std::chrono::high_resolution_clock::now();
+    double avg_us = std::chrono::duration_cast<std::chrono::microseconds>(query_end - query_start).count()
+                    / static_cast<double>(num_queries);
+    std::cout << "  - " << avg_us << " μs por consulta (checksum " << checksum << ")" << std::endl;
+
+    // === PRUEBA 5: Kernel por lotes vs hashing individual ===
+    std::cout << "\n--- Prueba 5: Hashing por lotes (matriz b×d × bloque d×N) ---" << std::endl;
+
+    const int batch_n = 5000;
+    std::mt19937 rng(9);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<double> batch(static_cast<size_t>(batch_n) * dimensions);
+    for (double& v : batch) v = dist(rng);
+
+    std::vector<uint64_t> batch_codes(static_cast<size_t>(batch_n) * hasher.code_words());
+    auto batch_start = std::chrono::high_resolution_clock::now();
+    hasher.hash_batch(batch.data(), batch_n, dimensions, batch_codes.data());
+    auto batch_end = std::chrono::high_resolution_clock::now();
+
+    auto single_start = std::chrono::high_resolution_clock::now();
+    Vector row(dimensions);
+    for (int r = 0; r < batch_n; ++r) {
+        std::copy(batch.begin() + static_cast<size_t>(r) * dimensions,
+                  batch.begin() + static_cast<size_t>(r + 1) * dimensions, row.begin());
+        PackedCode code = hasher.generate_packed_code(row);
+        if (hamming_distance_words(code.words.data(), batch_codes.data() + static_cast<size_t>(r) * code.num_words(),
+                                   code.num_words()) != 0) {
+            std::cerr << "ERROR: hash_batch difiere del hashing individual en la fila " << r << std::endl;
+            return 1;
+        }
+    }
+    auto single_end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "✓ hash_batch produce los mismos códigos que generate_packed_code" << std::endl;
+    std::cout << "  - Lotes:      " << std::chrono::duration_cast<std::chrono::microseconds>(batch_end - batch_start).count()
+              << " μs para " << batch_n << " vectores" << std::endl;
+    std::cout << "  - Individual: " << std::chrono::duration_cast<std::chrono::microseconds>(single_end - single_start).count()
+              << " μs (incluye verificación)" << std::endl;
+
+    // === PRUEBA 6: Top-k por conteo vs sort completo ===
+    std::cout << "\n--- Prueba 6: Top-k por conteo de distancias ---" << std::endl;
+
+    const int n = 500000;
+    const int max_distance = 64;
+    std::uniform_int_distribution<int> distance_dist(0, max_distance);
+    std::vector<int> distances(n);
+    for (int& d : distances) d = distance_dist(rng);
+
+    for (int k : {1, 10, 100, 10000, n + 5}) {
+        auto sort_start = std::chrono::high_resolution_clock::now();
+        std::vector<std::pair<int, int>> ranked;
+        ranked.reserve(n);
+        for (int i = 0; i < n; ++i) ranked.emplace_back(distances[i], i);
+        std::sort(ranked.begin(), ranked.end());
+        auto sort_end = std::chrono::high_resolution_clock::now();
+
+        std::vector<int> selected;
+        auto count_start = std::chrono::high_resolution_clock::now();
+        counting_top_k(distances.data(), n, max_distance, k, selected);
+        auto count_end = std::chrono::high_resolution_clock::now();
+
+        int expected = std::min(k, n);
+        if (static_cast<int>(selected.size()) != expected) {
+            std::cerr << "ERROR: counting_top_k devolvió " << selected.size() << " de " << expected << std::endl;
+            return 1;
+        }
+        for (int i = 0; i < expected; ++i) {
+            if (selected[i] != ranked[i].second) {
+                std::cerr << "ERROR: counting_top_k difiere del sort en la posición " << i << " (k=" << k << ")" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "  - k=" << k << ": sort "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(sort_end - sort_start).count()
+                  << " μs, conteo "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(count_end - count_start).count()
+                  << " μs" << std::endl;
+    }
+    std::cout << "✓ counting_top_k idéntico al orden (distancia, fila) del sort completo" << std::endl;
+
+    // === PRUEBA 7: Kernels de longitud fija ===
+    std::cout << "\n--- Prueba 7: Kernels especializados por longitud de código ---" << std::endl;
+
+    const int scan_n = 200000;
+    std::uniform_int_distribution<uint64_t> word_dist;
+    for (int bits : {16, 32, 64, 100, 128, 256}) {
+        SRPHasher fixed_hasher(dimensions, bits, 42);
+        const int words = fixed_hasher.code_words();
+
+        // Hashing despachado vs camino bit a bit (hash_to_bit)
+        std::vector<double> rows(static_cast<size_t>(100) * dimensions);
+        for (double& x : rows) x = std::normal_distribution<double>(0.0, 1.0)(rng);
+        std::vector<uint64_t> row_codes(static_cast<size_t>(100) * words);
+        fixed_hasher.hash_batch(rows.data(), 100, dimensions, row_codes.data());
+        for (int r = 0; r < 100; ++r) {
+            Vector v(rows.begin() + r * dimensions, rows.begin() + (r + 1) * dimensions);
+            PackedCode packed = fixed_hasher.generate_packed_code(v);
+            if (packed.to_string() != fixed_hasher.generate_code(v) ||
+                hamming_distance_words(packed.words.data(), row_codes.data() + r * words, words) != 0) {
+                std::cerr << "ERROR: Kernel de hashing de " << bits << " bits difiere del camino bit a bit" << std::endl;
+                return 1;
+            }
+        }
+
+        // Escaneo desplegado vs genérico
+        std::vector<uint64_t> scan_codes(static_cast<size_t>(scan_n) * words);
+        for (uint64_t& w : scan_codes) w = word_dist(rng);
+        std::vector<int> fixed_distances(scan_n), generic_distances(scan_n);
+        const uint64_t* query_words = scan_codes.data();
+
+        auto generic_start = std::chrono::high_resolution_clock::now();
+        hamming_scan_generic(query_words, scan_codes.data(), scan_n, words, generic_distances.data());
+        auto fixed_start = std::chrono::high_resolution_clock::now();
+        select_hamming_scan(words)(query_words, scan_codes.data(), scan_n, words, fixed_distances.data());
+        auto fixed_end = std::chrono::high_resolution_clock::now();
+
+        if (fixed_distances != generic_distances) {
+            std::cerr << "ERROR: Escaneo especializado de " << words << " palabras difiere del genérico" << std::endl;
+            return 1;
+        }
+        std::cout << "  - " << bits << " bits (hashing " << (has_fixed_code_kernels(bits) ? "especializado" : "genérico")
+                  << "): escaneo genérico "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(fixed_start - generic_start).count()
+                  << " μs, despachado "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(fixed_end - fixed_start).count()
+                  << " μs" << std::endl;
+    }
+
+    std::cout << "✓ Kernels especializados idénticos a los genéricos" << std::endl;
+
+    // === PRUEBA 8: Cascada de prefijos ===
+    std::cout << "\n--- Prueba 8: Cascada de prefijos (16 → 64 → 256 bits) ---" << std::endl;
+
+    std::vector<Triplet> large_triplets = make_synthetic_triplets(50, 60000, 2400, 123);
+    UserItemStore large_store(dimensions);
+    large_store.initialize(large_triplets);
+    SRPHasher long_hasher(dimensions, 256, 42);
+    LSHIndex long_index(long_hasher);
+    long_index.build(large_store);
+    const size_t plain_bytes = long_index.memory_bytes();
+    long_index.build_prefix_cascade({64, 16, 300, 16});
+
+    if (long_index.get_prefix_bits() != std::vector<int>({16, 64})) {
+        std::cerr << "ERROR: Prefijos de la cascada mal normalizados" << std::endl;
+        return 1;
+    }
+    for (int row = 0; row < long_index.size(); row += 1013) {
+        const uint64_t* code = long_index.code_at(row);
+        PackedCode query_code = long_hasher.generate_packed_code(large_store.get_item_vector(long_index.item_id_at(row)));
+        if (hamming_distance_words(query_code.words.data(), code, long_index.get_code_words()) != 0) {
+            std::cerr << "ERROR: Código de 256 bits distinto para fila " << row << std::endl;
+            return 1;
+        }
+    }
+
+    // Presupuestos >= n: idéntico a search()
+    const std::vector<int> no_budget;
+    for (int user_id = 1; user_id <= 10; ++user_id) {
+        PackedCode user_code = long_index.encode(large_store.get_user_vector(user_id));
+        if (long_index.cascade_search(user_code, top_k, no_budget) != long_index.search(user_code, top_k)) {
+            std::cerr << "ERROR: Cascada sin presupuesto difiere de search() para usuario " << user_id << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Sin presupuesto la cascada reproduce search() (" << long_index.size() << " ítems)" << std::endl;
+
+    // Presupuestos ajustados: recall del top-k respecto al escaneo completo y tiempo
+    const std::vector<int> budgets = {3000, 300};
+    double full_us = 0.0, cascade_us = 0.0, overlap = 0.0;
+    long long compared = 0;
+    const int cascade_users = 50;
+    for (int user_id = 1; user_id <= cascade_users; ++user_id) {
+        PackedCode user_code = long_index.encode(large_store.get_user_vector(user_id));
+
+        auto full_start = std::chrono::high_resolution_clock::now();
+        auto full = long_index.search(user_code, top_k);
+        auto cascade_start = std::chrono::high_resolution_clock::now();
+        long long rows_compared = 0;
+        auto cascade = long_index.cascade_search(user_code, top_k, budgets, &rows_compared);
+        auto cascade_end = std::chrono::high_resolution_clock::now();
+        full_us += std::chrono::duration<double, std::micro>(cascade_start - full_start).count();
+        cascade_us += std::chrono::duration<double, std::micro>(cascade_end - cascade_start).count();
+        compared += rows_compared;
+
+        if (static_cast<int>(cascade.size()) != top_k) {
+            std::cerr << "ERROR: La cascada devolvió " << cascade.size() << " resultados" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < cascade.size(); ++i) {
+            // Las distancias reportadas son las del código completo, en orden ascendente
+            int row = static_cast<int>(std::lower_bound(long_index.get_item_ids().begin(), long_index.get_item_ids().end(),
+                                                        cascade[i].first) - long_index.get_item_ids().begin());
+            if (cascade[i].second != hamming_distance_words(user_code.words.data(), long_index.code_at(row), long_index.get_code_words()) ||
+                (i > 0 && cascade[i].second < cascade[i - 1].second)) {
+                std::cerr << "ERROR: Distancia de la cascada incorrecta para usuario " << user_id << std::endl;
+                return 1;
+            }
+        }
+        int hits = 0;
+        for (const auto& result : cascade) {
+            for (const auto& reference : full) {
+                if (reference.first == result.first) { ++hits; break; }
+            }
+        }
+        overlap += static_cast<double>(hits) / top_k;
+    }
+    std::cout << "  - Presupuestos {3000, 300}: recall@" << top_k << " vs escaneo de 256 bits = "
+              << overlap / cascade_users << ", filas comparadas tras el filtro = " << compared / cascade_users
+              << " de " << long_index.size() << std::endl;
+    std::cout << "  - Tiempo por consulta: completo " << full_us / cascade_users << " μs, cascada "
+              << cascade_us / cascade_users << " μs" << std::endl;
+    std::cout << "  - Memoria: " << plain_bytes / 1024 << " KB sin prefijos, "
+              << long_index.memory_bytes() / 1024 << " KB con prefijos" << std::endl;
+    std::cout << "✓ Cascada con presupuestos por etapa y distancias exactas de 256 bits" << std::endl;
+
+    // === PRUEBA 9: Refresco incremental ===
+    std::cout << "\n--- Prueba 9: Refresco de ítems modificados ---" << std::endl;
+
+    if (long_index.row_of(long_index.item_id_at(123)) != 123 || long_index.row_of(-5) != -1) {
+        std::cerr << "ERROR: row_of no localiza las filas" << std::endl;
+        return 1;
+    }
+    std::normal_distribution<double> noise(0.0, 0.1);
+    for (int row = 0; row < long_index.size(); row += 100) {
+        int item_id = long_index.item_id_at(row);
+        for (double& x : large_store.get_item_vector(item_id)) x += noise(rng);
+        large_store.mark_item_dirty(item_id);
+        large_store.mark_item_dirty(item_id);  // Repetido: se cuenta una sola vez
+    }
+    const int modified = static_cast<int>(large_store.get_dirty_items().size());
+
+    auto refresh_start = std::chrono::high_resolution_clock::now();
+    int refreshed = long_index.refresh(large_store, large_store.get_dirty_items());
+    auto refresh_end = std::chrono::high_resolution_clock::now();
+    large_store.clear_dirty_items();
+
+    LSHIndex rebuilt(long_hasher);
+    auto rebuild_start = std::chrono::high_resolution_clock::now();
+    rebuilt.build(large_store);
+    auto rebuild_end = std::chrono::high_resolution_clock::now();
+    rebuilt.build_prefix_cascade({16, 64});
+
+    if (refreshed != modified || modified != (long_index.size() + 99) / 100 ||
+        long_index.get_codes() != rebuilt.get_codes()) {
+        std::cerr << "ERROR: El refresco no reproduce la reconstrucción (" << refreshed << " filas)" << std::endl;
+        return 1;
+    }
+    for (int user_id = 1; user_id <= 10; ++user_id) {
+        PackedCode user_code = long_index.encode(large_store.get_user_vector(user_id));
+        if (long_index.cascade_search(user_code, top_k, budgets) != rebuilt.cascade_search(user_code, top_k, budgets)) {
+            std::cerr << "ERROR: Prefijos no actualizados tras el refresco" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ " << refreshed << " filas rehasheadas en "
+              << std::chrono::duration_cast<std::chrono::microseconds>(refresh_end - refresh_start).count()
+              << " μs (reconstrucción completa: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(rebuild_end - rebuild_start).count()
+              << " μs); códigos y prefijos idénticos" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de LSHIndex completadas exitosamente!" << std::endl;
+    return 0;
+}
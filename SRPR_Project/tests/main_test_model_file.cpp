@@ -0,0 +1,206 @@
+#include "../include/ModelFile.h"
+#include "../include/UserItemStore.h"
+#include "../include/LSH.h"
+#include "../include/LSHIndex.h"
+#include "../include/Triplet.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+static bool write_bytes(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+static std::vector<char> read_bytes(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    std::cout << "=== Prueba de ModelFile (modelo binario con mmap) ===" << std::endl;
+
+    const int dimensions = 20, bits = 96;
+    const unsigned int seed = 42;
+    const std::string path = "test_model_file.srpr";
+    const std::string corrupt_path = "test_model_file_corrupt.srpr";
+
+    // Ids dispersos para que fila != id
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> user_dist(0, 400), item_dist(0, 3000);
+    std::vector<Triplet> triplets;
+    for (int i = 0; i < 6000; ++i) {
+        triplets.push_back({user_dist(rng) * 3 + 1, item_dist(rng) * 2, item_dist(rng) * 2 + 1});
+    }
+    UserItemStore store(dimensions, StorageLayout::Dense);
+    store.initialize(triplets);
+    SRPHasher hasher(dimensions, bits, seed);
+
+    // === PRUEBA 1: Guardar y abrir ===
+    std::cout << "\n--- Prueba 1: Guardar y abrir ---" << std::endl;
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!save_model(path, store, hasher, ModelHasherSRP, seed)) {
+        std::cerr << "ERROR: save_model falló" << std::endl;
+        return 1;
+    }
+    auto mid = std::chrono::high_resolution_clock::now();
+    MappedModel model;
+    std::string error;
+    if (!model.open(path, &error)) {
+        std::cerr << "ERROR: No se pudo abrir el modelo: " << error << std::endl;
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  - " << model.file_bytes() / 1024 << " KB escritos en "
+              << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " μs, abiertos en "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << " μs" << std::endl;
+    if (model.get_version() != MODEL_FILE_VERSION || model.get_dimensions() != dimensions ||
+        model.row_stride() != store.row_stride() || model.num_users() != store.num_users() ||
+        model.num_items() != store.num_items() || model.get_num_bits() != bits ||
+        model.get_code_words() != hasher.code_words() || model.get_hasher_seed() != seed ||
+        model.get_hasher() != ModelHasherSRP) {
+        std::cerr << "ERROR: Cabecera del modelo incorrecta" << std::endl;
+        return 1;
+    }
+    const void* sections[] = {model.user_ids(), model.item_ids(), model.user_matrix(), model.item_matrix(),
+                              model.projections(), model.item_codes()};
+    for (const void* p : sections) {
+        if (reinterpret_cast<uintptr_t>(p) % 64 != 0) {
+            std::cerr << "ERROR: Sección no alineada a 64 bytes" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Cabecera coherente con el almacén y secciones alineadas a 64 bytes" << std::endl;
+
+    // === PRUEBA 2: Contenido idéntico al almacén ===
+    std::cout << "\n--- Prueba 2: Ids, matrices, normas y códigos ---" << std::endl;
+    const std::vector<int>& user_ids = store.get_user_ids();
+    const std::vector<int>& item_ids = store.get_item_ids();
+    const size_t stride = static_cast<size_t>(store.row_stride());
+    SRPHasher restored = model.make_hasher();
+    if (std::memcmp(model.user_ids(), user_ids.data(), user_ids.size() * sizeof(int)) != 0 ||
+        std::memcmp(model.item_ids(), item_ids.data(), item_ids.size() * sizeof(int)) != 0 ||
+        std::memcmp(model.user_matrix(), store.user_matrix(), user_ids.size() * stride * sizeof(double)) != 0 ||
+        std::memcmp(model.item_matrix(), store.item_matrix(), item_ids.size() * stride * sizeof(double)) != 0) {
+        std::cerr << "ERROR: Ids o matrices distintos a los del almacén" << std::endl;
+        return 1;
+    }
+    for (int row = 0; row < store.num_items(); ++row) {
+        if (model.item_row(item_ids[row]) != row || model.item_norm(row) != store.item_norm(row)) {
+            std::cerr << "ERROR: Fila o norma del ítem " << item_ids[row] << " incorrecta" << std::endl;
+            return 1;
+        }
+        PackedCode expected = hasher.generate_packed_code(
+            Vector(store.item_data(row), store.item_data(row) + dimensions));
+        if (std::memcmp(model.item_code(row), expected.words.data(), hasher.code_words() * sizeof(uint64_t)) != 0) {
+            std::cerr << "ERROR: Código guardado del ítem " << item_ids[row] << " distinto" << std::endl;
+            return 1;
+        }
+    }
+    for (int row = 0; row < store.num_users(); ++row) {
+        if (model.user_row(user_ids[row]) != row || model.user_norm(row) != store.user_norm(row)) {
+            std::cerr << "ERROR: Fila o norma del usuario " << user_ids[row] << " incorrecta" << std::endl;
+            return 1;
+        }
+        // Las proyecciones guardadas dan los mismos bits que el hasher
+        Vector user(store.user_data(row), store.user_data(row) + dimensions);
+        if (restored.generate_packed_code(user) != hasher.generate_packed_code(user)) {
+            std::cerr << "ERROR: make_hasher() no coincide con el SRPHasher para el usuario " << user_ids[row] << std::endl;
+            return 1;
+        }
+    }
+    if (model.user_row(0) != -1 || model.item_row(-5) != -1 || model.item_row(6003) != -1) {
+        std::cerr << "ERROR: Un id ausente debería devolver -1" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ " << model.num_users() << " usuarios y " << model.num_items()
+              << " ítems idénticos; make_hasher() reproduce los bits del SRPHasher" << std::endl;
+
+    // === PRUEBA 3: LSHIndex desde los códigos guardados ===
+    std::cout << "\n--- Prueba 3: LSHIndex::load_codes ---" << std::endl;
+    LSHIndex built(hasher), loaded(hasher);
+    built.build_prefix_cascade({16, 32});
+    loaded.build_prefix_cascade({16, 32});
+    built.build(store);
+    loaded.load_codes(model.item_ids(), model.num_items(), model.item_codes());
+    if (built.get_item_ids() != loaded.get_item_ids() || built.get_codes() != loaded.get_codes()) {
+        std::cerr << "ERROR: load_codes no reproduce el índice construido" << std::endl;
+        return 1;
+    }
+    // El hasher reconstruido desde las proyecciones del archivo rehashea a los mismos códigos
+    LSHIndex rehashed(restored);
+    rehashed.build(store);
+    if (!restored.is_initialized() || rehashed.get_codes() != loaded.get_codes()) {
+        std::cerr << "ERROR: make_hasher() no reproduce los códigos guardados" << std::endl;
+        return 1;
+    }
+    PackedCode query = hasher.generate_packed_code(Vector(store.user_data(0), store.user_data(0) + dimensions));
+    if (built.cascade_search(query, 10, {200, 50}) != loaded.cascade_search(query, 10, {200, 50})) {
+        std::cerr << "ERROR: La cascada de prefijos difiere tras load_codes" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Índice cargado idéntico al construido (códigos y prefijos) y al rehasheado con make_hasher()" << std::endl;
+
+    // === PRUEBA 4: Archivos inválidos ===
+    std::cout << "\n--- Prueba 4: Archivos inválidos ---" << std::endl;
+    model.close();
+    std::vector<char> bytes = read_bytes(path);
+    MappedModel rejected;
+
+    std::vector<char> bad_magic = bytes;
+    bad_magic[0] = 'X';
+    write_bytes(corrupt_path, bad_magic);
+    if (rejected.open(corrupt_path, &error) || rejected.is_open()) {
+        std::cerr << "ERROR: Se aceptó una firma inválida" << std::endl;
+        return 1;
+    }
+    std::cout << "  - Firma: " << error << std::endl;
+
+    std::vector<char> bad_version = bytes;
+    uint32_t version = MODEL_FILE_VERSION + 1;
+    std::memcpy(bad_version.data() + offsetof(ModelFileHeader, version), &version, sizeof(version));
+    write_bytes(corrupt_path, bad_version);
+    if (rejected.open(corrupt_path, &error)) {
+        std::cerr << "ERROR: Se aceptó una versión desconocida" << std::endl;
+        return 1;
+    }
+    std::cout << "  - Versión: " << error << std::endl;
+
+    std::vector<char> bad_hasher = bytes;
+    uint32_t hasher_kind = NumModelHashers;
+    std::memcpy(bad_hasher.data() + offsetof(ModelFileHeader, hasher), &hasher_kind, sizeof(hasher_kind));
+    write_bytes(corrupt_path, bad_hasher);
+    if (rejected.open(corrupt_path, &error)) {
+        std::cerr << "ERROR: Se aceptó un tipo de hasher desconocido" << std::endl;
+        return 1;
+    }
+    std::cout << "  - Hasher: " << error << std::endl;
+
+    std::vector<char> truncated(bytes.begin(), bytes.begin() + bytes.size() / 2);
+    write_bytes(corrupt_path, truncated);
+    if (rejected.open(corrupt_path, &error)) {
+        std::cerr << "ERROR: Se aceptó un archivo truncado" << std::endl;
+        return 1;
+    }
+    std::cout << "  - Truncado: " << error << std::endl;
+
+    if (rejected.open("no_existe.srpr", &error)) {
+        std::cerr << "ERROR: Se abrió un archivo inexistente" << std::endl;
+        return 1;
+    }
+    std::remove(corrupt_path.c_str());
+    std::remove(path.c_str());
+    std::cout << "✓ Firma, versión, hasher, tamaño y archivos inexistentes rechazados" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de ModelFile completadas exitosamente!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "../include/MultiIndexHashing.h"
+#include "../include/LSHIndex.h"
+#include "../include/LSH.h"
+#include "../include/UserItemStore.h"
+#include "../include/Triplet.h"
+#include "TestData.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+int main() {
+    std::cout << "=== Prueba de MultiIndexHashing (búsqueda Hamming exacta) ===" << std::endl;
+
+    const int dimensions = 32;
+    const int num_users = 50;
+    const int num_items = 30000;
+    const int top_k = 10;
+
+    UserItemStore store(dimensions);
+    make_clustered_store(store, num_users, num_items, 300, dimensions, 0.25, 77);
+    store.print_summary();
+
+    for (int bits : {64, 128, 256}) {
+        std::cout << "\n--- Códigos de " << bits << " bits ---" << std::endl;
+
+        SRPHasher hasher(dimensions, bits, 42);
+        LSHIndex index(hasher);
+        index.build(store);
+
+        int substrings = MultiIndexHashing::suggested_substrings(bits, index.size());
+        MultiIndexHashing mih(index, substrings);
+        mih.build();
+        mih.print_info();
+
+        // === PRUEBA 1: k-NN exacto idéntico al ranking lineal ===
+        double linear_us = 0.0, mih_us = 0.0, candidate_sum = 0.0;
+        for (int user_id = 1; user_id <= num_users; ++user_id) {
+            PackedCode query = index.encode(store.get_user_vector(user_id));
+
+            auto linear_start = std::chrono::high_resolution_clock::now();
+            auto expected = index.search(query, top_k);
+            auto linear_end = std::chrono::high_resolution_clock::now();
+            int candidates = 0;
+            auto results = mih.search(query, top_k, MultiIndexHashing::ItemFilter(), &candidates);
+            auto mih_end = std::chrono::high_resolution_clock::now();
+
+            linear_us += std::chrono::duration<double, std::micro>(linear_end - linear_start).count();
+            mih_us += std::chrono::duration<double, std::micro>(mih_end - linear_end).count();
+            candidate_sum += candidates;
+
+            if (results != expected) {
+                std::cerr << "ERROR: k-NN de MIH difiere del ranking lineal para usuario " << user_id << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "✓ k-NN exacto idéntico a LSHIndex::search (" << num_users << " consultas)" << std::endl;
+        std::cout << "  - Lineal: " << std::fixed << std::setprecision(1) << linear_us / num_users
+                  << " μs, MIH: " << mih_us / num_users << " μs, candidatos verificados: "
+                  << candidate_sum / num_users << " de " << index.size() << std::endl;
+
+        // === PRUEBA 2: Búsqueda por radio exacta ===
+        PackedCode query = index.encode(store.get_user_vector(1));
+        std::vector<int> distances;
+        index.compute_distances(query, distances);
+        for (int radius : {0, bits / 16, bits / 8, bits / 4}) {
+            auto in_range = mih.range_search(query, radius);
+            int expected_count = 0;
+            for (int d : distances) {
+                if (d <= radius) ++expected_count;
+            }
+            if (static_cast<int>(in_range.size()) != expected_count) {
+                std::cerr << "ERROR: range_search(r=" << radius << ") devolvió " << in_range.size()
+                          << " ítems, se esperaban " << expected_count << std::endl;
+                return 1;
+            }
+            for (const auto& item_distance : in_range) {
+                if (item_distance.second > radius) {
+                    std::cerr << "ERROR: range_search devolvió un ítem fuera del radio" << std::endl;
+                    return 1;
+                }
+            }
+        }
+        std::cout << "✓ range_search devuelve exactamente los ítems dentro de cada radio" << std::endl;
+
+        // === PRUEBA 3: k-NN con filtro ===
+        auto only_even = [](int item_id) { return item_id % 2 == 0; };
+        auto filtered = mih.search(query, top_k, only_even);
+        std::vector<std::pair<int, int>> expected_filtered;
+        for (const auto& item_distance : index.search(query, index.size())) {
+            if (only_even(item_distance.first)) expected_filtered.push_back(item_distance);
+            if (static_cast<int>(expected_filtered.size()) == top_k) break;
+        }
+        if (filtered != expected_filtered) {
+            std::cerr << "ERROR: k-NN filtrado de MIH difiere del ranking lineal filtrado" << std::endl;
+            return 1;
+        }
+        std::cout << "✓ k-NN con filtro de ítems idéntico al ranking lineal filtrado" << std::endl;
+    }
+
+    // === PRUEBA 4: Parámetros inválidos ===
+    std::cout << "\n--- Parámetros inválidos ---" << std::endl;
+    SRPHasher small_hasher(dimensions, 16, 42);
+    LSHIndex small_index(small_hasher);
+    try {
+        MultiIndexHashing invalid(small_index, 17);
+        std::cerr << "ERROR: m > bits debería lanzar std::invalid_argument" << std::endl;
+        return 1;
+    } catch (const std::invalid_argument&) {
+        std::cout << "✓ m > bits rechazado" << std::endl;
+    }
+
+    std::cout << "\n🎉 ¡Todas las pruebas de MultiIndexHashing completadas exitosamente!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "../include/LSH.h"
+#include "../include/Philox.h"
+#include "../include/PackedCode.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <iomanip>
+
+int main() {
+    std::cout << "=== Prueba de PhiloxSRPHasher (coeficientes regenerables) ===" << std::endl;
+
+    // === PRUEBA 1: Vectores de referencia de Philox4x32-10 ===
+    std::cout << "\n--- Prueba 1: Vectores de referencia de Philox4x32-10 ---" << std::endl;
+
+    const uint32_t zero_counter[4] = {0u, 0u, 0u, 0u};
+    const uint32_t zero_key[2] = {0u, 0u};
+    const uint32_t expected_zero[4] = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+    const uint32_t ones_counter[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    const uint32_t ones_key[2] = {0xffffffffu, 0xffffffffu};
+    const uint32_t expected_ones[4] = {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu};
+
+    uint32_t out[4];
+    Philox4x32::generate(zero_counter, zero_key, out);
+    for (int i = 0; i < 4; ++i) {
+        if (out[i] != expected_zero[i]) {
+            std::cerr << "ERROR: Philox(0, 0) palabra " << i << " incorrecta" << std::endl;
+            return 1;
+        }
+    }
+    Philox4x32::generate(ones_counter, ones_key, out);
+    for (int i = 0; i < 4; ++i) {
+        if (out[i] != expected_ones[i]) {
+            std::cerr << "ERROR: Philox(0xff.., 0xff..) palabra " << i << " incorrecta" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Philox4x32-10 coincide con los vectores de referencia de Random123" << std::endl;
+
+    // === PRUEBA 2: Reconstrucción desde (seed, d, b) ===
+    std::cout << "\n--- Prueba 2: Reconstrucción bit a bit ---" << std::endl;
+
+    const int dimensions = 48;
+    const int bits = 256;
+    PhiloxSRPHasher hasher(dimensions, bits, 1234);
+    hasher.print_hash_info();
+
+    std::mt19937 rng(5);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    const int n = 300;
+    std::vector<double> batch(static_cast<size_t>(n) * dimensions);
+    for (double& x : batch) x = dist(rng);
+
+    std::vector<uint64_t> codes(static_cast<size_t>(n) * hasher.code_words());
+    hasher.hash_batch(batch.data(), n, dimensions, codes.data());
+
+    // Otro "nodo": un hasher nuevo con los mismos parámetros
+    PhiloxSRPHasher rebuilt(dimensions, bits, 1234);
+    PhiloxSRPHasher other_seed(dimensions, bits, 1235);
+    int differing_bits = 0;
+    for (int r = 0; r < n; ++r) {
+        Vector v(batch.begin() + r * dimensions, batch.begin() + (r + 1) * dimensions);
+        PackedCode packed = rebuilt.generate_packed_code(v);
+        if (hamming_distance_words(packed.words.data(), codes.data() + static_cast<size_t>(r) * packed.num_words(),
+                                   packed.num_words()) != 0) {
+            std::cerr << "ERROR: El hasher reconstruido difiere en la fila " << r << std::endl;
+            return 1;
+        }
+        if (r < 20 && packed.to_string() != hasher.generate_code(v)) {
+            std::cerr << "ERROR: generate_code difiere del código empaquetado en la fila " << r << std::endl;
+            return 1;
+        }
+        differing_bits += hamming_distance(packed, other_seed.generate_packed_code(v));
+    }
+    if (differing_bits < n * bits / 4) {
+        std::cerr << "ERROR: Seeds distintas deberían dar códigos independientes" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Mismos códigos con (seed, d, b) iguales; seed distinta -> "
+              << std::fixed << std::setprecision(3) << static_cast<double>(differing_bits) / (n * bits)
+              << " de bits distintos" << std::endl;
+
+    // === PRUEBA 3: Distribución de los coeficientes ===
+    std::cout << "\n--- Prueba 3: Coeficientes ~ N(0, 1) ---" << std::endl;
+
+    double sum = 0.0, sum_sq = 0.0;
+    int count = 0;
+    std::vector<float> row(dimensions);
+    for (int i = 0; i < bits; ++i) {
+        hasher.generate_row(i, row.data());
+        for (int j = 0; j < dimensions; ++j) {
+            if (j % 7 == 0 && row[j] != hasher.coefficient(i, j)) {
+                std::cerr << "ERROR: coefficient(" << i << ", " << j << ") difiere de generate_row" << std::endl;
+                return 1;
+            }
+            sum += row[j];
+            sum_sq += row[j] * row[j];
+            ++count;
+        }
+    }
+    double mean = sum / count;
+    double variance = sum_sq / count - mean * mean;
+    std::cout << "  media = " << mean << ", varianza = " << variance << " (" << count << " coeficientes)" << std::endl;
+    if (std::fabs(mean) > 0.03 || std::fabs(variance - 1.0) > 0.05) {
+        std::cerr << "ERROR: Los coeficientes no parecen normales estándar" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Media ≈ 0 y varianza ≈ 1" << std::endl;
+
+    // === PRUEBA 4: Rendimiento vs SRP denso almacenado ===
+    std::cout << "\n--- Prueba 4: Throughput vs SRP con matriz almacenada ---" << std::endl;
+
+    const int items = 20000;
+    std::vector<double> catalog(static_cast<size_t>(items) * dimensions);
+    for (double& x : catalog) x = dist(rng);
+    for (int length : {64, 256, 1024}) {
+        SRPHasher dense(dimensions, length, 7);
+        PhiloxSRPHasher philox(dimensions, length, 7);
+        std::vector<uint64_t> catalog_codes(static_cast<size_t>(items) * code_words_for_bits(length));
+
+        auto dense_start = std::chrono::high_resolution_clock::now();
+        dense.hash_batch(catalog.data(), items, dimensions, catalog_codes.data());
+        auto dense_end = std::chrono::high_resolution_clock::now();
+        philox.hash_batch(catalog.data(), items, dimensions, catalog_codes.data());
+        auto philox_end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "  - " << length << " bits: denso "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(dense_end - dense_start).count()
+                  << " ms (" << static_cast<size_t>(length) * dimensions * sizeof(double) / 1024 << " KB de parámetros), Philox "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(philox_end - dense_end).count()
+                  << " ms (0 KB)" << std::endl;
+    }
+
+    std::cout << "\n🎉 ¡Todas las pruebas de PhiloxSRPHasher completadas exitosamente!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include "../include/SimdKernels.h"
+#include "../include/CpuFeatures.h"
+#include "../include/FixedCode.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+int main() {
+    std::cout << "=== Prueba de SimdKernels (despacho por CPUID) ===" << std::endl;
+
+    // === PRUEBA 1: Detección ===
+    std::cout << "\n--- Prueba 1: Detección de la CPU ---" << std::endl;
+    const CpuFeatures& cpu = CpuFeatures::get();
+    SimdLevel best = SimdKernels::best_supported_level();
+    std::cout << "  - Extensiones: " << cpu.describe() << std::endl;
+    std::cout << "  - Mejor nivel soportado: " << simd_level_name(best) << std::endl;
+    std::cout << "  - Kernels activos: " << SimdKernels::active().description() << std::endl;
+    if (SimdKernels::active().level() > best) {
+        std::cerr << "ERROR: El nivel activo supera al soportado por la CPU" << std::endl;
+        return 1;
+    }
+    if (SimdKernels::for_level(SimdLevel::AVX512).level() != best) {
+        std::cerr << "ERROR: for_level debe limitarse al nivel soportado" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Nivel elegido dentro de lo que soporta la CPU" << std::endl;
+
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (level <= best) levels.push_back(level);
+    }
+
+    // === PRUEBA 2: Escaneo Hamming idéntico en todos los niveles ===
+    std::cout << "\n--- Prueba 2: Escaneo Hamming (secuencial y disperso) por nivel ---" << std::endl;
+    std::mt19937_64 rng(5);
+    const int n = 100003;  // No múltiplo del ancho de registro: ejercita las colas
+    for (int words : {1, 2, 3, 4, 5, 8, 9, 16}) {
+        std::vector<uint64_t> codes(static_cast<size_t>(n) * words);
+        for (uint64_t& w : codes) w = rng();
+        std::vector<uint64_t> query(codes.begin() + words, codes.begin() + 2 * words);
+
+        std::vector<int> expected(n);
+        hamming_scan_generic(query.data(), codes.data(), n, words, expected.data());
+
+        std::cout << "  - " << std::setw(3) << words * 64 << " bits:";
+        for (SimdLevel level : levels) {
+            SimdKernels kernels = SimdKernels::for_level(level);
+            std::vector<int> distances(n, -1);
+            auto start = std::chrono::high_resolution_clock::now();
+            kernels.hamming_scan(words)(query.data(), codes.data(), n, words, distances.data());
+            auto end = std::chrono::high_resolution_clock::now();
+            if (distances != expected) {
+                std::cerr << "\nERROR: Escaneo Hamming " << simd_level_name(level) << " difiere con "
+                          << words << " palabras" << std::endl;
+                return 1;
+            }
+
+            // Acceso disperso: mismas distancias para un subconjunto de filas
+            std::vector<int> rows;
+            for (int row = n - 1; row >= 0; row -= 7) rows.push_back(row);
+            std::vector<int> gathered(rows.size(), -1);
+            kernels.hamming_gather(words)(query.data(), codes.data(), words, rows.data(),
+                                          static_cast<int>(rows.size()), gathered.data());
+            for (size_t i = 0; i < rows.size(); ++i) {
+                if (gathered[i] != expected[rows[i]]) {
+                    std::cerr << "\nERROR: Distancias dispersas " << simd_level_name(level) << " difieren con "
+                              << words << " palabras" << std::endl;
+                    return 1;
+                }
+            }
+            std::cout << " " << simd_level_name(level) << " "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " μs";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "✓ Distancias idénticas al kernel genérico en todos los niveles soportados" << std::endl;
+
+    // === PRUEBA 3: Producto punto ===
+    std::cout << "\n--- Prueba 3: Producto punto por nivel ---" << std::endl;
+    std::normal_distribution<double> dist(0.0, 1.0);
+    std::vector<double> a(300), b(300);
+    for (double& x : a) x = dist(rng);
+    for (double& x : b) x = dist(rng);
+    SimdKernels scalar = SimdKernels::for_level(SimdLevel::Scalar);
+    for (SimdLevel level : levels) {
+        SimdKernels kernels = SimdKernels::for_level(level);
+        for (int len = 0; len <= 300; ++len) {
+            double expected = scalar.dot(a.data(), b.data(), len);
+            double result = kernels.dot(a.data(), b.data(), len);
+            double magnitude = std::sqrt(scalar.dot(a.data(), a.data(), len) * scalar.dot(b.data(), b.data(), len));
+            if (std::fabs(result - expected) > 1e-12 * (1.0 + magnitude)) {
+                std::cerr << "ERROR: Producto punto " << simd_level_name(level) << " difiere con n=" << len << std::endl;
+                return 1;
+            }
+        }
+
+        const int dims = 64, rows = 200000;
+        std::vector<double> matrix(static_cast<size_t>(dims) * rows);
+        for (double& x : matrix) x = dist(rng);
+        double sink = 0.0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < rows; ++r) {
+            sink += kernels.dot(a.data(), matrix.data() + static_cast<size_t>(r) * dims, dims);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  - " << std::setw(6) << simd_level_name(level) << ": " << rows << " productos de "
+                  << dims << "D en " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+                  << " μs (checksum " << std::fixed << std::setprecision(3) << sink << ")" << std::endl;
+    }
+    std::cout << "✓ Producto punto igual al escalar (salvo redondeo) para n = 0..300" << std::endl;
+
+    // === PRUEBA 4: Producto punto float y bfloat16 ===
+    std::cout << "\n--- Prueba 4: Producto punto float / bf16 (acumulación en float) ---" << std::endl;
+    std::vector<float> af(300), bf(300);
+    std::vector<bfloat16> bh(300);
+    for (int i = 0; i < 300; ++i) {
+        af[i] = static_cast<float>(a[i]);
+        bf[i] = static_cast<float>(b[i]);
+        bh[i] = bfloat16::from_float(bf[i]);
+    }
+    for (SimdLevel level : levels) {
+        SimdKernels kernels = SimdKernels::for_level(level);
+        for (int len = 0; len <= 300; ++len) {
+            double exact = scalar.dot(a.data(), b.data(), len);
+            double exact_bf16 = 0.0, magnitude = 0.0;
+            for (int i = 0; i < len; ++i) {
+                exact_bf16 += static_cast<double>(af[i]) * bh[i].to_float();
+                magnitude += std::fabs(a[i] * b[i]);
+            }
+            // Acumular en float (en otro orden que el escalar) cuesta ~1e-6 relativo a la magnitud
+            if (std::fabs(kernels.dot(af.data(), bf.data(), len) - exact) > 1e-5 * (1.0 + magnitude) ||
+                std::fabs(kernels.dot(bh.data(), af.data(), len) - exact_bf16) > 1e-5 * (1.0 + magnitude)) {
+                std::cerr << "ERROR: Producto punto float/bf16 " << simd_level_name(level) << " difiere con n="
+                          << len << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "✓ Productos float y bf16 iguales al cálculo en double (tolerancia de acumulación en float)" << std::endl;
+
+    // === PRUEBA 5: Producto punto int8 ===
+    std::cout << "\n--- Prueba 5: Producto punto int8 (exacto en enteros) ---" << std::endl;
+    std::vector<int8_t> qa(300), qb(300);
+    for (int i = 0; i < 300; ++i) {
+        qa[i] = static_cast<int8_t>(static_cast<int>(rng() % 255) - 127);
+        qb[i] = static_cast<int8_t>(static_cast<int>(rng() % 255) - 127);
+    }
+    // Extremos: pares de 127·127 y de -127·-127 que saturarían PMADDUBSW con -128
+    for (int i = 0; i < 40; ++i) {
+        qa[i] = (i & 1) ? 127 : -127;
+        qb[i] = qa[i];
+    }
+    for (SimdLevel level : levels) {
+        SimdKernels kernels = SimdKernels::for_level(level);
+        for (int start = 0; start < 3; ++start) {
+            for (int len = 0; start + len <= 300; ++len) {
+                int32_t expected = 0;
+                for (int i = start; i < start + len; ++i) expected += static_cast<int32_t>(qa[i]) * qb[i];
+                if (kernels.dot(qa.data() + start, qb.data() + start, len) != expected) {
+                    std::cerr << "ERROR: Producto int8 " << simd_level_name(level) << " difiere con n=" << len
+                              << " (desplazamiento " << start << ")" << std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        const int dims = 64, rows = 200000;
+        std::vector<int8_t> matrix(static_cast<size_t>(dims) * rows);
+        for (int8_t& x : matrix) x = static_cast<int8_t>(static_cast<int>(rng() % 255) - 127);
+        long long sink = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < rows; ++r) {
+            sink += kernels.dot(matrix.data() + static_cast<size_t>(r) * dims, qa.data(), dims);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "  - " << std::setw(6) << simd_level_name(level) << ": " << rows << " productos int8 de "
+                  << dims << "D en " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+                  << " μs (checksum " << sink << ")" << std::endl;
+    }
+    std::cout << "✓ Productos int8 idénticos al cálculo escalar en todos los niveles" << std::endl;
+
+    // === PRUEBA 6: Suma vertical bit-sliced ===
+    std::cout << "\n--- Prueba 6: Suma vertical y comparación bit-sliced (256 ítems) por nivel ---" << std::endl;
+    for (int bits : {8, 64, 100, 512}) {
+        int counter_bits = 1;
+        while ((1 << counter_bits) <= bits) ++counter_bits;
+        std::vector<uint64_t> planes(static_cast<size_t>(bits) * 4), query_masks(bits);
+        for (uint64_t& w : planes) w = rng();
+        for (uint64_t& m : query_masks) m = (rng() & 1) ? ~0ULL : 0ULL;
+
+        // Distancia de cada ítem: planos en los que su bit difiere del de la consulta
+        std::vector<int> expected(256, 0);
+        for (int j = 0; j < bits; ++j) {
+            for (int slot = 0; slot < 256; ++slot) {
+                expected[slot] += static_cast<int>(((planes[4 * j + slot / 64] ^ query_masks[j]) >> (slot % 64)) & 1ULL);
+            }
+        }
+
+        for (SimdLevel level : levels) {
+            SimdKernels kernels = SimdKernels::for_level(level);
+            std::vector<uint64_t> counters(static_cast<size_t>(counter_bits) * 4, 0ULL);
+            for (int j = 0; j < bits; j += 16) {
+                kernels.bit_sliced_accumulate(counters.data(), counter_bits, planes.data() + 4 * j,
+                                              query_masks.data() + j, std::min(16, bits - j));
+            }
+            for (int slot = 0; slot < 256; ++slot) {
+                int value = 0;
+                for (int c = 0; c < counter_bits; ++c) {
+                    value |= static_cast<int>((counters[4 * c + slot / 64] >> (slot % 64)) & 1ULL) << c;
+                }
+                if (value != expected[slot]) {
+                    std::cerr << "ERROR: Suma vertical " << simd_level_name(level) << " difiere con " << bits
+                              << " bits en el ítem " << slot << std::endl;
+                    return 1;
+                }
+            }
+            for (int threshold : {0, bits / 4, bits / 2, bits}) {
+                uint64_t mask[4];
+                kernels.bit_sliced_at_most(counters.data(), counter_bits, threshold, mask);
+                for (int slot = 0; slot < 256; ++slot) {
+                    if ((((mask[slot / 64] >> (slot % 64)) & 1ULL) != 0) != (expected[slot] <= threshold)) {
+                        std::cerr << "ERROR: Comparación bit-sliced " << simd_level_name(level) << " difiere con umbral "
+                                  << threshold << std::endl;
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+    std::cout << "✓ Contadores y máscaras de umbral idénticos al conteo directo en todos los niveles" << std::endl;
+
+    std::cout << "\n🎉 ¡Todas las pruebas de SimdKernels completadas exitosamente!" << std::endl;
+    return 0;
+}
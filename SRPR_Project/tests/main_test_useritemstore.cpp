@@ -1,10 +1,14 @@
 #include "../include/UserItemStore.h"
 #include "../include/Triplet.h"
+#include "../include/SRPR_Trainer.h"
+#include "../include/LSHIndex.h"
 #include <iostream>
 #include <vector>
 #include <set>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
+#include <stdexcept>
 
 // Función de utilidad para calcular la norma de un vector
 double vector_norm(const Vector& v) {
@@ -281,6 +285,168 @@ int main() {
     std::cout << "    - " << access_count << " accesos en " << access_duration.count() << " μs" << std::endl;
     std::cout << "    - " << (access_count * 1000000.0 / access_duration.count()) << " accesos/segundo" << std::endl;
     
+    // === PRUEBA 10: Disposición densa (matrices contiguas + índice id -> fila) ===
+    std::cout << "\n--- Prueba 10: Disposición densa ---" << std::endl;
+    
+    // Ids dispersos (el índice usa búsqueda binaria) y compactos (tabla directa)
+    std::vector<Triplet> dense_triplets;
+    for (int u = 0; u < 200; ++u) {
+        int user_id = (u % 2 == 0) ? u : 1000000 + u * 977;
+        for (int t = 0; t < 5; ++t) {
+            dense_triplets.push_back({user_id, (u * 7 + t * 13) % 300 + 1, (u * 11 + t * 29) % 300 + 1});
+        }
+    }
+    const int dense_dimensions = 13; // No múltiplo de 8: filas con relleno
+    UserItemStore map_store(dense_dimensions);
+    UserItemStore dense_store(dense_dimensions, StorageLayout::Dense);
+    map_store.initialize(dense_triplets);
+    dense_store.initialize(dense_triplets);
+    dense_store.print_summary();
+    
+    if (dense_store.row_stride() != 16 || reinterpret_cast<uintptr_t>(dense_store.item_matrix()) % 64 != 0 ||
+        reinterpret_cast<uintptr_t>(dense_store.user_matrix()) % 64 != 0 || map_store.item_matrix() != nullptr) {
+        std::cerr << "ERROR: Matrices densas no alineadas o stride incorrecto" << std::endl;
+        return 1;
+    }
+    if (dense_store.get_user_ids() != map_store.get_user_ids() || dense_store.get_item_ids() != map_store.get_item_ids()) {
+        std::cerr << "ERROR: Las dos disposiciones deberían asignar las mismas filas" << std::endl;
+        return 1;
+    }
+    for (int row = 0; row < dense_store.num_users(); ++row) {
+        int user_id = dense_store.get_user_ids()[row];
+        if (dense_store.user_row(user_id) != row || dense_store.user_data(row) != dense_store.user_matrix() + row * 16 ||
+            dense_store.user_data(row)[dense_dimensions] != 0.0) {
+            std::cerr << "ERROR: Índice id -> fila o relleno incorrecto para el usuario " << user_id << std::endl;
+            return 1;
+        }
+    }
+    for (int row = 0; row < dense_store.num_items(); ++row) {
+        if (dense_store.item_row(dense_store.get_item_ids()[row]) != row) {
+            std::cerr << "ERROR: Índice id -> fila incorrecto para el ítem en la fila " << row << std::endl;
+            return 1;
+        }
+    }
+    if (dense_store.user_row(1) != -1 || dense_store.item_row(99999) != -1 || dense_store.item_row(-5) != -1) {
+        std::cerr << "ERROR: Ids inexistentes deberían dar fila -1" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Filas de " << dense_store.row_stride() << " doubles alineadas a 64 bytes, índice id -> fila correcto"
+              << " (" << dense_store.memory_bytes() << " bytes)" << std::endl;
+    
+    bool vector_api_rejected = false;
+    try {
+        dense_store.get_user_vector(dense_store.get_user_ids()[0]);
+    } catch (const std::logic_error&) {
+        vector_api_rejected = true;
+    }
+    bool copy_rejected = false;
+    try {
+        dense_store.copy_item_vector(99999);
+    } catch (const std::out_of_range&) {
+        copy_rejected = true;
+    }
+    if (!vector_api_rejected || !copy_rejected) {
+        std::cerr << "ERROR: El acceso por Vector debería lanzar logic_error en modo denso y la copia out_of_range" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ get_user_vector rechazado en modo denso; copy_item_vector de id inexistente rechazado" << std::endl;
+    
+    // Mismos valores iniciales en ambas disposiciones y mismo resultado de entrenamiento
+    for (int row = 0; row < map_store.num_items(); ++row) {
+        std::copy(map_store.item_data(row), map_store.item_data(row) + dense_dimensions, dense_store.item_data(row));
+    }
+    for (int row = 0; row < map_store.num_users(); ++row) {
+        std::copy(map_store.user_data(row), map_store.user_data(row) + dense_dimensions, dense_store.user_data(row));
+    }
+    SRPR_Trainer::TrainingParams dense_params;
+    dense_params.epochs = 3;
+    dense_params.verbose = false;
+    SRPR_Trainer map_trainer(map_store);
+    SRPR_Trainer dense_trainer(dense_store);
+    map_trainer.train(dense_triplets, dense_params);
+    dense_trainer.train(dense_triplets, dense_params);
+    for (int row = 0; row < map_store.num_items(); ++row) {
+        int item_id = map_store.get_item_ids()[row];
+        if (map_store.copy_item_vector(item_id) != dense_store.copy_item_vector(item_id)) {
+            std::cerr << "ERROR: El entrenamiento difiere entre disposiciones en el ítem " << item_id << std::endl;
+            return 1;
+        }
+    }
+    
+    SRPHasher dense_hasher(dense_dimensions, 32, 42);
+    LSHIndex map_index(dense_hasher), dense_index(dense_hasher);
+    map_index.build(map_store);
+    dense_index.build(dense_store);
+    for (int row = 0; row < map_index.size(); ++row) {
+        if (map_index.item_id_at(row) != dense_index.item_id_at(row) ||
+            !std::equal(map_index.code_at(row), map_index.code_at(row) + map_index.get_code_words(), dense_index.code_at(row))) {
+            std::cerr << "ERROR: Los códigos del índice difieren entre disposiciones en la fila " << row << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "✓ Entrenamiento e índice LSH idénticos con unordered_map y con matrices densas" << std::endl;
+    
+    // Una segunda inicialización añade filas conservando los vectores existentes
+    const int kept_item = dense_store.get_item_ids()[0];
+    Vector kept_vector = dense_store.copy_item_vector(kept_item);
+    dense_store.initialize({{5000, 4000, 4001}});
+    if (dense_store.num_items() != map_store.num_items() + 2 || dense_store.copy_item_vector(kept_item) != kept_vector ||
+        dense_store.item_row(4001) != dense_store.num_items() - 1 || dense_store.user_row(5000) < 0) {
+        std::cerr << "ERROR: La reinicialización densa debería añadir filas sin perder las existentes" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Reinicialización incremental conserva las filas existentes" << std::endl;
+    
+    // === PRUEBA 11: Normas cacheadas e ítems normalizados ===
+    std::cout << "\n--- Prueba 11: Normas cacheadas e ítems normalizados ---" << std::endl;
+    
+    // Tras el entrenamiento (que marca cada vector modificado) las normas siguen al día
+    auto norms_match = [&](const UserItemStore& s) {
+        for (int row = 0; row < s.num_users(); ++row) {
+            if (std::fabs(s.user_norm(row) - vector_norm(Vector(s.user_data(row), s.user_data(row) + s.get_dimensions()))) > 1e-12) return false;
+        }
+        for (int row = 0; row < s.num_items(); ++row) {
+            if (std::fabs(s.item_norm(row) - vector_norm(Vector(s.item_data(row), s.item_data(row) + s.get_dimensions()))) > 1e-12) return false;
+        }
+        return true;
+    };
+    if (!norms_match(map_store) || !norms_match(dense_store)) {
+        std::cerr << "ERROR: Normas cacheadas desactualizadas tras entrenar" << std::endl;
+        return 1;
+    }
+    
+    dense_store.build_normalized_items();
+    const int scaled_row = dense_store.item_row(kept_item);
+    double* scaled = dense_store.item_data(scaled_row);
+    for (int i = 0; i < dense_dimensions; ++i) scaled[i] *= 3.0;
+    dense_store.mark_item_dirty(kept_item);
+    const int zero_row = dense_store.item_row(4000);
+    std::fill(dense_store.item_data(zero_row), dense_store.item_data(zero_row) + dense_dimensions, 0.0);
+    dense_store.mark_item_dirty(4000);
+    
+    if (!norms_match(dense_store) || std::fabs(dense_store.item_norm(scaled_row) - 3.0 * vector_norm(kept_vector)) > 1e-12 ||
+        dense_store.item_norm(zero_row) != 0.0) {
+        std::cerr << "ERROR: mark_item_dirty no actualizó la norma cacheada" << std::endl;
+        return 1;
+    }
+    for (int row = 0; row < dense_store.num_items(); ++row) {
+        const double* unit = dense_store.normalized_item_data(row);
+        Vector normalized(unit, unit + dense_dimensions);
+        Vector original = dense_store.copy_item_vector(dense_store.get_item_ids()[row]);
+        double expected_norm = (row == zero_row) ? 0.0 : 1.0;
+        if (std::fabs(vector_norm(normalized) - expected_norm) > 1e-12 ||
+            (row != zero_row && std::fabs(dot_product(normalized, original) - dense_store.item_norm(row)) > 1e-9)) {
+            std::cerr << "ERROR: Fila normalizada incorrecta en la fila " << row << std::endl;
+            return 1;
+        }
+    }
+    dense_store.release_normalized_items();
+    if (dense_store.has_normalized_items()) {
+        std::cerr << "ERROR: release_normalized_items no liberó la matriz" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ Normas al día tras entrenar y marcar; filas normalizadas de norma 1 (0 para el vector nulo)" << std::endl;
+    
     // === RESUMEN FINAL ===
     auto end_time = std::chrono::high_resolution_clock::now();
     auto total_duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -298,6 +464,8 @@ int main() {
     std::cout << "   ✓ Inicialización estadística correcta" << std::endl;
     std::cout << "   ✓ Rendimiento de acceso eficiente" << std::endl;
     std::cout << "   ✓ Compatibilidad con datos reales de MovieLens" << std::endl;
+    std::cout << "   ✓ Disposición densa con índice id -> fila" << std::endl;
+    std::cout << "   ✓ Normas cacheadas e ítems normalizados" << std::endl;
     
     std::cout << "\n🚀 UserItemStore está listo para ser usado en el entrenamiento SRPR!" << std::endl;
     
@@ -8,6 +8,7 @@
 #include <chrono>
 #include <algorithm>
 #include <random>
+#include <cmath>
 
 int main() {
     std::cout << "=== BENCHMARK EXHAUSTIVO vs LSH (Paper Le et al.) ===" << std::endl;
@@ -80,6 +81,7 @@ int main() {
     config.measure_similarity_correlation = true;
     config.generate_charts = true;
     config.use_paper_metrics = true;
+    config.candidate_sizes = {20, 50, 100, 200, 500};  // Curva del pipeline de dos etapas
     benchmark.set_config(config);
     
     std::cout << "✓ Benchmark configurado según métricas del paper Le et al." << std::endl;
@@ -95,15 +97,136 @@ int main() {
         std::chrono::microseconds exhaustive_time;
         auto exhaustive_results = benchmark.exhaustive_search(sample_user, TOP_K, exhaustive_time);
         
+        // Búsqueda exhaustiva paralela: debe coincidir exactamente con la secuencial
+        std::chrono::microseconds parallel_time;
+        auto parallel_results = benchmark.exhaustive_search_parallel(sample_user, TOP_K, parallel_time, 4);
+        if (parallel_results.size() != exhaustive_results.size()) {
+            std::cerr << "ERROR: La búsqueda paralela devolvió " << parallel_results.size() << " resultados" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < parallel_results.size(); ++i) {
+            if (parallel_results[i].item_id != exhaustive_results[i].item_id) {
+                std::cerr << "ERROR: Búsqueda paralela difiere de la secuencial en el rank " << (i + 1) << std::endl;
+                return 1;
+            }
+        }
+        
+        // Normas cacheadas y matriz normalizada: mismo ranking y mismo coseno que el
+        // cálculo completo (tres productos punto por ítem)
+        store.build_normalized_items();
+        std::chrono::microseconds normalized_time;
+        auto normalized_results = benchmark.exhaustive_search(sample_user, TOP_K, normalized_time);
+        if (normalized_results.size() != exhaustive_results.size()) {
+            std::cerr << "ERROR: La búsqueda con ítems normalizados devolvió " << normalized_results.size() << " resultados" << std::endl;
+            return 1;
+        }
+        Vector sample_vector = store.copy_user_vector(sample_user);
+        for (size_t i = 0; i < normalized_results.size(); ++i) {
+            double expected = benchmark.cosine_similarity(sample_vector, store.copy_item_vector(exhaustive_results[i].item_id));
+            if (normalized_results[i].item_id != exhaustive_results[i].item_id ||
+                std::abs(normalized_results[i].score - expected) > 1e-12 ||
+                std::abs(exhaustive_results[i].score - expected) > 1e-12) {
+                std::cerr << "ERROR: Coseno con normas cacheadas difiere del cálculo completo en el rank " << (i + 1) << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "✓ Exhaustiva con normas cacheadas / ítems normalizados: " << exhaustive_time.count()
+                  << " / " << normalized_time.count() << " μs, mismo ranking" << std::endl;
+        
+        // Escaneo sobre copias float / bf16 / int8 del catálogo: el ranking puede cambiar sólo
+        // entre ítems casi empatados, así que se exige recall alto y scores cercanos al double
+        // (exactos con int8: los candidatos se re-evalúan con el coseno exacto)
+        for (Precision precision : {Precision::Float, Precision::BFloat16, Precision::Int8}) {
+            benchmark.set_scan_precision(precision);
+            std::chrono::microseconds reduced_time;
+            auto reduced_results = benchmark.exhaustive_search(sample_user, TOP_K, reduced_time);
+            auto reduced_parallel = benchmark.exhaustive_search_parallel(sample_user, TOP_K, reduced_time, 4);
+            std::set<int> expected_ids;
+            for (const auto& result : exhaustive_results) expected_ids.insert(result.item_id);
+            int hits = 0;
+            double tolerance = precision == Precision::Float ? 1e-5 : (precision == Precision::Int8 ? 1e-12 : 2e-2);
+            for (size_t i = 0; i < reduced_results.size(); ++i) {
+                hits += static_cast<int>(expected_ids.count(reduced_results[i].item_id));
+                double expected = benchmark.cosine_similarity(sample_vector, store.copy_item_vector(reduced_results[i].item_id));
+                if (std::abs(reduced_results[i].score - expected) > tolerance ||
+                    reduced_parallel[i].item_id != reduced_results[i].item_id) {
+                    std::cerr << "ERROR: Escaneo en " << precision_name(precision) << " con score fuera de tolerancia "
+                              << "o distinto del paralelo en el rank " << (i + 1) << std::endl;
+                    return 1;
+                }
+            }
+            double recall = exhaustive_results.empty() ? 1.0 : static_cast<double>(hits) / exhaustive_results.size();
+            if (reduced_results.size() != exhaustive_results.size() || recall < 0.8) {
+                std::cerr << "ERROR: Recall del escaneo en " << precision_name(precision) << " demasiado bajo: "
+                          << recall << std::endl;
+                return 1;
+            }
+            std::cout << "✓ Exhaustiva en " << precision_name(precision) << ": " << reduced_time.count()
+                      << " μs (paralela), recall@" << TOP_K << " = " << recall << ", catálogo de "
+                      << benchmark.scan_memory_bytes() / 1024 << " KB" << std::endl;
+        }
+        benchmark.set_scan_precision(Precision::Double);
+        
         // Búsqueda LSH
         std::chrono::microseconds lsh_time;
         auto lsh_results = benchmark.lsh_search(sample_user, TOP_K, lsh_time);
-        
+
+        // Con el almacén bit-sliced el ranking LSH debe ser el mismo
+        benchmark.build_bit_sliced_index();
+        std::chrono::microseconds sliced_time;
+        auto sliced_results = benchmark.lsh_search(sample_user, TOP_K, sliced_time);
+        if (sliced_results.size() != lsh_results.size()) {
+            std::cerr << "ERROR: La búsqueda bit-sliced devolvió " << sliced_results.size() << " resultados" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < sliced_results.size(); ++i) {
+            if (sliced_results[i].item_id != lsh_results[i].item_id ||
+                sliced_results[i].hamming_distance != lsh_results[i].hamming_distance) {
+                std::cerr << "ERROR: Búsqueda bit-sliced difiere de la empaquetada en el rank " << (i + 1) << std::endl;
+                return 1;
+            }
+        }
+
+        // Cascada de prefijos sin presupuesto: mismo ranking que el escaneo completo
+        benchmark.build_prefix_cascade({8}, {});
+        std::chrono::microseconds cascade_time;
+        auto cascade_results = benchmark.lsh_search(sample_user, TOP_K, cascade_time);
+        benchmark.build_prefix_cascade({}, {});
+        if (cascade_results.size() != lsh_results.size()) {
+            std::cerr << "ERROR: La búsqueda en cascada devolvió " << cascade_results.size() << " resultados" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < cascade_results.size(); ++i) {
+            if (cascade_results[i].item_id != lsh_results[i].item_id ||
+                cascade_results[i].hamming_distance != lsh_results[i].hamming_distance) {
+                std::cerr << "ERROR: Búsqueda en cascada difiere del escaneo completo en el rank " << (i + 1) << std::endl;
+                return 1;
+            }
+        }
+
+        // Re-ranking exacto con C = todo el catálogo: debe reproducir el exhaustivo
+        std::chrono::microseconds rerank_time;
+        auto rerank_results = benchmark.rerank_search(sample_user, TOP_K, benchmark.get_index().size(), rerank_time);
+        if (rerank_results.size() != exhaustive_results.size()) {
+            std::cerr << "ERROR: El re-ranking devolvió " << rerank_results.size() << " resultados" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < rerank_results.size(); ++i) {
+            if (rerank_results[i].item_id != exhaustive_results[i].item_id) {
+                std::cerr << "ERROR: Re-ranking con C = n difiere del exhaustivo en el rank " << (i + 1) << std::endl;
+                return 1;
+            }
+        }
+
         std::cout << "\nResultados individuales:" << std::endl;
         std::cout << "  Exhaustivo: " << exhaustive_results.size() << " recomendaciones en " 
                   << exhaustive_time.count() / 1000.0 << " ms" << std::endl;
+        std::cout << "  Paralelo:   " << parallel_results.size() << " recomendaciones en " 
+                  << parallel_time.count() / 1000.0 << " ms (4 hilos, idénticas al exhaustivo)" << std::endl;
         std::cout << "  LSH:        " << lsh_results.size() << " recomendaciones en " 
                   << lsh_time.count() / 1000.0 << " ms" << std::endl;
+        std::cout << "  Re-ranking: " << rerank_results.size() << " recomendaciones en "
+                  << rerank_time.count() / 1000.0 << " ms (C = catálogo, idénticas al exhaustivo)" << std::endl;
         std::cout << "  Speedup:    " << (double)exhaustive_time.count() / lsh_time.count() << "x" << std::endl;
         
         // Mostrar top-5 de cada método
@@ -152,6 +275,10 @@ int main() {
     std::vector<int> lsh_configs = {8, 16, 32}; // Diferentes configuraciones
     benchmark.lsh_configuration_analysis(lsh_configs, test_users, TOP_K);
     
+    // MIPS: SRP coseno vs Simple-ALSH contra el top-k por producto interno
+    std::cout << "\n6.3 Análisis MIPS (Simple-ALSH):" << std::endl;
+    benchmark.mips_analysis({16, 32, 64}, test_users, TOP_K);
+    
     // === PASO 7: MÉTRICAS CLAVE DEL PAPER ===
     std::cout << "\n--- Paso 7: Métricas clave del paper ---" << std::endl;
     